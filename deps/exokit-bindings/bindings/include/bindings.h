@@ -13,6 +13,8 @@
 #include <webgl.h>
 #include <AudioContext.h>
 #include <Video.h>
+#include <trace.h>
+#include <external-memory.h>
 #if _WIN32
 #include <leapmotion.h>
 #endif
@@ -31,5 +33,7 @@ Local<Object> makeCanvasGradient();
 Local<Object> makeCanvasPattern();
 Local<Object> makeAudio();
 Local<Object> makeVideo(Local<Value> imageDataCons);
+Local<Object> makeTrace();
+Local<Object> makeMemory();
 
 #endif
@@ -128,3 +128,19 @@ Local<Object> makeVideo(Local<Value> imageDataCons) {
 
   return scope.Escape(exports);
 }
+
+Local<Object> makeTrace() {
+  Isolate *isolate = Isolate::GetCurrent();
+
+  Nan::EscapableHandleScope scope;
+
+  return scope.Escape(trace::Initialize(isolate));
+}
+
+Local<Object> makeMemory() {
+  Isolate *isolate = Isolate::GetCurrent();
+
+  Nan::EscapableHandleScope scope;
+
+  return scope.Escape(externalmemory::Initialize(isolate));
+}
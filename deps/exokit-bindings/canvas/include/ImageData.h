@@ -46,7 +46,13 @@ namespace canvas {
     std::unique_ptr<ImageData> crop(int x, int y, unsigned short w, unsigned short h, bool flipY = false) const;
     std::unique_ptr<ImageData> scale(unsigned short target_width, unsigned short target_height) const;
     std::unique_ptr<ImageData> colorize(const Color & color) const;
+    // writes width * height RGBA pixels to target
+    void colorize(const Color & color, unsigned char * target) const;
     std::unique_ptr<ImageData> blur(float hradius, float vradius) const;
+    void blurInPlace(float hradius, float vradius);
+    // the same kernels on caller-owned buffers, without the unsigned short size limit
+    static void blurPixels(unsigned char * data, size_t width, size_t height, size_t num_channels, float hradius, float vradius);
+    static void colorizePixels(const unsigned char * alpha, unsigned char * target, size_t count, const Color & color);
 
     bool isValid() const { return width != 0 && height != 0 && num_channels != 0; }
     unsigned short getWidth() const { return width; }
@@ -60,8 +66,12 @@ namespace canvas {
 
     static bool getFlip() { return ImageData::flip; }
     static void setFlip(bool newFlip) { ImageData::flip = newFlip; }
+    // whether blur and colorize use the SSE2/NEON kernels; the scalar path is the reference
+    static bool getSimd() { return ImageData::simd; }
+    static void setSimd(bool newSimd) { ImageData::simd = newSimd; }
   private:
     static bool flip;
+    static bool simd;
 
     unsigned short width, height, num_channels;
     std::unique_ptr<unsigned char[]> data;
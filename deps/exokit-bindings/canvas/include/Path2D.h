@@ -65,10 +65,12 @@ namespace canvas {
 	min_x = max_x = it->x0;
 	min_y = max_y = it->y0;
 	for (auto & pc : data) {
-	  if (pc.x0 < min_x) min_x = pc.x0;
-	  if (pc.y0 < min_y) min_y = pc.x0;
-	  if (pc.x0 < max_x) max_x = pc.y0;
-	  if (pc.y0 < max_y) max_y = pc.y0;
+	  // arcs are bounded conservatively by their full circle
+	  double r = pc.type == PathComponent::ARC ? pc.radius : 0;
+	  if (pc.x0 - r < min_x) min_x = pc.x0 - r;
+	  if (pc.y0 - r < min_y) min_y = pc.y0 - r;
+	  if (pc.x0 + r > max_x) max_x = pc.x0 + r;
+	  if (pc.y0 + r > max_y) max_y = pc.y0 + r;
 	}
       }
     }
@@ -1,6 +1,7 @@
 #ifndef _WEB_COLOR_H_
 #define _WEB_COLOR_H_
 
+#include <string>
 #include "csscolorparser.h"
 
 using namespace std;
@@ -32,6 +33,17 @@ namespace canvas
       this->a = val.a;
       return *this;
     }
+    bool operator==(const web_color& val) const {
+      return r == val.r && g == val.g && b == val.b && a == val.a;
+    }
+
+    unsigned int to_argb() const {
+      return ((unsigned int)a << (8 * 3)) | ((unsigned int)r << (8 * 2)) | ((unsigned int)g << (8 * 1)) | ((unsigned int)b << (8 * 0));
+    }
+    // canvas serialization: #rrggbb when opaque, rgba(r, g, b, a) otherwise
+    std::string to_string() const;
+
+    // Parses through a bounded per-thread cache, with a fast path for #rrggbb, rgb() and rgba().
     static web_color from_string(const char* str);
   };
 }
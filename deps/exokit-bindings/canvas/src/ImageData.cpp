@@ -4,6 +4,14 @@
 #include <algorithm>
 #include <cassert>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define CANVAS_SSE2
+  #include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+  #define CANVAS_NEON
+  #include <arm_neon.h>
+#endif
+
 #define STB_IMAGE_RESIZE_IMPLEMENTATION
 #include "stb_image_resize.h"
 
@@ -15,6 +23,7 @@ using namespace std;
 using namespace canvas;
 
 bool ImageData::flip = false;
+bool ImageData::simd = true;
 
 std::unique_ptr<ImageData>
 ImageData::crop(int x, int y, unsigned short w, unsigned short h, bool flipY) const {
@@ -62,26 +71,88 @@ ImageData::scale(unsigned short target_width, unsigned short target_height) cons
   return unique_ptr<ImageData>(new ImageData(outputData.get(), target_width, target_height, num_channels));
 }
 
-std::unique_ptr<ImageData>
-ImageData::colorize(const Color & color) const {
+static bool colorize_fits_simd(int red, int green, int blue, int alpha) {
+  return red >= 0 && red <= 255 && green >= 0 && green <= 255 && blue >= 0 && blue <= 255 && alpha >= 0 && alpha <= 255;
+}
+
+static void colorize_scalar(const unsigned char * src, unsigned char * dst, size_t count, size_t start, int red, int green, int blue, int alpha) {
+  for (size_t i = start; i < count; i++) {
+    unsigned char v = src[i];
+    dst[4 * i + 0] = (unsigned char)(red * v / 255);
+    dst[4 * i + 1] = (unsigned char)(green * v / 255);
+    dst[4 * i + 2] = (unsigned char)(blue * v / 255);
+    dst[4 * i + 3] = (unsigned char)(alpha * v / 255);
+  }
+}
+
+// x / 255 is (x + 1 + (x >> 8)) >> 8 for every x that fits in 16 bits, so the vector paths are exact.
+static void colorize_simd(const unsigned char * src, unsigned char * dst, size_t count, int red, int green, int blue, int alpha) {
+  size_t i = 0;
+#if defined(CANVAS_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i one = _mm_set1_epi16(1);
+  const __m128i rgba = _mm_setr_epi16(red, green, blue, alpha, red, green, blue, alpha);
+  for (; i + 8 <= count; i += 8) {
+    __m128i v = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(src + i)), zero);
+    __m128i v2 = _mm_unpacklo_epi16(v, v);
+    __m128i v4[4] = {
+      _mm_unpacklo_epi32(v2, v2),
+      _mm_unpackhi_epi32(v2, v2),
+    };
+    v2 = _mm_unpackhi_epi16(v, v);
+    v4[2] = _mm_unpacklo_epi32(v2, v2);
+    v4[3] = _mm_unpackhi_epi32(v2, v2);
+
+    __m128i out[4];
+    for (int j = 0; j < 4; j++) {
+      __m128i x = _mm_mullo_epi16(v4[j], rgba);
+      x = _mm_add_epi16(_mm_add_epi16(x, one), _mm_srli_epi16(x, 8));
+      out[j] = _mm_srli_epi16(x, 8);
+    }
+    _mm_storeu_si128((__m128i *)(dst + 4 * i), _mm_packus_epi16(out[0], out[1]));
+    _mm_storeu_si128((__m128i *)(dst + 4 * i + 16), _mm_packus_epi16(out[2], out[3]));
+  }
+#elif defined(CANVAS_NEON)
+  const uint8x8_t channels[4] = {vdup_n_u8(red), vdup_n_u8(green), vdup_n_u8(blue), vdup_n_u8(alpha)};
+  const uint16x8_t one = vdupq_n_u16(1);
+  for (; i + 8 <= count; i += 8) {
+    uint8x8_t v = vld1_u8(src + i);
+    uint8x8x4_t out;
+    for (int j = 0; j < 4; j++) {
+      uint16x8_t x = vmull_u8(v, channels[j]);
+      x = vaddq_u16(vaddq_u16(x, one), vshrq_n_u16(x, 8));
+      out.val[j] = vshrn_n_u16(x, 8);
+    }
+    vst4_u8(dst + 4 * i, out);
+  }
+#endif
+  colorize_scalar(src, dst, count, i, red, green, blue, alpha);
+}
+
+void
+ImageData::colorize(const Color & color, unsigned char * target) const {
   assert(num_channels == 1);
+  colorizePixels(getData(), target, (size_t)width * height, color);
+}
 
+void
+ImageData::colorizePixels(const unsigned char * alpha, unsigned char * target, size_t count, const Color & color) {
   int red = int(255 * color.red * color.alpha);
   int green = int(255 * color.green * color.alpha);
   int blue = int(255 * color.blue * color.alpha);
-  int alpha = int(255 * color.alpha);
-
-  unique_ptr<ImageData> r(new ImageData(width, height, 4));
+  int alphaValue = int(255 * color.alpha);
 
-  unsigned char * target_buffer = r->getData();
-  for (unsigned int i = 0; i < width * height; i++) {
-    unsigned char v = data[i];
-    target_buffer[4 * i + 0] = (unsigned char)(red * v / 255);
-    target_buffer[4 * i + 1] = (unsigned char)(green * v / 255);
-    target_buffer[4 * i + 2] = (unsigned char)(blue * v / 255);
-    target_buffer[4 * i + 3] = (unsigned char)(alpha * v / 255);
+  if (simd && colorize_fits_simd(red, green, blue, alphaValue)) {
+    colorize_simd(alpha, target, count, red, green, blue, alphaValue);
+  } else {
+    colorize_scalar(alpha, target, count, 0, red, green, blue, alphaValue);
   }
+}
 
+std::unique_ptr<ImageData>
+ImageData::colorize(const Color & color) const {
+  unique_ptr<ImageData> r(new ImageData(width, height, 4));
+  colorize(color, r->getData());
   return r;
 }
 
@@ -107,117 +178,148 @@ static vector<int> make_kernel(float radius) {
   return kernel;
 }
 
-std::unique_ptr<ImageData>
-ImageData::blur(float hradius, float vradius) const {
-  unique_ptr<ImageData> r(new ImageData(width, height, num_channels));
-
-  if (num_channels == 4) {
-    unsigned char * tmp = new unsigned char[width * height * 4];
-    if (hradius > 0.0f) {
-      vector<int> hkernel = make_kernel(hradius);
-      unsigned short hsize = hkernel.size();
-
-      int htotal = 0;
-      for (auto & a : hkernel) htotal += a;
-
-      memset(tmp, 0, width * height * 4);
-      for (unsigned int row = 0; row < height; row++) {
-        for (unsigned int col = 0; col + hsize <= width; col++) {
-          int c0 = 0, c1 = 0, c2 = 0, c3 = 0;
-          for (unsigned int i = 0; i < hsize; i++) {
-            const unsigned char * ptr = getData() + (row * width + col + i) * 4;
-            c0 += *ptr++ * hkernel[i];
-            c1 += *ptr++ * hkernel[i];
-            c2 += *ptr++ * hkernel[i];
-            c3 += *ptr++ * hkernel[i];
-          }
-          unsigned char * ptr = tmp + (row * width + col + hsize / 2) * 4;
-          *ptr++ = (unsigned char)(c0 / htotal);
-          *ptr++ = (unsigned char)(c1 / htotal);
-          *ptr++ = (unsigned char)(c2 / htotal);
-          *ptr++ = (unsigned char)(c3 / htotal);
-        }
-      }
-    } else {
-      memcpy(tmp, getData(), width * height * 4);
+// out[x] = sum(kernel[i] * in[x + i * stride]) / total, for x in [start, count).
+// Horizontal passes use the channel count as stride and vertical passes the row size,
+// so one routine covers both directions and any channel count.
+static void convolve_scalar(const unsigned char * in, unsigned char * out, size_t start, size_t count, size_t stride, const vector<int> & kernel, int total) {
+  const size_t size = kernel.size();
+  for (size_t x = start; x < count; x++) {
+    int c = 0;
+    for (size_t i = 0; i < size; i++) {
+      c += in[x + i * stride] * kernel[i];
+    }
+    out[x] = (unsigned char)(c / total);
+  }
+}
+
+// The vector paths multiply 16-bit weights and divide in single precision, which is exact
+// as long as every weight fits in 16 bits and 255 * total fits in the float mantissa.
+static bool kernel_fits_simd(const vector<int> & kernel, int total) {
+  for (auto & a : kernel) {
+    if (a < 0 || a > 32767) {
+      return false;
     }
-    if (vradius > 0) {
-      vector<int> vkernel = make_kernel(vradius);
-      unsigned short vsize = vkernel.size();
-
-      int vtotal = 0;
-      for (auto & a : vkernel) vtotal += a;
-
-      memset(r->getData(), 0, width * height * 4);
-      for (unsigned int col = 0; col < width; col++) {
-        for (unsigned int row = 0; row + vsize <= height; row++) {
-          int c0 = 0, c1 = 0, c2 = 0, c3 = 0;
-          for (unsigned int i = 0; i < vsize; i++) {
-            const unsigned char * ptr = tmp + ((row + i) * width + col) * 4;
-            c0 += *ptr++ * vkernel[i];
-            c1 += *ptr++ * vkernel[i];
-            c2 += *ptr++ * vkernel[i];
-            c3 += *ptr++ * vkernel[i];
-          }
-          unsigned char * ptr = r->getData() + ((row + vsize / 2) * width + col) * 4;
-          *ptr++ = (unsigned char)(c0 / vtotal);
-          *ptr++ = (unsigned char)(c1 / vtotal);
-          *ptr++ = (unsigned char)(c2 / vtotal);
-          *ptr++ = (unsigned char)(c3 / vtotal);
-        }
+  }
+  return total > 0 && total <= (1 << 24) / 255;
+}
+
+static void convolve_simd(const unsigned char * in, unsigned char * out, size_t count, size_t stride, const vector<int> & kernel, int total) {
+  const size_t size = kernel.size();
+  size_t x = 0;
+#if defined(CANVAS_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128 totalf = _mm_set1_ps((float)total);
+  for (; x + 16 <= count; x += 16) {
+    __m128i acc[4] = {zero, zero, zero, zero};
+    for (size_t i = 0; i < size; i += 2) {
+      __m128i a = _mm_loadu_si128((const __m128i *)(in + x + i * stride));
+      __m128i b;
+      __m128i w;
+      if (i + 1 < size) {
+        b = _mm_loadu_si128((const __m128i *)(in + x + (i + 1) * stride));
+        w = _mm_set1_epi32((kernel[i + 1] << 16) | kernel[i]);
+      } else {
+        b = zero;
+        w = _mm_set1_epi32(kernel[i]);
       }
-    } else {
-      memcpy(r->getData(), tmp, width * height * 4);
+      __m128i aLo = _mm_unpacklo_epi8(a, zero), aHi = _mm_unpackhi_epi8(a, zero);
+      __m128i bLo = _mm_unpacklo_epi8(b, zero), bHi = _mm_unpackhi_epi8(b, zero);
+      acc[0] = _mm_add_epi32(acc[0], _mm_madd_epi16(_mm_unpacklo_epi16(aLo, bLo), w));
+      acc[1] = _mm_add_epi32(acc[1], _mm_madd_epi16(_mm_unpackhi_epi16(aLo, bLo), w));
+      acc[2] = _mm_add_epi32(acc[2], _mm_madd_epi16(_mm_unpacklo_epi16(aHi, bHi), w));
+      acc[3] = _mm_add_epi32(acc[3], _mm_madd_epi16(_mm_unpackhi_epi16(aHi, bHi), w));
+    }
+    __m128i q[4];
+    for (int j = 0; j < 4; j++) {
+      q[j] = _mm_cvttps_epi32(_mm_div_ps(_mm_cvtepi32_ps(acc[j]), totalf));
     }
-    delete[] tmp;
-  } else if (num_channels == 1) {
-    unsigned char * tmp = new unsigned char[width * height];
-    if (hradius > 0.0f) {
-      vector<int> hkernel = make_kernel(hradius);
-      unsigned short hsize = hkernel.size();
-
-      int htotal = 0;
-      for (auto & a : hkernel) htotal += a;
-
-      memset(tmp, 0, width * height);
-      for (unsigned int row = 0; row < height; row++) {
-        for (unsigned int col = 0; col + hsize <= width; col++) {
-          int c0 = 0;
-          for (unsigned int i = 0; i < hsize; i++) {
-            const unsigned char * ptr = getData() + (row * width + col + i);
-            c0 += *ptr * hkernel[i];
-          }
-          unsigned char * ptr = tmp + (row * width + col + hsize / 2);
-          *ptr = (unsigned char)(c0 / htotal);
-        }
+    _mm_storeu_si128((__m128i *)(out + x), _mm_packus_epi16(_mm_packs_epi32(q[0], q[1]), _mm_packs_epi32(q[2], q[3])));
+  }
+#elif defined(CANVAS_NEON)
+  const float32x4_t totalf = vdupq_n_f32((float)total);
+  for (; x + 16 <= count; x += 16) {
+    int32x4_t acc[4] = {vdupq_n_s32(0), vdupq_n_s32(0), vdupq_n_s32(0), vdupq_n_s32(0)};
+    for (size_t i = 0; i < size; i++) {
+      uint8x16_t a = vld1q_u8(in + x + i * stride);
+      int16x8_t aLo = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(a)));
+      int16x8_t aHi = vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(a)));
+      int16_t k = (int16_t)kernel[i];
+      acc[0] = vmlal_n_s16(acc[0], vget_low_s16(aLo), k);
+      acc[1] = vmlal_n_s16(acc[1], vget_high_s16(aLo), k);
+      acc[2] = vmlal_n_s16(acc[2], vget_low_s16(aHi), k);
+      acc[3] = vmlal_n_s16(acc[3], vget_high_s16(aHi), k);
+    }
+    uint16x4_t q[4];
+    for (int j = 0; j < 4; j++) {
+      q[j] = vqmovun_s32(vcvtq_s32_f32(vdivq_f32(vcvtq_f32_s32(acc[j]), totalf)));
+    }
+    vst1q_u8(out + x, vcombine_u8(vqmovn_u16(vcombine_u16(q[0], q[1])), vqmovn_u16(vcombine_u16(q[2], q[3]))));
+  }
+#endif
+  convolve_scalar(in, out, x, count, stride, kernel, total);
+}
+
+static void convolve(const unsigned char * in, unsigned char * out, size_t count, size_t stride, const vector<int> & kernel) {
+  int total = 0;
+  for (auto & a : kernel) total += a;
+
+  if (ImageData::getSimd() && kernel_fits_simd(kernel, total)) {
+    convolve_simd(in, out, count, stride, kernel, total);
+  } else {
+    convolve_scalar(in, out, 0, count, stride, kernel, total);
+  }
+}
+
+void
+ImageData::blurInPlace(float hradius, float vradius) {
+  blurPixels(getData(), width, height, num_channels, hradius, vradius);
+}
+
+// Gaussian blur. Pixels closer to an edge than the kernel radius come out transparent.
+void
+ImageData::blurPixels(unsigned char * data, size_t width, size_t height, size_t num_channels, float hradius, float vradius) {
+  const size_t rowSize = width * num_channels;
+  const size_t size = rowSize * height;
+  if (size == 0 || (hradius <= 0.0f && vradius <= 0.0f)) {
+    return;
+  }
+
+  thread_local vector<unsigned char> scratch;
+  scratch.resize(size);
+  unsigned char * tmp = scratch.data();
+
+  if (hradius > 0.0f) {
+    vector<int> hkernel = make_kernel(hradius);
+    const size_t hsize = hkernel.size();
+
+    memset(tmp, 0, size);
+    if (hsize <= width) {
+      for (size_t row = 0; row < height; row++) {
+        convolve(data + row * rowSize, tmp + row * rowSize + (hsize / 2) * num_channels, (width - hsize + 1) * num_channels, num_channels, hkernel);
       }
-    } else {
-      memcpy(tmp, getData(), width * height);
     }
-    if (vradius > 0) {
-      vector<int> vkernel = make_kernel(vradius);
-      unsigned short vsize = vkernel.size();
-      int vtotal = 0;
-      for (auto & a : vkernel) vtotal += a;
-
-      memset(r->getData(), 0, width * height);
-      for (unsigned int col = 0; col < width; col++) {
-        for (unsigned int row = 0; row + vsize <= height; row++) {
-          int c0 = 0;
-          for (unsigned int i = 0; i < vsize; i++) {
-            const unsigned char * ptr = tmp + ((row + i) * width + col);
-            c0 += *ptr * vkernel[i];
-          }
-          unsigned char * ptr = r->getData() + ((row + vsize / 2) * width + col);
-          *ptr = (unsigned char)(c0 / vtotal);
-        }
+  } else {
+    memcpy(tmp, data, size);
+  }
+
+  if (vradius > 0.0f) {
+    vector<int> vkernel = make_kernel(vradius);
+    const size_t vsize = vkernel.size();
+
+    memset(data, 0, size);
+    if (vsize <= height) {
+      for (size_t row = 0; row + vsize <= height; row++) {
+        convolve(tmp + row * rowSize, data + (row + vsize / 2) * rowSize, rowSize, rowSize, vkernel);
       }
-    } else {
-      memcpy(r->getData(), tmp, width * height);
     }
-    delete[] tmp;
+  } else {
+    memcpy(data, tmp, size);
   }
+}
 
+std::unique_ptr<ImageData>
+ImageData::blur(float hradius, float vradius) const {
+  unique_ptr<ImageData> r(new ImageData(*this));
+  r->blurInPlace(hradius, vradius);
   return r;
 }
-
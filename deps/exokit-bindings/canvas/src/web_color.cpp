@@ -1,6 +1,167 @@
 #include <web_color.h>
 
+#include <cstdio>
+#include <cstdlib>
+#include <unordered_map>
+
+namespace {
+
+const size_t maxCachedColors = 256;
+
+int hex_value(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  } else if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  } else if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  } else {
+    return -1;
+  }
+}
+
+const char *skip_spaces(const char *p) {
+  while (*p == ' ') {
+    p++;
+  }
+  return p;
+}
+
+// Plain integer component followed by the separator; anything else (percentages, fractions) is left to the full parser.
+bool parse_byte(const char *&p, char separator, unsigned char &result) {
+  p = skip_spaces(p);
+  if (*p < '0' || *p > '9') {
+    return false;
+  }
+  int value = 0;
+  while (*p >= '0' && *p <= '9') {
+    if (value < 256) {
+      value = value * 10 + (*p - '0');
+    }
+    p++;
+  }
+  p = skip_spaces(p);
+  if (*p != separator) {
+    return false;
+  }
+  p++;
+  result = value > 255 ? 255 : (unsigned char)value;
+  return true;
+}
+
+bool parse_alpha(const char *&p, float &result) {
+  p = skip_spaces(p);
+  const char *start = p;
+  while ((*p >= '0' && *p <= '9') || *p == '.') {
+    p++;
+  }
+  if (p == start) {
+    return false;
+  }
+  const char *end = p;
+  p = skip_spaces(p);
+  if (*p != ')') {
+    return false;
+  }
+  p++;
+  char *parsedEnd;
+  float alpha = strtof(start, &parsedEnd);
+  if (parsedEnd != end) {
+    return false;
+  }
+  result = alpha > 1 ? 1 : alpha;
+  return true;
+}
+
+// Returns false if the string should go through CSSColorParser instead.
+bool parse_fast(const char *str, canvas::web_color &result) {
+  if (str[0] == '#') {
+    for (int i = 1; i <= 6; i++) {
+      if (hex_value(str[i]) < 0) {
+        return false;
+      }
+    }
+    if (str[7] != '\0') {
+      return false;
+    }
+    result = canvas::web_color(
+      (unsigned char)(hex_value(str[1]) * 16 + hex_value(str[2])),
+      (unsigned char)(hex_value(str[3]) * 16 + hex_value(str[4])),
+      (unsigned char)(hex_value(str[5]) * 16 + hex_value(str[6]))
+    );
+    return true;
+  } else if (str[0] == 'r' && str[1] == 'g' && str[2] == 'b') {
+    bool hasAlpha = str[3] == 'a';
+    const char *p = str + (hasAlpha ? 4 : 3);
+    if (*p != '(') {
+      return false;
+    }
+    p++;
+
+    unsigned char r, g, b;
+    float a = 1;
+    if (!parse_byte(p, ',', r) || !parse_byte(p, ',', g) || !parse_byte(p, hasAlpha ? ',' : ')', b)) {
+      return false;
+    }
+    if (hasAlpha && !parse_alpha(p, a)) {
+      return false;
+    }
+    if (*p != '\0') {
+      return false;
+    }
+    result = canvas::web_color(r, g, b, (unsigned char)(a * 255.0));
+    return true;
+  } else {
+    return false;
+  }
+}
+
+}
+
+std::string canvas::web_color::to_string() const {
+  char buffer[32];
+  if (a == 0xFF) {
+    snprintf(buffer, sizeof(buffer), "#%02x%02x%02x", r, g, b);
+  } else {
+    // shortest alpha that maps back to the same byte
+    int precision = 2;
+    for (; precision < 4; precision++) {
+      snprintf(buffer, sizeof(buffer), "%.*f", precision, a / 255.0);
+      if ((unsigned char)(strtof(buffer, nullptr) * 255.0) == a) {
+        break;
+      }
+    }
+    std::string alpha(buffer);
+    while (alpha.back() == '0') {
+      alpha.pop_back();
+    }
+    if (alpha.back() == '.') {
+      alpha.pop_back();
+    }
+    snprintf(buffer, sizeof(buffer), "rgba(%d, %d, %d, %s)", r, g, b, alpha.c_str());
+  }
+  return std::string(buffer);
+}
+
 canvas::web_color canvas::web_color::from_string(const char *str) {
-  CSSColorParser::Color color(CSSColorParser::parse(str));
-  return web_color(color.r, color.g, color.b, (unsigned char)(color.a * 255.0));
-}
\ No newline at end of file
+  web_color result;
+  if (parse_fast(str, result)) {
+    return result;
+  }
+
+  thread_local std::unordered_map<std::string, web_color> cache;
+  std::string key(str);
+  auto iter = cache.find(key);
+  if (iter != cache.end()) {
+    return iter->second;
+  }
+
+  CSSColorParser::Color color(CSSColorParser::parse(key));
+  result = web_color(color.r, color.g, color.b, (unsigned char)(color.a * 255.0));
+
+  if (cache.size() >= maxCachedColors) {
+    cache.clear();
+  }
+  cache.emplace(std::move(key), result);
+  return result;
+}
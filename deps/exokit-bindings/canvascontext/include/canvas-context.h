@@ -20,7 +20,13 @@
 #include <SkCanvas.h>
 #include <SkPath.h>
 #include <SkPaint.h>
+#include <SkBlurImageFilter.h>
+#include <SkDropShadowImageFilter.h>
 #include <webglcontext/include/webgl.h>
+#include <external-memory.h>
+#include "text-cache.h"
+#include "font-cache.h"
+#include "image-encoder.h"
 
 using namespace v8;
 using namespace node;
@@ -31,6 +37,11 @@ class ImageBitmap;
 class Path2D;
 class CanvasGradient;
 
+// Wraps pixels owned by a Skia object in an ArrayBuffer that keeps the owner alive until the buffer is collected.
+Local<ArrayBuffer> makePixelsArrayBuffer(sk_sp<SkRefCnt> owner, void *data, size_t length);
+// SkBitmap release proc for pixels allocated with malloc.
+void freePixels(void *addr, void *context);
+
 enum class TextBaseline {
   TOP,
   HANGING,
@@ -77,10 +88,12 @@ public:
   void ClearRect(float x, float y, float w, float h);
   void FillText(const std::string &text, float x, float y);
   void StrokeText(const std::string &text, float x, float y);
+  void DrawText(const std::string &text, float x, float y, const SkPaint &paint);
   bool Resize(unsigned int w, unsigned int h);
   void DrawImage(const SkImage *image, float sx, float sy, float sw, float sh, float dx, float dy, float dw, float dh, bool flipY);
   void Save();
   void Restore();
+  void UpdateImageFilter();
 
 protected:
   static NAN_METHOD(New);
@@ -113,6 +126,16 @@ protected:
   static NAN_SETTER(TextBaselineSetter);
   static NAN_GETTER(DirectionGetter);
   static NAN_SETTER(DirectionSetter);
+  static NAN_GETTER(ShadowBlurGetter);
+  static NAN_SETTER(ShadowBlurSetter);
+  static NAN_GETTER(ShadowColorGetter);
+  static NAN_SETTER(ShadowColorSetter);
+  static NAN_GETTER(ShadowOffsetXGetter);
+  static NAN_SETTER(ShadowOffsetXSetter);
+  static NAN_GETTER(ShadowOffsetYGetter);
+  static NAN_SETTER(ShadowOffsetYSetter);
+  static NAN_GETTER(FilterGetter);
+  static NAN_SETTER(FilterSetter);
   static NAN_METHOD(Scale);
   static NAN_METHOD(Rotate);
   static NAN_METHOD(Translate);
@@ -148,6 +171,7 @@ protected:
   static NAN_METHOD(Save);
   static NAN_METHOD(Restore);
   static NAN_METHOD(ToDataURL);
+  static NAN_METHOD(ToBlob);
   static NAN_METHOD(Destroy);
 
   static bool isImageType(Local<Value> arg);
@@ -165,10 +189,25 @@ private:
   SkPaint strokePaint;
   SkPaint fillPaint;
   SkPaint clearPaint;
+  Nan::Persistent<Value> strokeStyle;
+  Nan::Persistent<Value> fillStyle;
   float lineHeight;
+  // last font shorthand applied, cleared when any of its parts is set separately
+  std::shared_ptr<const FontInfo> fontInfo;
+  std::string fontFamily;
+  SkFontStyle fontStyle;
   std::string textAlign;
   TextBaseline textBaseline;
   Direction direction;
+  // shadows and filter blur are drawn natively through an SkImageFilter on the paints
+  float shadowBlur;
+  canvas::web_color shadowColor;
+  float shadowOffsetX;
+  float shadowOffsetY;
+  std::string filter;
+  float filterBlur;
+  TextCache textCache;
+  externalmemory::ExternalMemory externalMemory;
 
   friend class Image;
   friend class ImageData;
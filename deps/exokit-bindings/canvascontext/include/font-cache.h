@@ -0,0 +1,60 @@
+#ifndef _CANVASCONTEXT_FONTCACHE_H_
+#define _CANVASCONTEXT_FONTCACHE_H_
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <SkRefCnt.h>
+#include <SkScalar.h>
+#include <SkFontStyle.h>
+#include <SkTypeface.h>
+#include <canvas/include/web_font.h>
+
+// A parsed CSS font shorthand with its typeface resolved.
+struct FontInfo {
+  std::string font;
+  canvas::FontDeclaration declaration;
+  std::string fontFamily;
+  SkFontStyle fontStyle;
+  sk_sp<SkTypeface> typeface;
+  SkScalar textSize;
+  float lineHeight;
+};
+
+// Process-wide cache of font shorthand parses and typeface lookups, so that setting ctx.font
+// in a hot loop does not reparse the declaration or hit fontconfig.
+// Each map is flushed wholesale once it reaches maxEntries.
+class FontCache {
+public:
+  static std::shared_ptr<const FontInfo> getFont(const std::string &font);
+  static sk_sp<SkTypeface> getTypeface(const std::string &fontFamily, const SkFontStyle &fontStyle);
+
+  static unsigned int parseFontWeight(const std::string &fontWeight, unsigned int defaultWeight);
+  static SkFontStyle::Slant parseFontSlant(const std::string &fontStyle);
+
+protected:
+  struct TypefaceKey {
+    std::string fontFamily;
+    int weight;
+    int width;
+    int slant;
+
+    bool operator==(const TypefaceKey &other) const {
+      return weight == other.weight && width == other.width && slant == other.slant && fontFamily == other.fontFamily;
+    }
+  };
+  struct TypefaceKeyHash {
+    size_t operator()(const TypefaceKey &key) const;
+  };
+
+  static const size_t maxEntries = 256;
+
+  static std::mutex mutex;
+  static std::unordered_map<std::string, std::shared_ptr<const FontInfo>> fonts;
+  static std::unordered_map<TypefaceKey, sk_sp<SkTypeface>, TypefaceKeyHash> typefaces;
+
+  static sk_sp<SkTypeface> getTypefaceLocked(const std::string &fontFamily, const SkFontStyle &fontStyle);
+};
+
+#endif
@@ -5,6 +5,7 @@
 #include <node.h>
 #include <nan.h>
 #include <defines.h>
+#include <external-memory.h>
 #include <canvas/include/Context.h>
 #include <canvas/include/Image.h>
 #include <canvas/include/ImageData.h>
@@ -48,6 +49,7 @@ private:
   Nan::Persistent<Function> cbFn;
   std::string error;
   uv_async_t threadAsync;
+  externalmemory::ExternalMemory externalMemory;
 
   friend class CanvasRenderingContext2D;
   friend class ImageData;
@@ -0,0 +1,51 @@
+#ifndef _CANVASCONTEXT_IMAGEENCODER_H_
+#define _CANVASCONTEXT_IMAGEENCODER_H_
+
+#include <v8.h>
+#include <node.h>
+#include <nan.h>
+#include <defines.h>
+#include <SkRefCnt.h>
+#include <SkData.h>
+#include <SkImage.h>
+#include <SkPixmap.h>
+#include <SkStream.h>
+#include <SkImageEncoder.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+using namespace v8;
+using namespace node;
+
+// A PNG/JPEG encode request. Pixels come either from an immutable image snapshot
+// or from a JS buffer which is kept alive until the callback runs.
+struct ImageEncodeJob {
+  sk_sp<SkImage> image;
+  SkPixmap pixmap;
+  bool flipY;
+  std::string type;
+  SkEncodedImageFormat format;
+  int quality;
+  Nan::Persistent<ArrayBuffer> arrayBuffer;
+  Nan::Persistent<Function> cbFn;
+  sk_sp<SkData> result;
+};
+
+// Process-wide pool of encoder threads. Each worker keeps its output stream and
+// flip buffer across jobs; results are delivered on the main thread as cb(err, arrayBuffer, type).
+class ImageEncoder {
+public:
+  static void ParseType(Local<Value> typeValue, Local<Value> qualityValue, std::string &type, SkEncodedImageFormat &format, int &quality);
+  static void Queue(ImageEncodeJob *job);
+  static NAN_METHOD(EncodePixels);
+
+protected:
+  static void WorkerLoop();
+  static void RunInMainThread(uv_async_t *handle);
+};
+
+#endif
@@ -4,6 +4,7 @@
 #include <v8.h>
 #include <nan.h>
 #include <defines.h>
+#include <external-memory.h>
 #include <canvas/include/Context.h>
 #include <canvas/include/ImageData.h>
 #include <SkBitmap.h>
@@ -38,6 +39,7 @@ protected:
 private:
   SkBitmap bitmap;
   Nan::Persistent<Uint8ClampedArray> dataArray;
+  externalmemory::ExternalMemory externalMemory;
 
   friend class CanvasRenderingContext2D;
 };
@@ -4,6 +4,7 @@
 #include <v8.h>
 #include <nan.h>
 #include <defines.h>
+#include <external-memory.h>
 #include <canvas/include/Context.h>
 #include <canvas/include/ImageData.h>
 #include <SkBitmap.h>
@@ -28,6 +29,9 @@ protected:
   static NAN_GETTER(WidthGetter);
   static NAN_GETTER(HeightGetter);
   static NAN_GETTER(DataGetter);
+  static NAN_METHOD(BlurPixels);
+  static NAN_METHOD(ColorizePixels);
+  static NAN_METHOD(SetSimd);
 
   ImageData(unsigned int width, unsigned int height);
   ImageData(const char *data, unsigned int width, unsigned int height);
@@ -36,6 +40,7 @@ protected:
 private:
   SkBitmap bitmap;
   Nan::Persistent<Uint8ClampedArray> dataArray;
+  externalmemory::ExternalMemory externalMemory;
 
   friend class CanvasRenderingContext2D;
 };
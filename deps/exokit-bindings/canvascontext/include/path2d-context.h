@@ -14,16 +14,27 @@
 using namespace v8;
 using namespace node;
 
+// Appends a canvas arc() to path: angles in radians, joined to the current point with a line.
+void addCanvasArc(SkPath &path, float x, float y, float radius, float startAngle, float endAngle, bool anticlockwise);
+
+// Path2D keeps a retained SkPath that commands append to, so fill(path) and stroke(path)
+// hand Skia the same path object (and generation ID) every frame.
 class Path2D : public ObjectWrap {
 public:
   static Handle<Object> Initialize(Isolate *isolate);
+  static bool IsPath2D(Local<Value> value);
   void MoveTo(float x, float y);
   void LineTo(float x, float y);
   void ClosePath();
   void Arc(float x, float y, float radius, float startAngle, float endAngle, float anticlockwise);
   void ArcTo(float x1, float y1, float x2, float y2, float radius);
   void QuadraticCurveTo(float cpx, float cpy, float x, float y);
+  void BezierCurveTo(float cp1x, float cp1y, float cp2x, float cp2y, float x, float y);
+  void Rect(float x, float y, float w, float h);
+  void AddPath(const Path2D &other);
   void Clear();
+  const SkRect &GetBounds();
+  uint32_t GetGenerationID() const;
 
 protected:
   static NAN_METHOD(New);
@@ -33,13 +44,23 @@ protected:
   static NAN_METHOD(Arc);
   static NAN_METHOD(ArcTo);
   static NAN_METHOD(QuadraticCurveTo);
+  static NAN_METHOD(BezierCurveTo);
+  static NAN_METHOD(Rect);
+  static NAN_METHOD(AddPath);
   static NAN_METHOD(Clear);
+  static NAN_METHOD(GetBounds);
+  static NAN_METHOD(GetGenerationID);
 
   Path2D();
   virtual ~Path2D();
 
 private:
+  static Nan::Persistent<FunctionTemplate> path2dTemplate;
+
   SkPath path;
+  // tight bounds, valid while boundsGenerationID matches the path
+  SkRect bounds;
+  uint32_t boundsGenerationID;
 
   friend class CanvasRenderingContext2D;
 };
@@ -0,0 +1,47 @@
+#ifndef _CANVASCONTEXT_TEXTCACHE_H_
+#define _CANVASCONTEXT_TEXTCACHE_H_
+
+#include <string>
+#include <unordered_map>
+#include <SkRefCnt.h>
+#include <SkScalar.h>
+#include <SkPaint.h>
+#include <SkTypeface.h>
+#include <SkTextBlob.h>
+
+// Shaped text for a (typeface, size, string) triple.
+// blob is laid out left aligned at the origin; callers apply textAlign using advance.
+struct TextRun {
+  sk_sp<SkTextBlob> blob;
+  SkScalar advance;
+  SkScalar width;
+};
+
+// Per-context cache of shaped glyph runs and metrics, so that labels redrawn every frame skip shaping.
+// The cache is flushed wholesale once it reaches maxEntries.
+class TextCache {
+public:
+  TextCache(size_t maxEntries = 1024);
+
+  const TextRun &get(const SkPaint &paint, const std::string &text);
+  void clear();
+
+protected:
+  struct Key {
+    SkFontID typefaceId;
+    SkScalar textSize;
+    std::string text;
+
+    bool operator==(const Key &other) const {
+      return typefaceId == other.typefaceId && textSize == other.textSize && text == other.text;
+    }
+  };
+  struct KeyHash {
+    size_t operator()(const Key &key) const;
+  };
+
+  std::unordered_map<Key, TextRun, KeyHash> entries;
+  size_t maxEntries;
+};
+
+#endif
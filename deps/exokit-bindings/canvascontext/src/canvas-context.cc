@@ -65,6 +65,7 @@ Handle<Object> CanvasRenderingContext2D::Initialize(Isolate *isolate, Local<Valu
   Nan::SetMethod(proto,"save", Save);
   Nan::SetMethod(proto,"restore", Restore);
   Nan::SetMethod(proto,"toDataURL", ToDataURL);
+  Nan::SetMethod(proto,"toBlob", ToBlob);
   Nan::SetMethod(proto,"createImageData", CreateImageData);
   Nan::SetMethod(proto,"getImageData", GetImageData);
   Nan::SetMethod(proto,"putImageData", PutImageData);
@@ -75,6 +76,7 @@ Handle<Object> CanvasRenderingContext2D::Initialize(Isolate *isolate, Local<Valu
   ctorFn->Set(JS_STR("ImageData"), imageDataCons);
   ctorFn->Set(JS_STR("CanvasGradient"), canvasGradientCons);
   ctorFn->Set(JS_STR("CanvasPattern"), canvasPatternCons);
+  Nan::SetMethod(ctorFn, "encodePixels", ImageEncoder::EncodePixels);
 
   return scope.Escape(ctorFn);
 }
@@ -126,9 +128,7 @@ void CanvasRenderingContext2D::ResetTransform() {
 }
 
 float CanvasRenderingContext2D::MeasureText(const std::string &text) {
-  SkRect bounds;
-  strokePaint.measureText(text.c_str(), text.length(), &bounds);
-  return bounds.width();
+  return textCache.get(strokePaint, text).width;
 }
 
 void CanvasRenderingContext2D::BeginPath() {
@@ -168,16 +168,11 @@ void CanvasRenderingContext2D::LineTo(float x, float y) {
 }
 
 void CanvasRenderingContext2D::Arc(float x, float y, float radius, float startAngle, float endAngle, float anticlockwise) {
-  startAngle = startAngle / M_PI * 360;
-  endAngle = endAngle / M_PI * 360;
-  if (anticlockwise) {
-    endAngle -= 360;
-  }
-  path.addArc(SkRect::MakeLTRB(x - radius, y - radius, x + radius, y + radius), startAngle, endAngle);
+  addCanvasArc(path, x, y, radius, startAngle, endAngle, anticlockwise);
 }
 
 void CanvasRenderingContext2D::ArcTo(float x1, float y1, float x2, float y2, float radius) {
-  path.arcTo(x1, y1, x2 - x1, y2 - y1, radius);
+  path.arcTo(x1, y1, x2, y2, radius);
 }
 
 void CanvasRenderingContext2D::QuadraticCurveTo(float cpx, float cpy, float x, float y) {
@@ -243,13 +238,31 @@ float getFontBaseline(const SkPaint &paint, const TextBaseline &textBaseline, fl
 }
 
 void CanvasRenderingContext2D::FillText(const std::string &text, float x, float y) {
-  // surface->getCanvas()->drawText(text.c_str(), text.length(), x, y - getFontBaseline(fillPaint, textBaseline, lineHeight), fillPaint);
-  surface->getCanvas()->drawText(text.c_str(), text.length(), x, y, fillPaint);
+  // DrawText(text, x, y - getFontBaseline(fillPaint, textBaseline, lineHeight), fillPaint);
+  DrawText(text, x, y, fillPaint);
 }
 
 void CanvasRenderingContext2D::StrokeText(const std::string &text, float x, float y) {
-  // surface->getCanvas()->drawText(text.c_str(), text.length(), x, y - getFontBaseline(strokePaint, textBaseline, lineHeight), strokePaint);
-  surface->getCanvas()->drawText(text.c_str(), text.length(), x, y, strokePaint);
+  // DrawText(text, x, y - getFontBaseline(strokePaint, textBaseline, lineHeight), strokePaint);
+  DrawText(text, x, y, strokePaint);
+}
+
+void CanvasRenderingContext2D::DrawText(const std::string &text, float x, float y, const SkPaint &paint) {
+  const TextRun &run = textCache.get(paint, text);
+  if (run.blob) {
+    // cached blobs are laid out left aligned
+    switch (paint.getTextAlign()) {
+      case SkPaint::kCenter_Align:
+        x -= run.advance / 2;
+        break;
+      case SkPaint::kRight_Align:
+        x -= run.advance;
+        break;
+      default:
+        break;
+    }
+    surface->getCanvas()->drawTextBlob(run.blob, x, y, paint);
+  }
 }
 
 bool CanvasRenderingContext2D::Resize(unsigned int w, unsigned int h) {
@@ -258,6 +271,7 @@ bool CanvasRenderingContext2D::Resize(unsigned int w, unsigned int h) {
 
   if (newSurface) {
     surface = newSurface;
+    externalMemory.Set((size_t)w * h * 4);
     // flipCanvasY(surface->getCanvas());
     return true;
   } else {
@@ -275,6 +289,7 @@ void CanvasRenderingContext2D::DrawImage(const SkImage *image, float sx, float s
   paint.setColor(0xFFFFFFFF);
   paint.setStyle(SkPaint::kFill_Style);
   paint.setBlendMode(SkBlendMode::kSrcOver);
+  paint.setImageFilter(fillPaint.refImageFilter());
   surface->getCanvas()->drawImageRect(image, SkRect::MakeXYWH(sx, sy, sw, sh), SkRect::MakeXYWH(dx, surface->getCanvas()->imageInfo().height() - dy - dh, dw, dh), &paint);
 
   if (flipY) {
@@ -290,6 +305,20 @@ void CanvasRenderingContext2D::Restore() {
   surface->getCanvas()->restore();
 }
 
+void CanvasRenderingContext2D::UpdateImageFilter() {
+  sk_sp<SkImageFilter> imageFilter;
+  if (filterBlur > 0) {
+    imageFilter = SkBlurImageFilter::Make(filterBlur, filterBlur, nullptr);
+  }
+  if (shadowColor.a != 0 && (shadowBlur > 0 || shadowOffsetX != 0 || shadowOffsetY != 0)) {
+    // the canvas spec defines the shadow blur sigma as half of shadowBlur
+    SkScalar sigma = shadowBlur / 2;
+    imageFilter = SkDropShadowImageFilter::Make(shadowOffsetX, shadowOffsetY, sigma, sigma, shadowColor.to_argb(), SkDropShadowImageFilter::kDrawShadowAndForeground_ShadowMode, std::move(imageFilter));
+  }
+  strokePaint.setImageFilter(imageFilter);
+  fillPaint.setImageFilter(std::move(imageFilter));
+}
+
 NAN_METHOD(CanvasRenderingContext2D::New) {
   // Nan::HandleScope scope;
 
@@ -320,6 +349,11 @@ NAN_METHOD(CanvasRenderingContext2D::New) {
       Nan::SetAccessor(ctxObj, JS_STR("textAlign"), TextAlignGetter, TextAlignSetter);
       Nan::SetAccessor(ctxObj, JS_STR("textBaseline"), TextBaselineGetter, TextBaselineSetter);
       Nan::SetAccessor(ctxObj, JS_STR("direction"), DirectionGetter, DirectionSetter);
+      Nan::SetAccessor(ctxObj, JS_STR("shadowBlur"), ShadowBlurGetter, ShadowBlurSetter);
+      Nan::SetAccessor(ctxObj, JS_STR("shadowColor"), ShadowColorGetter, ShadowColorSetter);
+      Nan::SetAccessor(ctxObj, JS_STR("shadowOffsetX"), ShadowOffsetXGetter, ShadowOffsetXSetter);
+      Nan::SetAccessor(ctxObj, JS_STR("shadowOffsetY"), ShadowOffsetYGetter, ShadowOffsetYSetter);
+      Nan::SetAccessor(ctxObj, JS_STR("filter"), FilterGetter, FilterSetter);
 
       info.GetReturnValue().Set(ctxObj);
     } else {
@@ -392,65 +426,74 @@ NAN_SETTER(CanvasRenderingContext2D::LineWidthSetter) {
   }
 }
 
-NAN_GETTER(CanvasRenderingContext2D::StrokeStyleGetter) {
-  // nothing
-}
-
-NAN_SETTER(CanvasRenderingContext2D::StrokeStyleSetter) {
-  // Nan::HandleScope scope;
-
+// Applies a CSS colour string, CanvasGradient or CanvasPattern to paint and remembers the value for the getter.
+// Colour strings are stored in their canonical serialized form.
+bool setPaintStyle(SkPaint &paint, Nan::Persistent<Value> &style, Local<Value> value) {
   if (value->IsString()) {
-    CanvasRenderingContext2D *context = ObjectWrap::Unwrap<CanvasRenderingContext2D>(info.This());
-
     v8::String::Utf8Value text(value);
-    std::string strokeStyle(*text, text.length());
+    canvas::web_color webColor = canvas::web_color::from_string(*text);
+    SkColor color = webColor.to_argb();
 
-    canvas::web_color webColor = canvas::web_color::from_string(strokeStyle.c_str());
-    context->strokePaint.setColor(((uint32_t)webColor.a << (8 * 3)) | ((uint32_t)webColor.r << (8 * 2)) | ((uint32_t)webColor.g << (8 * 1)) | ((uint32_t)webColor.b << (8 * 0)));
-    context->fillPaint.setShader(nullptr);
-  } else if (value->IsObject() && value->ToObject()->Get(JS_STR("constructor"))->ToObject()->Get(JS_STR("name"))->StrictEquals(JS_STR("CanvasGradient"))) {
-    CanvasRenderingContext2D *context = ObjectWrap::Unwrap<CanvasRenderingContext2D>(info.This());
+    if (!paint.getShader() && paint.getColor() == color && !style.IsEmpty()) {
+      return true;
+    }
 
+    paint.setColor(color);
+    paint.setShader(nullptr);
+    style.Reset(JS_STR(webColor.to_string()));
+    return true;
+  } else if (value->IsObject() && value->ToObject()->Get(JS_STR("constructor"))->ToObject()->Get(JS_STR("name"))->StrictEquals(JS_STR("CanvasGradient"))) {
     CanvasGradient *canvasGradient = ObjectWrap::Unwrap<CanvasGradient>(Local<Object>::Cast(value));
-    context->fillPaint.setShader(canvasGradient->getShader());
+    paint.setShader(canvasGradient->getShader());
+    style.Reset(value);
+    return true;
   } else if (value->IsObject() && value->ToObject()->Get(JS_STR("constructor"))->ToObject()->Get(JS_STR("name"))->StrictEquals(JS_STR("CanvasPattern"))) {
-    CanvasRenderingContext2D *context = ObjectWrap::Unwrap<CanvasRenderingContext2D>(info.This());
-
     CanvasPattern *canvasPattern = ObjectWrap::Unwrap<CanvasPattern>(Local<Object>::Cast(value));
-    context->fillPaint.setShader(canvasPattern->getShader());
+    paint.setShader(canvasPattern->getShader());
+    style.Reset(value);
+    return true;
   } else {
-    Nan::ThrowError("strokeStyle: invalid arguments");
+    return false;
   }
 }
 
-NAN_GETTER(CanvasRenderingContext2D::FillStyleGetter) {
-  // nothing
+NAN_GETTER(CanvasRenderingContext2D::StrokeStyleGetter) {
+  CanvasRenderingContext2D *context = ObjectWrap::Unwrap<CanvasRenderingContext2D>(info.This());
+
+  if (!context->strokeStyle.IsEmpty()) {
+    info.GetReturnValue().Set(Nan::New(context->strokeStyle));
+  } else {
+    info.GetReturnValue().Set(JS_STR("#000000"));
+  }
 }
 
-NAN_SETTER(CanvasRenderingContext2D::FillStyleSetter) {
+NAN_SETTER(CanvasRenderingContext2D::StrokeStyleSetter) {
   // Nan::HandleScope scope;
 
-  if (value->IsString()) {
-    CanvasRenderingContext2D *context = ObjectWrap::Unwrap<CanvasRenderingContext2D>(info.This());
-
-    v8::String::Utf8Value text(value);
-    std::string fillStyle(*text, text.length());
+  CanvasRenderingContext2D *context = ObjectWrap::Unwrap<CanvasRenderingContext2D>(info.This());
 
-    canvas::web_color webColor = canvas::web_color::from_string(fillStyle.c_str());
-    context->fillPaint.setColor(((uint32_t)webColor.a << (8 * 3)) | ((uint32_t)webColor.r << (8 * 2)) | ((uint32_t)webColor.g << (8 * 1)) | ((uint32_t)webColor.b << (8 * 0)));
-    context->fillPaint.setShader(nullptr);
-  } else if (value->IsObject() && value->ToObject()->Get(JS_STR("constructor"))->ToObject()->Get(JS_STR("name"))->StrictEquals(JS_STR("CanvasGradient"))) {
-    CanvasRenderingContext2D *context = ObjectWrap::Unwrap<CanvasRenderingContext2D>(info.This());
+  if (!setPaintStyle(context->strokePaint, context->strokeStyle, value)) {
+    Nan::ThrowError("strokeStyle: invalid arguments");
+  }
+}
 
-    CanvasGradient *canvasGradient = ObjectWrap::Unwrap<CanvasGradient>(Local<Object>::Cast(value));
-    context->fillPaint.setShader(canvasGradient->getShader());
-  } else if (value->IsObject() && value->ToObject()->Get(JS_STR("constructor"))->ToObject()->Get(JS_STR("name"))->StrictEquals(JS_STR("CanvasPattern"))) {
-    CanvasRenderingContext2D *context = ObjectWrap::Unwrap<CanvasRenderingContext2D>(info.This());
+NAN_GETTER(CanvasRenderingContext2D::FillStyleGetter) {
+  CanvasRenderingContext2D *context = ObjectWrap::Unwrap<CanvasRenderingContext2D>(info.This());
 
-    CanvasPattern *canvasPattern = ObjectWrap::Unwrap<CanvasPattern>(Local<Object>::Cast(value));
-    context->fillPaint.setShader(canvasPattern->getShader());
+  if (!context->fillStyle.IsEmpty()) {
+    info.GetReturnValue().Set(Nan::New(context->fillStyle));
   } else {
-     Nan::ThrowError("fillStyle: invalid arguments");
+    info.GetReturnValue().Set(JS_STR("#000000"));
+  }
+}
+
+NAN_SETTER(CanvasRenderingContext2D::FillStyleSetter) {
+  // Nan::HandleScope scope;
+
+  CanvasRenderingContext2D *context = ObjectWrap::Unwrap<CanvasRenderingContext2D>(info.This());
+
+  if (!setPaintStyle(context->fillPaint, context->fillStyle, value)) {
+    Nan::ThrowError("fillStyle: invalid arguments");
   }
 }
 
@@ -462,19 +505,27 @@ NAN_SETTER(CanvasRenderingContext2D::FontSetter) {
   // Nan::HandleScope scope;
 
   if (value->IsString()) {
-    Local<Object> contextObj = info.This();
+    CanvasRenderingContext2D *context = ObjectWrap::Unwrap<CanvasRenderingContext2D>(info.This());
 
     v8::String::Utf8Value text(value);
     std::string font(*text, text.length());
 
-    canvas::FontDeclaration declaration = canvas::parse_short_font(font);
+    if (context->fontInfo && context->fontInfo->font == font) {
+      return;
+    }
+
+    std::shared_ptr<const FontInfo> fontInfo = FontCache::getFont(font);
 
-    contextObj->Set(JS_STR("fontFamily"), JS_STR(declaration.fontFamily));
-    contextObj->Set(JS_STR("fontStyle"), JS_STR(declaration.fontStyle));
-    contextObj->Set(JS_STR("fontVariant"), JS_STR(declaration.fontVariant));
-    contextObj->Set(JS_STR("fontWeight"), JS_STR(declaration.fontWeight));
-    contextObj->Set(JS_STR("fontSize"), JS_STR(declaration.fontSize));
-    contextObj->Set(JS_STR("lineHeight"), JS_STR(declaration.lineHeight));
+    context->fontFamily = fontInfo->fontFamily;
+    context->fontStyle = fontInfo->fontStyle;
+    context->strokePaint.setTypeface(fontInfo->typeface);
+    context->fillPaint.setTypeface(fontInfo->typeface);
+    if (!std::isnan(fontInfo->textSize)) {
+      context->strokePaint.setTextSize(fontInfo->textSize);
+      context->fillPaint.setTextSize(fontInfo->textSize);
+    }
+    context->lineHeight = fontInfo->lineHeight;
+    context->fontInfo = std::move(fontInfo);
   } else {
     Nan::ThrowError("font: invalid arguments");
   }
@@ -493,10 +544,15 @@ NAN_SETTER(CanvasRenderingContext2D::FontFamilySetter) {
     v8::String::Utf8Value text(value);
     std::string fontFamily(*text, text.length());
 
-    SkTypeface *typeface = context->strokePaint.getTypeface();
-    SkFontStyle fontStyle = typeface ? typeface->fontStyle() : SkFontStyle();
-    context->strokePaint.setTypeface(SkTypeface::MakeFromName(fontFamily.c_str(), fontStyle));
-    context->fillPaint.setTypeface(SkTypeface::MakeFromName(fontFamily.c_str(), fontStyle));
+    context->fontInfo.reset();
+    if (fontFamily == context->fontFamily) {
+      return;
+    }
+
+    context->fontFamily = fontFamily;
+    sk_sp<SkTypeface> typeface = FontCache::getTypeface(context->fontFamily, context->fontStyle);
+    context->strokePaint.setTypeface(typeface);
+    context->fillPaint.setTypeface(typeface);
   } else {
     Nan::ThrowError("fontFamily: invalid arguments");
   }
@@ -514,6 +570,11 @@ NAN_SETTER(CanvasRenderingContext2D::FontSizeSetter) {
 
     double fontSize = value->NumberValue();
 
+    context->fontInfo.reset();
+    if ((SkScalar)fontSize == context->fillPaint.getTextSize()) {
+      return;
+    }
+
     context->strokePaint.setTextSize(fontSize);
     context->fillPaint.setTextSize(fontSize);
   } else {
@@ -532,31 +593,19 @@ NAN_SETTER(CanvasRenderingContext2D::FontWeightSetter) {
     CanvasRenderingContext2D *context = ObjectWrap::Unwrap<CanvasRenderingContext2D>(info.This());
 
     v8::String::Utf8Value text(value);
-    std::string fontStyleString(*text, text.length());
-
-    unsigned int fontWeight;
-    if (fontStyleString == "normal") {
-      fontWeight = 400;
-    } else if (fontStyleString == "bold") {
-      fontWeight = 700;
-    } else {
-      fontWeight = value->IsNumber() ? value->Uint32Value() : 400;
-    }
+    std::string fontWeightString(*text, text.length());
 
-    SkTypeface *typeface = context->strokePaint.getTypeface();
-    SkFontStyle oldFontStyle = typeface ? typeface->fontStyle() : SkFontStyle();
-    SkFontStyle fontStyle(fontWeight, oldFontStyle.width(), oldFontStyle.slant());
+    unsigned int fontWeight = FontCache::parseFontWeight(fontWeightString, SkFontStyle::kNormal_Weight);
 
-    const char *familyNameString;
-    if (typeface) {
-      SkString familyName;
-      typeface->getFamilyName(&familyName);
-      familyNameString = familyName.c_str();
-    } else {
-      familyNameString = nullptr;
+    context->fontInfo.reset();
+    if ((int)fontWeight == context->fontStyle.weight()) {
+      return;
     }
-    context->strokePaint.setTypeface(SkTypeface::MakeFromName(familyNameString, fontStyle));
-    context->fillPaint.setTypeface(SkTypeface::MakeFromName(familyNameString, fontStyle));
+
+    context->fontStyle = SkFontStyle(fontWeight, context->fontStyle.width(), context->fontStyle.slant());
+    sk_sp<SkTypeface> typeface = FontCache::getTypeface(context->fontFamily, context->fontStyle);
+    context->strokePaint.setTypeface(typeface);
+    context->fillPaint.setTypeface(typeface);
   } else {
     Nan::ThrowError("fontWeight: invalid arguments");
   }
@@ -574,6 +623,11 @@ NAN_SETTER(CanvasRenderingContext2D::LineHeightSetter) {
 
     double lineHeight = value->NumberValue();
 
+    context->fontInfo.reset();
+    if ((float)lineHeight == context->lineHeight) {
+      return;
+    }
+
     context->lineHeight = lineHeight;
   } else {
     Nan::ThrowError("lineHeight: invalid arguments");
@@ -592,31 +646,17 @@ NAN_SETTER(CanvasRenderingContext2D::FontStyleSetter) {
     v8::String::Utf8Value text(value);
     std::string fontStyleString(*text, text.length());
 
-    SkFontStyle::Slant slant;
-    if (fontStyleString == "normal") {
-      slant = SkFontStyle::Slant::kUpright_Slant;
-    } else if (fontStyleString == "italic") {
-      slant = SkFontStyle::Slant::kItalic_Slant;
-    } else if (fontStyleString == "oblique") {
-      slant = SkFontStyle::Slant::kOblique_Slant;
-    } else {
-      slant = SkFontStyle::Slant::kUpright_Slant;
-    }
-
-    SkTypeface *typeface = context->strokePaint.getTypeface();
-    SkFontStyle oldFontStyle = typeface ? typeface->fontStyle() : SkFontStyle();
-    SkFontStyle fontStyle(oldFontStyle.weight(), oldFontStyle.width(), slant);
+    SkFontStyle::Slant slant = FontCache::parseFontSlant(fontStyleString);
 
-    const char *familyNameString;
-    if (typeface) {
-      SkString familyName;
-      typeface->getFamilyName(&familyName);
-      familyNameString = familyName.c_str();
-    } else {
-      familyNameString = nullptr;
+    context->fontInfo.reset();
+    if (slant == context->fontStyle.slant()) {
+      return;
     }
-    context->strokePaint.setTypeface(SkTypeface::MakeFromName(familyNameString, fontStyle));
-    context->fillPaint.setTypeface(SkTypeface::MakeFromName(familyNameString, fontStyle));
+
+    context->fontStyle = SkFontStyle(context->fontStyle.weight(), context->fontStyle.width(), slant);
+    sk_sp<SkTypeface> typeface = FontCache::getTypeface(context->fontFamily, context->fontStyle);
+    context->strokePaint.setTypeface(typeface);
+    context->fillPaint.setTypeface(typeface);
   } else {
     Nan::ThrowError("fontStyle: invalid arguments");
   }
@@ -735,6 +775,125 @@ NAN_SETTER(CanvasRenderingContext2D::DirectionSetter) {
   }
 }
 
+NAN_GETTER(CanvasRenderingContext2D::ShadowBlurGetter) {
+  CanvasRenderingContext2D *context = ObjectWrap::Unwrap<CanvasRenderingContext2D>(info.This());
+  info.GetReturnValue().Set(JS_FLOAT(context->shadowBlur));
+}
+
+NAN_SETTER(CanvasRenderingContext2D::ShadowBlurSetter) {
+  // Nan::HandleScope scope;
+
+  if (value->IsNumber()) {
+    CanvasRenderingContext2D *context = ObjectWrap::Unwrap<CanvasRenderingContext2D>(info.This());
+
+    float shadowBlur = value->NumberValue();
+    if (shadowBlur >= 0 && shadowBlur != context->shadowBlur) {
+      context->shadowBlur = shadowBlur;
+      context->UpdateImageFilter();
+    }
+  } else {
+    Nan::ThrowError("shadowBlur: invalid arguments");
+  }
+}
+
+NAN_GETTER(CanvasRenderingContext2D::ShadowColorGetter) {
+  CanvasRenderingContext2D *context = ObjectWrap::Unwrap<CanvasRenderingContext2D>(info.This());
+  info.GetReturnValue().Set(JS_STR(context->shadowColor.to_string()));
+}
+
+NAN_SETTER(CanvasRenderingContext2D::ShadowColorSetter) {
+  // Nan::HandleScope scope;
+
+  if (value->IsString()) {
+    CanvasRenderingContext2D *context = ObjectWrap::Unwrap<CanvasRenderingContext2D>(info.This());
+
+    v8::String::Utf8Value text(value);
+    canvas::web_color shadowColor = canvas::web_color::from_string(*text);
+    if (!(shadowColor == context->shadowColor)) {
+      context->shadowColor = shadowColor;
+      context->UpdateImageFilter();
+    }
+  } else {
+    Nan::ThrowError("shadowColor: invalid arguments");
+  }
+}
+
+NAN_GETTER(CanvasRenderingContext2D::ShadowOffsetXGetter) {
+  CanvasRenderingContext2D *context = ObjectWrap::Unwrap<CanvasRenderingContext2D>(info.This());
+  info.GetReturnValue().Set(JS_FLOAT(context->shadowOffsetX));
+}
+
+NAN_SETTER(CanvasRenderingContext2D::ShadowOffsetXSetter) {
+  // Nan::HandleScope scope;
+
+  if (value->IsNumber()) {
+    CanvasRenderingContext2D *context = ObjectWrap::Unwrap<CanvasRenderingContext2D>(info.This());
+
+    float shadowOffsetX = value->NumberValue();
+    if (shadowOffsetX != context->shadowOffsetX) {
+      context->shadowOffsetX = shadowOffsetX;
+      context->UpdateImageFilter();
+    }
+  } else {
+    Nan::ThrowError("shadowOffsetX: invalid arguments");
+  }
+}
+
+NAN_GETTER(CanvasRenderingContext2D::ShadowOffsetYGetter) {
+  CanvasRenderingContext2D *context = ObjectWrap::Unwrap<CanvasRenderingContext2D>(info.This());
+  info.GetReturnValue().Set(JS_FLOAT(context->shadowOffsetY));
+}
+
+NAN_SETTER(CanvasRenderingContext2D::ShadowOffsetYSetter) {
+  // Nan::HandleScope scope;
+
+  if (value->IsNumber()) {
+    CanvasRenderingContext2D *context = ObjectWrap::Unwrap<CanvasRenderingContext2D>(info.This());
+
+    float shadowOffsetY = value->NumberValue();
+    if (shadowOffsetY != context->shadowOffsetY) {
+      context->shadowOffsetY = shadowOffsetY;
+      context->UpdateImageFilter();
+    }
+  } else {
+    Nan::ThrowError("shadowOffsetY: invalid arguments");
+  }
+}
+
+NAN_GETTER(CanvasRenderingContext2D::FilterGetter) {
+  CanvasRenderingContext2D *context = ObjectWrap::Unwrap<CanvasRenderingContext2D>(info.This());
+  info.GetReturnValue().Set(JS_STR(context->filter));
+}
+
+NAN_SETTER(CanvasRenderingContext2D::FilterSetter) {
+  // Nan::HandleScope scope;
+
+  if (value->IsString()) {
+    CanvasRenderingContext2D *context = ObjectWrap::Unwrap<CanvasRenderingContext2D>(info.This());
+
+    v8::String::Utf8Value text(value);
+    std::string filter(*text, text.length());
+    if (filter == context->filter) {
+      return;
+    }
+
+    // only blur(<length>px) is supported; other filter functions are ignored
+    float filterBlur = 0;
+    if (filter.compare(0, 5, "blur(") == 0) {
+      filterBlur = strtof(filter.c_str() + 5, nullptr);
+      if (!(filterBlur > 0)) {
+        filterBlur = 0;
+      }
+    }
+
+    context->filter = filter;
+    context->filterBlur = filterBlur;
+    context->UpdateImageFilter();
+  } else {
+    Nan::ThrowError("filter: invalid arguments");
+  }
+}
+
 NAN_METHOD(CanvasRenderingContext2D::Scale) {
   // Nan::HandleScope scope;
 
@@ -834,7 +993,7 @@ NAN_METHOD(CanvasRenderingContext2D::Stroke) {
 
   CanvasRenderingContext2D *context = ObjectWrap::Unwrap<CanvasRenderingContext2D>(info.This());
 
-  if (info[0]->BooleanValue() && info[0]->ToObject()->Get(JS_STR("constructor"))->ToObject()->Get(JS_STR("name"))->StrictEquals(JS_STR("Path2D"))) {
+  if (Path2D::IsPath2D(info[0])) {
     Path2D *path2d = ObjectWrap::Unwrap<Path2D>(Local<Object>::Cast(info[0]));
     context->Stroke(*path2d);
   } else {
@@ -849,7 +1008,7 @@ NAN_METHOD(CanvasRenderingContext2D::Fill) {
 
   CanvasRenderingContext2D *context = ObjectWrap::Unwrap<CanvasRenderingContext2D>(info.This());
 
-  if (info[0]->BooleanValue() && info[0]->ToObject()->Get(JS_STR("constructor"))->ToObject()->Get(JS_STR("name"))->StrictEquals(JS_STR("Path2D"))) {
+  if (Path2D::IsPath2D(info[0])) {
     Path2D *path2d = ObjectWrap::Unwrap<Path2D>(Local<Object>::Cast(info[0]));
     context->Fill(*path2d);
   } else {
@@ -1266,25 +1425,9 @@ NAN_METHOD(CanvasRenderingContext2D::ToDataURL) {
   // Nan::HandleScope scope;
 
   std::string type;
-  if (info[0]->IsString()) {
-    String::Utf8Value utf8Value(Local<String>::Cast(info[0]));
-    type = *utf8Value;
-  }
   SkEncodedImageFormat format;
-  if (type == "image/png") {
-    format = SkEncodedImageFormat::kPNG;
-  } else if (type == "image/jpeg") {
-    format = SkEncodedImageFormat::kJPEG;
-  } else {
-    type = "image/png";
-    format = SkEncodedImageFormat::kPNG;
-  }
-
-  int quality = 90;
-  if (info[1]->IsNumber()) {
-    double d = std::min<double>(std::max<double>(info[1]->NumberValue(), 0), 1);
-    quality = static_cast<int>(d * 100);
-  }
+  int quality;
+  ImageEncoder::ParseType(info[0], info[1], type, format, quality);
 
   CanvasRenderingContext2D *context = ObjectWrap::Unwrap<CanvasRenderingContext2D>(info.This());
   sk_sp<SkImage> image = getImageFromContext(context);
@@ -1305,6 +1448,25 @@ NAN_METHOD(CanvasRenderingContext2D::ToDataURL) {
   info.GetReturnValue().Set(result);
 }
 
+NAN_METHOD(CanvasRenderingContext2D::ToBlob) {
+  // Nan::HandleScope scope;
+
+  if (info[0]->IsFunction()) {
+    CanvasRenderingContext2D *context = ObjectWrap::Unwrap<CanvasRenderingContext2D>(info.This());
+
+    ImageEncodeJob *job = new ImageEncodeJob();
+    // copy-on-write: the surface only copies its pixels if it is drawn to before the encode finishes
+    job->image = context->surface->makeImageSnapshot();
+    job->flipY = false;
+    ImageEncoder::ParseType(info[1], info[2], job->type, job->format, job->quality);
+    job->cbFn.Reset(Local<Function>::Cast(info[0]));
+
+    ImageEncoder::Queue(job);
+  } else {
+    Nan::ThrowError("toBlob: invalid arguments");
+  }
+}
+
 NAN_METHOD(CanvasRenderingContext2D::Destroy) {
   // nothing
 }
@@ -1389,9 +1551,12 @@ sk_sp<SkImage> CanvasRenderingContext2D::getImage(Local<Value> arg) {
   }
 }
 
-CanvasRenderingContext2D::CanvasRenderingContext2D(unsigned int width, unsigned int height) {
+CanvasRenderingContext2D::CanvasRenderingContext2D(unsigned int width, unsigned int height) : externalMemory(externalmemory::EXTERNAL_MEMORY_CANVAS) {
   SkImageInfo info = SkImageInfo::Make(width, height, SkColorType::kRGBA_8888_SkColorType, SkAlphaType::kPremul_SkAlphaType);
   surface = SkSurface::MakeRaster(info); // XXX can optimize this to not allocate until a width/height is set
+  if (surface) {
+    externalMemory.Set((size_t)width * height * 4);
+  }
   // flipCanvasY(surface->getCanvas());
 
   strokePaint.setTextSize(12);
@@ -1408,6 +1573,44 @@ CanvasRenderingContext2D::CanvasRenderingContext2D(unsigned int width, unsigned
   clearPaint.setBlendMode(SkBlendMode::kSrc);
 
   lineHeight = 1;
+  shadowBlur = 0;
+  shadowColor = canvas::web_color(0, 0, 0, 0);
+  shadowOffsetX = 0;
+  shadowOffsetY = 0;
+  filter = "none";
+  filterBlur = 0;
+}
+
+CanvasRenderingContext2D::~CanvasRenderingContext2D () {
+  dataArray.Reset();
+  strokeStyle.Reset();
+  fillStyle.Reset();
+}
+
+namespace {
+  struct PixelsArrayBufferOwner {
+    Nan::Persistent<ArrayBuffer> arrayBuffer;
+    sk_sp<SkRefCnt> owner;
+  };
+
+  void PixelsArrayBufferWeakCallback(const Nan::WeakCallbackInfo<PixelsArrayBufferOwner> &data) {
+    PixelsArrayBufferOwner *arrayBufferOwner = data.GetParameter();
+    arrayBufferOwner->arrayBuffer.Reset();
+    delete arrayBufferOwner;
+  }
 }
 
-CanvasRenderingContext2D::~CanvasRenderingContext2D () {}
+Local<ArrayBuffer> makePixelsArrayBuffer(sk_sp<SkRefCnt> owner, void *data, size_t length) {
+  Local<ArrayBuffer> arrayBuffer = ArrayBuffer::New(Isolate::GetCurrent(), data, length);
+
+  PixelsArrayBufferOwner *arrayBufferOwner = new PixelsArrayBufferOwner();
+  arrayBufferOwner->arrayBuffer.Reset(arrayBuffer);
+  arrayBufferOwner->owner = std::move(owner);
+  arrayBufferOwner->arrayBuffer.SetWeak(arrayBufferOwner, PixelsArrayBufferWeakCallback, Nan::WeakCallbackType::kParameter);
+
+  return arrayBuffer;
+}
+
+void freePixels(void *addr, void *context) {
+  free(addr);
+}
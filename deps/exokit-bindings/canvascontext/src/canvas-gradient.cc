@@ -83,7 +83,7 @@ NAN_METHOD(CanvasGradient::AddColorStop) {
     v8::String::Utf8Value colorUtf8Value(Local<String>::Cast(info[1]));
     canvas::web_color webColor = canvas::web_color::from_string(*colorUtf8Value);
 
-    canvasGradient->AddColorStop(offset, ((uint32_t)webColor.a << (8 * 3)) | ((uint32_t)webColor.r << (8 * 2)) | ((uint32_t)webColor.g << (8 * 1)) | ((uint32_t)webColor.b << (8 * 0)));
+    canvasGradient->AddColorStop(offset, webColor.to_argb());
   } else {
     Nan::ThrowError("invalid arguments");
   }
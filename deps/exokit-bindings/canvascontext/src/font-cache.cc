@@ -0,0 +1,102 @@
+#include <canvascontext/include/font-cache.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+std::mutex FontCache::mutex;
+std::unordered_map<std::string, std::shared_ptr<const FontInfo>> FontCache::fonts;
+std::unordered_map<FontCache::TypefaceKey, sk_sp<SkTypeface>, FontCache::TypefaceKeyHash> FontCache::typefaces;
+
+namespace {
+
+// Matches how JS coerces the declaration strings to numbers: NaN unless the whole string is numeric.
+double parseNumber(const std::string &s) {
+  const char *start = s.c_str();
+  char *end;
+  double result = std::strtod(start, &end);
+  if (end == start || *end != '\0') {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  return result;
+}
+
+}
+
+size_t FontCache::TypefaceKeyHash::operator()(const TypefaceKey &key) const {
+  size_t h = std::hash<std::string>()(key.fontFamily);
+  h ^= std::hash<int>()((key.weight << 8) | (key.width << 4) | key.slant) + 0x9e3779b9 + (h << 6) + (h >> 2);
+  return h;
+}
+
+unsigned int FontCache::parseFontWeight(const std::string &fontWeight, unsigned int defaultWeight) {
+  if (fontWeight == "normal") {
+    return SkFontStyle::kNormal_Weight;
+  } else if (fontWeight == "bold") {
+    return SkFontStyle::kBold_Weight;
+  } else {
+    double weight = parseNumber(fontWeight);
+    return std::isnan(weight) ? defaultWeight : (unsigned int)weight;
+  }
+}
+
+SkFontStyle::Slant FontCache::parseFontSlant(const std::string &fontStyle) {
+  if (fontStyle == "italic") {
+    return SkFontStyle::Slant::kItalic_Slant;
+  } else if (fontStyle == "oblique") {
+    return SkFontStyle::Slant::kOblique_Slant;
+  } else {
+    return SkFontStyle::Slant::kUpright_Slant;
+  }
+}
+
+std::shared_ptr<const FontInfo> FontCache::getFont(const std::string &font) {
+  std::lock_guard<std::mutex> lock(mutex);
+
+  auto iter = fonts.find(font);
+  if (iter != fonts.end()) {
+    return iter->second;
+  }
+
+  if (fonts.size() >= maxEntries) {
+    fonts.clear();
+  }
+
+  std::shared_ptr<FontInfo> fontInfo = std::make_shared<FontInfo>();
+  fontInfo->font = font;
+  fontInfo->declaration = canvas::parse_short_font(font);
+  fontInfo->fontFamily = fontInfo->declaration.fontFamily;
+  fontInfo->fontStyle = SkFontStyle(
+    parseFontWeight(fontInfo->declaration.fontWeight, SkFontStyle::kNormal_Weight),
+    SkFontStyle::kNormal_Width,
+    parseFontSlant(fontInfo->declaration.fontStyle)
+  );
+  fontInfo->typeface = getTypefaceLocked(fontInfo->fontFamily, fontInfo->fontStyle);
+  fontInfo->textSize = parseNumber(fontInfo->declaration.fontSize);
+  fontInfo->lineHeight = parseNumber(fontInfo->declaration.lineHeight);
+
+  fonts.emplace(font, fontInfo);
+  return fontInfo;
+}
+
+sk_sp<SkTypeface> FontCache::getTypeface(const std::string &fontFamily, const SkFontStyle &fontStyle) {
+  std::lock_guard<std::mutex> lock(mutex);
+  return getTypefaceLocked(fontFamily, fontStyle);
+}
+
+sk_sp<SkTypeface> FontCache::getTypefaceLocked(const std::string &fontFamily, const SkFontStyle &fontStyle) {
+  TypefaceKey key{fontFamily, fontStyle.weight(), fontStyle.width(), fontStyle.slant()};
+
+  auto iter = typefaces.find(key);
+  if (iter != typefaces.end()) {
+    return iter->second;
+  }
+
+  if (typefaces.size() >= maxEntries) {
+    typefaces.clear();
+  }
+
+  sk_sp<SkTypeface> typeface = SkTypeface::MakeFromName(fontFamily.c_str(), fontStyle);
+  typefaces.emplace(std::move(key), typeface);
+  return typeface;
+}
@@ -1,4 +1,5 @@
 #include <canvascontext/include/image-context.h>
+#include <trace.h>
 
 using namespace v8;
 
@@ -54,6 +55,9 @@ void Image::RunInMainThread(uv_async_t *handle) {
   Image *image = (*iter).second;
   handleToImageMap.erase(iter);
 
+  // decoded pixels are only published here, on the main thread
+  image->externalMemory.Set(image->image ? (size_t)image->GetWidth() * image->GetHeight() * 4 : 0);
+
   Local<Object> asyncObject = Nan::New<Object>();
   AsyncResource asyncResource(Isolate::GetCurrent(), asyncObject, "imageLoad");
 
@@ -84,6 +88,7 @@ void Image::Load(Local<ArrayBuffer> arrayBuffer, size_t byteOffset, size_t byteL
     handleToImageMap[&threadAsync] = this;
 
     std::thread([this, buffer, byteLength]() -> void {
+      TRACE_SCOPE("image", "decode");
       sk_sp<SkData> data = SkData::MakeWithoutCopy(buffer, byteLength);
       SkBitmap bitmap;
       bool ok = DecodeDataToBitmap(data, &bitmap);
@@ -111,17 +116,14 @@ void Image::Load(Local<ArrayBuffer> arrayBuffer, size_t byteOffset, size_t byteL
             nsvgDeleteRasterizer(imageContextSvgRasterizer);
 
             SkImageInfo info = SkImageInfo::Make(w, h, SkColorType::kRGBA_8888_SkColorType, SkAlphaType::kPremul_SkAlphaType);
-            SkPixmap pixmap(info, address, w * 4);
 
             SkBitmap bitmap;
-            bool ok = bitmap.installPixels(pixmap);
+            bool ok = bitmap.installPixels(info, address, w * 4, freePixels, nullptr);
             if (ok) {
               bitmap.setImmutable();
               this->image = SkImage::MakeFromBitmap(bitmap);
             } else {
               this->error = "failed to install svg pixels";
-
-              free(address);
             }
           } else {
             this->error = "invalid svg parameters";
@@ -188,7 +190,7 @@ NAN_GETTER(Image::DataGetter) {
       if (ok) {
         unsigned int width = image->GetWidth();
         unsigned int height = image->GetHeight();
-        Local<ArrayBuffer> arrayBuffer = ArrayBuffer::New(Isolate::GetCurrent(), (void *)pixmap.addr(), width * height * 4); // XXX link lifetime
+        Local<ArrayBuffer> arrayBuffer = makePixelsArrayBuffer(image->image, (void *)pixmap.addr(), width * height * 4);
 
         Local<Uint8ClampedArray> uint8ClampedArray = Uint8ClampedArray::New(arrayBuffer, 0, arrayBuffer->ByteLength());
         image->dataArray.Reset(uint8ClampedArray);
@@ -230,5 +232,7 @@ NAN_METHOD(Image::LoadMethod) {
   }
 }
 
-Image::Image () {}
-Image::~Image () {}
+Image::Image () : externalMemory(externalmemory::EXTERNAL_MEMORY_IMAGE) {}
+Image::~Image () {
+  dataArray.Reset();
+}
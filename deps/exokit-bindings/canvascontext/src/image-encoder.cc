@@ -0,0 +1,174 @@
+#include <canvascontext/include/image-encoder.h>
+#include <trace.h>
+
+using namespace v8;
+
+namespace {
+  std::mutex pendingMutex;
+  std::condition_variable pendingCv;
+  std::deque<ImageEncodeJob *> pendingJobs;
+  std::mutex doneMutex;
+  std::deque<ImageEncodeJob *> doneJobs;
+  uv_async_t doneAsync;
+  bool initialized = false;
+  size_t numInFlight = 0;
+}
+
+void ImageEncoder::ParseType(Local<Value> typeValue, Local<Value> qualityValue, std::string &type, SkEncodedImageFormat &format, int &quality) {
+  if (typeValue->IsString()) {
+    String::Utf8Value utf8Value(Local<String>::Cast(typeValue));
+    type = *utf8Value;
+  }
+  if (type == "image/png") {
+    format = SkEncodedImageFormat::kPNG;
+  } else if (type == "image/jpeg") {
+    format = SkEncodedImageFormat::kJPEG;
+  } else {
+    type = "image/png";
+    format = SkEncodedImageFormat::kPNG;
+  }
+
+  quality = 90;
+  if (qualityValue->IsNumber()) {
+    double d = std::min<double>(std::max<double>(qualityValue->NumberValue(), 0), 1);
+    quality = static_cast<int>(d * 100);
+  }
+}
+
+void ImageEncoder::Queue(ImageEncodeJob *job) {
+  if (!initialized) {
+    uv_async_init(uv_default_loop(), &doneAsync, RunInMainThread);
+
+    unsigned int numThreads = std::max<unsigned int>(std::min<unsigned int>(std::thread::hardware_concurrency(), 2), 1);
+    for (unsigned int i = 0; i < numThreads; i++) {
+      std::thread(WorkerLoop).detach();
+    }
+
+    initialized = true;
+  }
+
+  // keep the loop alive only while encodes are in flight
+  if (numInFlight++ == 0) {
+    uv_ref((uv_handle_t *)&doneAsync);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    pendingJobs.push_back(job);
+  }
+  pendingCv.notify_one();
+}
+
+void ImageEncoder::WorkerLoop() {
+  SkDynamicMemoryWStream stream;
+  std::vector<unsigned char> flipBuffer;
+
+  for (;;) {
+    ImageEncodeJob *job;
+    {
+      std::unique_lock<std::mutex> lock(pendingMutex);
+      pendingCv.wait(lock, []() -> bool { return !pendingJobs.empty(); });
+      job = pendingJobs.front();
+      pendingJobs.pop_front();
+    }
+
+    TRACE_SCOPE("image", "encode");
+    SkPixmap pixmap;
+    bool ok;
+    if (job->image) {
+      ok = job->image->peekPixels(&pixmap);
+    } else {
+      pixmap = job->pixmap;
+      ok = pixmap.addr() != nullptr;
+    }
+
+    if (ok && job->flipY) {
+      size_t rowBytes = pixmap.rowBytes();
+      flipBuffer.resize(rowBytes * pixmap.height());
+      for (int y = 0; y < pixmap.height(); y++) {
+        memcpy(flipBuffer.data() + (pixmap.height() - 1 - y) * rowBytes, pixmap.addr8(0, y), rowBytes);
+      }
+      pixmap = SkPixmap(pixmap.info(), flipBuffer.data(), rowBytes);
+    }
+
+    if (ok && SkEncodeImage(&stream, pixmap, job->format, job->quality)) {
+      job->result = stream.detachAsData();
+    } else {
+      stream.reset();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(doneMutex);
+      doneJobs.push_back(job);
+    }
+    uv_async_send(&doneAsync);
+  }
+}
+
+void ImageEncoder::RunInMainThread(uv_async_t *handle) {
+  Nan::HandleScope scope;
+
+  std::deque<ImageEncodeJob *> jobs;
+  {
+    std::lock_guard<std::mutex> lock(doneMutex);
+    jobs.swap(doneJobs);
+  }
+
+  for (ImageEncodeJob *job : jobs) {
+    Local<Object> asyncObject = Nan::New<Object>();
+    AsyncResource asyncResource(Isolate::GetCurrent(), asyncObject, "imageEncode");
+
+    Local<Value> argv[3];
+    if (job->result) {
+      Local<ArrayBuffer> arrayBuffer = ArrayBuffer::New(Isolate::GetCurrent(), job->result->size());
+      memcpy(arrayBuffer->GetContents().Data(), job->result->data(), job->result->size());
+
+      argv[0] = Nan::Null();
+      argv[1] = arrayBuffer;
+      argv[2] = JS_STR(job->type);
+    } else {
+      argv[0] = JS_STR("failed to encode image");
+      argv[1] = Nan::Null();
+      argv[2] = JS_STR(job->type);
+    }
+
+    Local<Function> cbFn = Nan::New(job->cbFn);
+    job->cbFn.Reset();
+    job->arrayBuffer.Reset();
+    delete job;
+
+    if (--numInFlight == 0) {
+      uv_unref((uv_handle_t *)&doneAsync);
+    }
+
+    asyncResource.MakeCallback(cbFn, sizeof(argv)/sizeof(argv[0]), argv);
+  }
+}
+
+NAN_METHOD(ImageEncoder::EncodePixels) {
+  // Nan::HandleScope scope;
+
+  if (info[0]->IsArrayBufferView() && info[1]->IsNumber() && info[2]->IsNumber() && info[6]->IsFunction()) {
+    Local<ArrayBufferView> arrayBufferView = Local<ArrayBufferView>::Cast(info[0]);
+    unsigned int width = info[1]->Uint32Value();
+    unsigned int height = info[2]->Uint32Value();
+
+    if (arrayBufferView->ByteLength() >= width * height * 4) {
+      Local<ArrayBuffer> arrayBuffer = arrayBufferView->Buffer();
+      unsigned char *data = (unsigned char *)arrayBuffer->GetContents().Data() + arrayBufferView->ByteOffset();
+
+      ImageEncodeJob *job = new ImageEncodeJob();
+      job->pixmap = SkPixmap(SkImageInfo::Make(width, height, SkColorType::kRGBA_8888_SkColorType, SkAlphaType::kUnpremul_SkAlphaType), data, width * 4);
+      job->flipY = info[3]->BooleanValue();
+      ParseType(info[4], info[5], job->type, job->format, job->quality);
+      job->arrayBuffer.Reset(arrayBuffer);
+      job->cbFn.Reset(Local<Function>::Cast(info[6]));
+
+      Queue(job);
+    } else {
+      Nan::ThrowError("encodePixels: buffer too small");
+    }
+  } else {
+    Nan::ThrowError("encodePixels: invalid arguments");
+  }
+}
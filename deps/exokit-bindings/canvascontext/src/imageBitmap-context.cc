@@ -78,13 +78,11 @@ NAN_METHOD(ImageBitmap::New) {
       }
 
       SkBitmap bitmap;
-      bool ok = bitmap.installPixels(pixmap);
+      bool ok = bitmap.installPixels(info, address, width * 4, freePixels, nullptr);
       if (ok) {
         ImageBitmap *imageBitmap = new ImageBitmap(bitmap);
         imageBitmap->Wrap(imageBitmapObj);
       } else {
-        free(address);
-
         return Nan::ThrowError("Failed to install pixels");
       }
     } else {
@@ -106,13 +104,11 @@ NAN_METHOD(ImageBitmap::New) {
       SkPixmap pixmap(info, address, width * 4);
 
       SkBitmap bitmap;
-      bool ok = bitmap.installPixels(pixmap);
+      bool ok = bitmap.installPixels(info, address, width * 4, freePixels, nullptr);
       if (ok) {
         ImageBitmap *imageBitmap = new ImageBitmap(bitmap);
         imageBitmap->Wrap(imageBitmapObj);
       } else {
-        free(address);
-
         return Nan::ThrowError("Failed to install pixels");
       }
     } else {
@@ -152,7 +148,7 @@ NAN_GETTER(ImageBitmap::DataGetter) {
     if (ok) {
       unsigned int width = imageBitmap->GetWidth();
       unsigned int height = imageBitmap->GetHeight();
-      Local<ArrayBuffer> arrayBuffer = ArrayBuffer::New(Isolate::GetCurrent(), (void *)pixmap.addr(), width * height * 4); // XXX link lifetime
+      Local<ArrayBuffer> arrayBuffer = makePixelsArrayBuffer(sk_ref_sp<SkRefCnt>(imageBitmap->bitmap.pixelRef()), (void *)pixmap.addr(), width * height * 4);
 
       Local<Uint8ClampedArray> uint8ClampedArray = Uint8ClampedArray::New(arrayBuffer, 0, arrayBuffer->ByteLength());
       imageBitmap->dataArray.Reset(uint8ClampedArray);
@@ -164,13 +160,16 @@ NAN_GETTER(ImageBitmap::DataGetter) {
   info.GetReturnValue().Set(Nan::New(imageBitmap->dataArray));
 }
 
-ImageBitmap::ImageBitmap() {}
+ImageBitmap::ImageBitmap() : externalMemory(externalmemory::EXTERNAL_MEMORY_IMAGE_BITMAP) {}
 /* ImageBitmap::ImageBitmap(unsigned int width, unsigned int height, unsigned char *data) {
   this->bitmap = bitmap;
 }
 ImageBitmap::ImageBitmap(Image *image, int x, int y, unsigned int width, unsigned int height, bool flipY) :
   imageData(image->image->getData().crop(x, y, width, height, flipY).release()) {} */
-ImageBitmap::ImageBitmap(const SkBitmap &bitmap) {
+ImageBitmap::ImageBitmap(const SkBitmap &bitmap) : externalMemory(externalmemory::EXTERNAL_MEMORY_IMAGE_BITMAP) {
   this->bitmap = bitmap;
+  externalMemory.Set((size_t)bitmap.width() * bitmap.height() * 4);
+}
+ImageBitmap::~ImageBitmap () {
+  dataArray.Reset();
 }
-ImageBitmap::~ImageBitmap () {}
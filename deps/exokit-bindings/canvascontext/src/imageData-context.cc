@@ -14,7 +14,12 @@ Handle<Object> ImageData::Initialize(Isolate *isolate) {
   // prototype
   Local<ObjectTemplate> proto = ctor->PrototypeTemplate();
 
-  return scope.Escape(ctor->GetFunction());
+  Local<Function> ctorFn = ctor->GetFunction();
+  Nan::SetMethod(ctorFn, "blurPixels", BlurPixels);
+  Nan::SetMethod(ctorFn, "colorizePixels", ColorizePixels);
+  Nan::SetMethod(ctorFn, "setSimd", SetSimd);
+
+  return scope.Escape(ctorFn);
 }
 
 unsigned int ImageData::GetWidth() {
@@ -79,6 +84,55 @@ NAN_GETTER(ImageData::WidthGetter) {
   info.GetReturnValue().Set(JS_INT(imageData->GetWidth()));
 }
 
+// blurPixels(pixels, width, height, numChannels, hradius, vradius): blurs the caller's pixels in place
+NAN_METHOD(ImageData::BlurPixels) {
+  if (info[0]->IsArrayBufferView() && info[1]->IsNumber() && info[2]->IsNumber() && info[3]->IsNumber() && info[4]->IsNumber() && info[5]->IsNumber()) {
+    Local<ArrayBufferView> array = Local<ArrayBufferView>::Cast(info[0]);
+    unsigned int width = info[1]->Uint32Value();
+    unsigned int height = info[2]->Uint32Value();
+    unsigned int numChannels = info[3]->Uint32Value();
+    float hradius = info[4]->NumberValue();
+    float vradius = info[5]->NumberValue();
+
+    size_t size = (size_t)width * height * numChannels;
+    if (array->ByteLength() >= size) {
+      unsigned char *data = (unsigned char *)array->Buffer()->GetContents().Data() + array->ByteOffset();
+      canvas::ImageData::blurPixels(data, width, height, numChannels, hradius, vradius);
+    } else {
+      Nan::ThrowError("blurPixels: invalid array length");
+    }
+  } else {
+    Nan::ThrowError("blurPixels: invalid arguments");
+  }
+}
+
+// colorizePixels(alpha, width, height, color, result): tints a single channel image into RGBA pixels
+NAN_METHOD(ImageData::ColorizePixels) {
+  if (info[0]->IsArrayBufferView() && info[1]->IsNumber() && info[2]->IsNumber() && info[3]->IsString() && info[4]->IsArrayBufferView()) {
+    Local<ArrayBufferView> array = Local<ArrayBufferView>::Cast(info[0]);
+    unsigned int width = info[1]->Uint32Value();
+    unsigned int height = info[2]->Uint32Value();
+    v8::String::Utf8Value colorValue(info[3]);
+    Local<ArrayBufferView> resultArray = Local<ArrayBufferView>::Cast(info[4]);
+
+    size_t count = (size_t)width * height;
+    if (array->ByteLength() >= count && resultArray->ByteLength() >= count * 4) {
+      unsigned char *data = (unsigned char *)array->Buffer()->GetContents().Data() + array->ByteOffset();
+      unsigned char *result = (unsigned char *)resultArray->Buffer()->GetContents().Data() + resultArray->ByteOffset();
+      canvas::web_color webColor = canvas::web_color::from_string(*colorValue);
+      canvas::ImageData::colorizePixels(data, result, count, canvas::Color(webColor.r / 255.0f, webColor.g / 255.0f, webColor.b / 255.0f, webColor.a / 255.0f));
+    } else {
+      Nan::ThrowError("colorizePixels: invalid array length");
+    }
+  } else {
+    Nan::ThrowError("colorizePixels: invalid arguments");
+  }
+}
+
+NAN_METHOD(ImageData::SetSimd) {
+  canvas::ImageData::setSimd(info[0]->BooleanValue());
+}
+
 NAN_GETTER(ImageData::HeightGetter) {
   Nan::HandleScope scope;
 
@@ -97,7 +151,7 @@ NAN_GETTER(ImageData::DataGetter) {
     if (ok) {
       unsigned int width = imageData->GetWidth();
       unsigned int height = imageData->GetHeight();
-      Local<ArrayBuffer> arrayBuffer = ArrayBuffer::New(Isolate::GetCurrent(), (void *)pixmap.addr(), width * height * 4); // XXX link lifetime
+      Local<ArrayBuffer> arrayBuffer = makePixelsArrayBuffer(sk_ref_sp<SkRefCnt>(imageData->bitmap.pixelRef()), (void *)pixmap.addr(), width * height * 4);
 
       Local<Uint8ClampedArray> uint8ClampedArray = Uint8ClampedArray::New(arrayBuffer, 0, arrayBuffer->ByteLength());
       imageData->dataArray.Reset(uint8ClampedArray);
@@ -109,17 +163,21 @@ NAN_GETTER(ImageData::DataGetter) {
   info.GetReturnValue().Set(Nan::New(imageData->dataArray));
 }
 
-ImageData::ImageData(unsigned int width, unsigned int height) {
+ImageData::ImageData(unsigned int width, unsigned int height) : externalMemory(externalmemory::EXTERNAL_MEMORY_IMAGE_DATA) {
   SkImageInfo info = SkImageInfo::Make(width, height, SkColorType::kRGBA_8888_SkColorType, SkAlphaType::kPremul_SkAlphaType);
   unsigned char *address = (unsigned char *)malloc(width * height * 4);
-  SkPixmap pixmap(info, address, width * 4);
-  bitmap.installPixels(pixmap);
+  if (bitmap.installPixels(info, address, width * 4, freePixels, nullptr)) {
+    externalMemory.Set((size_t)width * height * 4);
+  }
 }
-ImageData::ImageData(const char *data, unsigned int width, unsigned int height) {
+ImageData::ImageData(const char *data, unsigned int width, unsigned int height) : externalMemory(externalmemory::EXTERNAL_MEMORY_IMAGE_DATA) {
   SkImageInfo info = SkImageInfo::Make(width, height, SkColorType::kBGRA_8888_SkColorType, SkAlphaType::kPremul_SkAlphaType);
   unsigned char *address = (unsigned char *)malloc(width * height * 4);
   memcpy(address, data, width * height * 4);
-  SkPixmap pixmap(info, address, width * 4);
-  bitmap.installPixels(pixmap);
+  if (bitmap.installPixels(info, address, width * 4, freePixels, nullptr)) {
+    externalMemory.Set((size_t)width * height * 4);
+  }
+}
+ImageData::~ImageData () {
+  dataArray.Reset();
 }
-ImageData::~ImageData () {}
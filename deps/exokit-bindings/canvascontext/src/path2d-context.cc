@@ -4,6 +4,36 @@ using namespace v8;
 using namespace node;
 // using namespace std;
 
+Nan::Persistent<FunctionTemplate> Path2D::path2dTemplate;
+
+void addCanvasArc(SkPath &path, float x, float y, float radius, float startAngle, float endAngle, bool anticlockwise) {
+  const float twoPi = 2 * M_PI;
+  float sweepAngle;
+  if (!anticlockwise && endAngle - startAngle >= twoPi) {
+    sweepAngle = twoPi;
+  } else if (anticlockwise && startAngle - endAngle >= twoPi) {
+    sweepAngle = -twoPi;
+  } else {
+    sweepAngle = std::fmod(endAngle - startAngle, twoPi);
+    if (!anticlockwise && sweepAngle < 0) {
+      sweepAngle += twoPi;
+    } else if (anticlockwise && sweepAngle > 0) {
+      sweepAngle -= twoPi;
+    }
+  }
+
+  const SkRect oval = SkRect::MakeLTRB(x - radius, y - radius, x + radius, y + radius);
+  const float startDegrees = SkRadiansToDegrees(startAngle);
+  const float sweepDegrees = SkRadiansToDegrees(sweepAngle);
+  if (std::abs(sweepDegrees) >= 360) {
+    // SkPath::arcTo treats a full turn as empty, so draw it as two halves
+    path.arcTo(oval, startDegrees, sweepDegrees / 2, false);
+    path.arcTo(oval, startDegrees + sweepDegrees / 2, sweepDegrees / 2, false);
+  } else {
+    path.arcTo(oval, startDegrees, sweepDegrees, false);
+  }
+}
+
 Handle<Object> Path2D::Initialize(Isolate *isolate) {
   Nan::EscapableHandleScope scope;
 
@@ -11,6 +41,7 @@ Handle<Object> Path2D::Initialize(Isolate *isolate) {
   Local<FunctionTemplate> ctor = Nan::New<FunctionTemplate>(New);
   ctor->InstanceTemplate()->SetInternalFieldCount(1);
   ctor->SetClassName(JS_STR("Path2D"));
+  path2dTemplate.Reset(ctor);
 
   // prototype
   Local<ObjectTemplate> proto = ctor->PrototypeTemplate();
@@ -21,11 +52,20 @@ Handle<Object> Path2D::Initialize(Isolate *isolate) {
   Nan::SetMethod(proto,"arc", Arc);
   Nan::SetMethod(proto,"arcTo", ArcTo);
   Nan::SetMethod(proto,"quadraticCurveTo", QuadraticCurveTo);
+  Nan::SetMethod(proto,"bezierCurveTo", BezierCurveTo);
+  Nan::SetMethod(proto,"rect", Rect);
+  Nan::SetMethod(proto,"addPath", AddPath);
   Nan::SetMethod(proto,"clear", Clear);
+  Nan::SetMethod(proto,"getBounds", GetBounds);
+  Nan::SetMethod(proto,"getGenerationId", GetGenerationID);
 
   return scope.Escape(ctor->GetFunction());
 }
 
+bool Path2D::IsPath2D(Local<Value> value) {
+  return value->IsObject() && Nan::New(path2dTemplate)->HasInstance(value);
+}
+
 void Path2D::MoveTo(float x, float y) {
   path.moveTo(x, y);
 }
@@ -36,27 +76,45 @@ void Path2D::ClosePath() {
   path.close();
 }
 void Path2D::Arc(float x, float y, float radius, float startAngle, float endAngle, float anticlockwise) {
-  if (anticlockwise) {
-    float temp = startAngle;
-    startAngle = endAngle;
-    endAngle = temp;
-  }
-  path.addArc(SkRect::MakeLTRB(x - radius/2, y - radius/2, x + radius/2, y + radius/2), startAngle, endAngle);
+  addCanvasArc(path, x, y, radius, startAngle, endAngle, anticlockwise);
 }
 void Path2D::ArcTo(float x1, float y1, float x2, float y2, float radius) {
-  path.arcTo(x1, y1, x2 - x1, y2 - y1, radius);
+  path.arcTo(x1, y1, x2, y2, radius);
 }
 void Path2D::QuadraticCurveTo(float cpx, float cpy, float x, float y) {
   path.quadTo(cpx, cpy, x, y);
 }
+void Path2D::BezierCurveTo(float cp1x, float cp1y, float cp2x, float cp2y, float x, float y) {
+  path.cubicTo(cp1x, cp1y, cp2x, cp2y, x, y);
+}
+void Path2D::Rect(float x, float y, float w, float h) {
+  path.addRect(SkRect::MakeXYWH(x, y, w, h));
+}
+void Path2D::AddPath(const Path2D &other) {
+  path.addPath(other.path);
+}
 void Path2D::Clear() {
   path.reset();
 }
+const SkRect &Path2D::GetBounds() {
+  uint32_t generationID = path.getGenerationID();
+  if (generationID != boundsGenerationID) {
+    bounds = path.computeTightBounds();
+    boundsGenerationID = generationID;
+  }
+  return bounds;
+}
+uint32_t Path2D::GetGenerationID() const {
+  return path.getGenerationID();
+}
 
 NAN_METHOD(Path2D::New) {
   Nan::HandleScope scope;
 
   Path2D *path2d = new Path2D();
+  if (IsPath2D(info[0])) {
+    path2d->path = ObjectWrap::Unwrap<Path2D>(Local<Object>::Cast(info[0]))->path;
+  }
   path2d->Wrap(info.This());
   // registerImage(image);
   info.GetReturnValue().Set(info.This());
@@ -129,6 +187,66 @@ NAN_METHOD(Path2D::QuadraticCurveTo) {
   path2d->QuadraticCurveTo(cpx, cpy, x, y);
 }
 
+NAN_METHOD(Path2D::BezierCurveTo) {
+  Nan::HandleScope scope;
+
+  Path2D *path2d = ObjectWrap::Unwrap<Path2D>(info.This());
+  double cp1x = info[0]->NumberValue();
+  double cp1y = info[1]->NumberValue();
+  double cp2x = info[2]->NumberValue();
+  double cp2y = info[3]->NumberValue();
+  double x = info[4]->NumberValue();
+  double y = info[5]->NumberValue();
+
+  path2d->BezierCurveTo(cp1x, cp1y, cp2x, cp2y, x, y);
+}
+
+NAN_METHOD(Path2D::Rect) {
+  Nan::HandleScope scope;
+
+  Path2D *path2d = ObjectWrap::Unwrap<Path2D>(info.This());
+  double x = info[0]->NumberValue();
+  double y = info[1]->NumberValue();
+  double w = info[2]->NumberValue();
+  double h = info[3]->NumberValue();
+
+  path2d->Rect(x, y, w, h);
+}
+
+NAN_METHOD(Path2D::AddPath) {
+  Nan::HandleScope scope;
+
+  if (IsPath2D(info[0])) {
+    Path2D *path2d = ObjectWrap::Unwrap<Path2D>(info.This());
+    Path2D *other = ObjectWrap::Unwrap<Path2D>(Local<Object>::Cast(info[0]));
+
+    path2d->AddPath(*other);
+  } else {
+    Nan::ThrowError("addPath: invalid arguments");
+  }
+}
+
+NAN_METHOD(Path2D::GetBounds) {
+  Nan::HandleScope scope;
+
+  Path2D *path2d = ObjectWrap::Unwrap<Path2D>(info.This());
+  const SkRect &bounds = path2d->GetBounds();
+
+  Local<Object> result = Nan::New<Object>();
+  result->Set(JS_STR("x"), JS_FLOAT(bounds.x()));
+  result->Set(JS_STR("y"), JS_FLOAT(bounds.y()));
+  result->Set(JS_STR("width"), JS_FLOAT(bounds.width()));
+  result->Set(JS_STR("height"), JS_FLOAT(bounds.height()));
+  info.GetReturnValue().Set(result);
+}
+
+NAN_METHOD(Path2D::GetGenerationID) {
+  Nan::HandleScope scope;
+
+  Path2D *path2d = ObjectWrap::Unwrap<Path2D>(info.This());
+  info.GetReturnValue().Set(JS_INT(path2d->GetGenerationID()));
+}
+
 NAN_METHOD(Path2D::Clear) {
   Nan::HandleScope scope;
 
@@ -137,5 +255,5 @@ NAN_METHOD(Path2D::Clear) {
   path2d->Clear();
 }
 
-Path2D::Path2D() {}
+Path2D::Path2D() : bounds(SkRect::MakeEmpty()), boundsGenerationID(0) {}
 Path2D::~Path2D () {}
@@ -0,0 +1,50 @@
+#include <canvascontext/include/text-cache.h>
+
+size_t TextCache::KeyHash::operator()(const Key &key) const {
+  size_t h = std::hash<std::string>()(key.text);
+  h ^= std::hash<uint32_t>()(key.typefaceId) + 0x9e3779b9 + (h << 6) + (h >> 2);
+  h ^= std::hash<float>()(key.textSize) + 0x9e3779b9 + (h << 6) + (h >> 2);
+  return h;
+}
+
+TextCache::TextCache(size_t maxEntries) : maxEntries(maxEntries) {}
+
+const TextRun &TextCache::get(const SkPaint &paint, const std::string &text) {
+  SkTypeface *typeface = paint.getTypeface();
+  Key key{typeface ? typeface->uniqueID() : 0, paint.getTextSize(), text};
+
+  auto iter = entries.find(key);
+  if (iter != entries.end()) {
+    return iter->second;
+  }
+
+  if (entries.size() >= maxEntries) {
+    entries.clear();
+  }
+
+  SkPaint textPaint(paint);
+  textPaint.setTextEncoding(SkPaint::kUTF8_TextEncoding);
+  textPaint.setTextAlign(SkPaint::kLeft_Align);
+
+  TextRun run;
+  SkRect bounds;
+  run.advance = textPaint.measureText(text.c_str(), text.length(), &bounds);
+  run.width = bounds.width();
+
+  int numGlyphs = textPaint.textToGlyphs(text.c_str(), text.length(), nullptr);
+  if (numGlyphs > 0) {
+    SkPaint glyphPaint(textPaint);
+    glyphPaint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+
+    SkTextBlobBuilder builder;
+    const SkTextBlobBuilder::RunBuffer &runBuffer = builder.allocRun(glyphPaint, numGlyphs, 0, 0);
+    textPaint.textToGlyphs(text.c_str(), text.length(), runBuffer.glyphs);
+    run.blob = builder.make();
+  }
+
+  return entries.emplace(std::move(key), std::move(run)).first->second;
+}
+
+void TextCache::clear() {
+  entries.clear();
+}
@@ -1,6 +1,7 @@
 #include <glfw/include/glfw.h>
 #include <windowsystem.h>
 #include <webgl.h>
+#include <webglcontext/include/gpu-profiler.h>
 
 namespace glfw {
 
@@ -103,6 +104,96 @@ void NAN_INLINE(CallEmitter(int argc, Local<Value> argv[])) {
   }
 }
 
+// Input event ring: when JS registers a Float64Array with setEventRing, key, mouse and wheel
+// callbacks write fixed-layout records into it instead of allocating an event object each.
+// Layout: [writeIndex, readIndex] followed by EVENT_RING_RECORD_SIZE doubles per record:
+// [type, windowHandle[0], windowHandle[1], a, b, c, d, mods]. JS decodes the ring once per frame.
+#define EVENT_RING_HEADER_SIZE 2
+#define EVENT_RING_RECORD_SIZE 8
+enum EventRingType {
+  EVENT_RING_KEYUP = 1,
+  EVENT_RING_KEYDOWN = 2,
+  EVENT_RING_KEYPRESS = 3,
+  EVENT_RING_MOUSEMOVE = 4,
+  EVENT_RING_MOUSEDOWN = 5,
+  EVENT_RING_MOUSEUP = 6,
+  EVENT_RING_CLICK = 7,
+  EVENT_RING_WHEEL = 8,
+};
+Nan::Persistent<Float64Array> eventRingArray;
+Nan::Persistent<Function> eventRingDrainFn;
+double *eventRing = nullptr;
+size_t eventRingCapacity = 0;
+// records that arrived while the ring stayed full; they are written here and discarded, never emitted out of order
+double eventRingOverflowRecord[EVENT_RING_RECORD_SIZE];
+uint32_t eventRingDropped = 0;
+
+// Returns the record to fill, or nullptr if the ring is disabled, in which case the caller
+// falls back to emitting an event object. A full ring is first handed to the drain callback.
+double *pushEventRecord(NATIVEwindow *window, EventRingType type) {
+  if (eventRing) {
+    size_t writeIndex = (size_t)eventRing[0];
+    size_t readIndex = (size_t)eventRing[1];
+    if (writeIndex - readIndex >= eventRingCapacity && !eventRingDrainFn.IsEmpty()) {
+      Nan::HandleScope scope;
+
+      Local<Function> drainFn = Nan::New(eventRingDrainFn);
+      drainFn->Call(Nan::Null(), 0, nullptr);
+      if (!eventRing) {
+        return nullptr;
+      }
+      writeIndex = (size_t)eventRing[0];
+      readIndex = (size_t)eventRing[1];
+    }
+    if (writeIndex - readIndex < eventRingCapacity) {
+      double *record = eventRing + EVENT_RING_HEADER_SIZE + (writeIndex % eventRingCapacity) * EVENT_RING_RECORD_SIZE;
+      uintptr_t n = (uintptr_t)window;
+      record[0] = type;
+      record[1] = (uint32_t)(n >> 32);
+      record[2] = (uint32_t)(n & 0xFFFFFFFF);
+      eventRing[0] = (double)(writeIndex + 1);
+      return record;
+    } else {
+      eventRingDropped++;
+      return eventRingOverflowRecord;
+    }
+  }
+  return nullptr;
+}
+
+// Unread mousemoves for the same window are merged, as browsers do per animation frame.
+double *lastUnreadMouseMoveRecord(NATIVEwindow *window) {
+  if (eventRing) {
+    size_t writeIndex = (size_t)eventRing[0];
+    size_t readIndex = (size_t)eventRing[1];
+    if (writeIndex > readIndex) {
+      double *record = eventRing + EVENT_RING_HEADER_SIZE + ((writeIndex - 1) % eventRingCapacity) * EVENT_RING_RECORD_SIZE;
+      uintptr_t n = (uintptr_t)window;
+      if (record[0] == EVENT_RING_MOUSEMOVE && record[1] == (uint32_t)(n >> 32) && record[2] == (uint32_t)(n & 0xFFFFFFFF)) {
+        return record;
+      }
+    }
+  }
+  return nullptr;
+}
+
+int getMods(NATIVEwindow *window) {
+  int mods = 0;
+  if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_RIGHT_SHIFT) == GLFW_PRESS) {
+    mods |= GLFW_MOD_SHIFT;
+  }
+  if (glfwGetKey(window, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_RIGHT_CONTROL) == GLFW_PRESS) {
+    mods |= GLFW_MOD_CONTROL;
+  }
+  if (glfwGetKey(window, GLFW_KEY_LEFT_ALT) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_RIGHT_ALT) == GLFW_PRESS) {
+    mods |= GLFW_MOD_ALT;
+  }
+  if (glfwGetKey(window, GLFW_KEY_LEFT_SUPER) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_RIGHT_SUPER) == GLFW_PRESS) {
+    mods |= GLFW_MOD_SUPER;
+  }
+  return mods;
+}
+
 // Window callbacks handling
 void APIENTRY windowPosCB(NATIVEwindow *window, int xpos, int ypos) {
   Nan::HandleScope scope;
@@ -466,22 +557,30 @@ void APIENTRY keyCB(NATIVEwindow *window, int key, int scancode, int action, int
 
     int which = key;
 
-    Local<Object> evt = Nan::New<Object>();
-    evt->Set(JS_STR("type"), JS_STR(&actionNames[action << 3]));
-    evt->Set(JS_STR("ctrlKey"), JS_BOOL(mods & GLFW_MOD_CONTROL));
-    evt->Set(JS_STR("shiftKey"), JS_BOOL(mods & GLFW_MOD_SHIFT));
-    evt->Set(JS_STR("altKey"), JS_BOOL(mods & GLFW_MOD_ALT));
-    evt->Set(JS_STR("metaKey"), JS_BOOL(mods & GLFW_MOD_SUPER));
-    evt->Set(JS_STR("which"), JS_INT(which));
-    evt->Set(JS_STR("keyCode"), JS_INT(key));
-    evt->Set(JS_STR("charCode"), JS_INT(charCode));
-    evt->Set(JS_STR("windowHandle"), pointerToArray(window));
-
-    Local<Value> argv[] = {
-      JS_STR(&actionNames[action << 3]), // event name
-      evt,
-    };
-    CallEmitter(sizeof(argv)/sizeof(argv[0]), argv);
+    if (double *record = pushEventRecord(window, (EventRingType)(EVENT_RING_KEYUP + action))) {
+      record[3] = key;
+      record[4] = charCode;
+      record[5] = 0;
+      record[6] = 0;
+      record[7] = mods;
+    } else {
+      Local<Object> evt = Nan::New<Object>();
+      evt->Set(JS_STR("type"), JS_STR(&actionNames[action << 3]));
+      evt->Set(JS_STR("ctrlKey"), JS_BOOL(mods & GLFW_MOD_CONTROL));
+      evt->Set(JS_STR("shiftKey"), JS_BOOL(mods & GLFW_MOD_SHIFT));
+      evt->Set(JS_STR("altKey"), JS_BOOL(mods & GLFW_MOD_ALT));
+      evt->Set(JS_STR("metaKey"), JS_BOOL(mods & GLFW_MOD_SUPER));
+      evt->Set(JS_STR("which"), JS_INT(which));
+      evt->Set(JS_STR("keyCode"), JS_INT(key));
+      evt->Set(JS_STR("charCode"), JS_INT(charCode));
+      evt->Set(JS_STR("windowHandle"), pointerToArray(window));
+
+      Local<Value> argv[] = {
+        JS_STR(&actionNames[action << 3]), // event name
+        evt,
+      };
+      CallEmitter(sizeof(argv)/sizeof(argv[0]), argv);
+    }
 
     if (action == GLFW_PRESS && isPrintable) {
       keyCB(window, charCode, scancode, GLFW_REPEAT, mods);
@@ -510,29 +609,43 @@ void APIENTRY cursorPosCB(NATIVEwindow* window, double x, double y) {
   lastX = x;
   lastY = y;
 
-  Nan::HandleScope scope;
+  if (double *record = lastUnreadMouseMoveRecord(window)) {
+    record[3] = x;
+    record[4] = y;
+    record[5] += movementX;
+    record[6] += movementY;
+    record[7] = getMods(window);
+  } else if (double *record = pushEventRecord(window, EVENT_RING_MOUSEMOVE)) {
+    record[3] = x;
+    record[4] = y;
+    record[5] = movementX;
+    record[6] = movementY;
+    record[7] = getMods(window);
+  } else {
+    Nan::HandleScope scope;
 
-  Local<Object> evt = Nan::New<Object>();
-  evt->Set(JS_STR("type"),JS_STR("mousemove"));
-  evt->Set(JS_STR("clientX"),JS_NUM(x));
-  evt->Set(JS_STR("clientY"),JS_NUM(y));
-  evt->Set(JS_STR("pageX"),JS_NUM(x));
-  evt->Set(JS_STR("pageY"),JS_NUM(y));
-  evt->Set(JS_STR("offsetX"),JS_NUM(x));
-  evt->Set(JS_STR("offsetY"),JS_NUM(y));
-  evt->Set(JS_STR("movementX"),JS_NUM(movementX));
-  evt->Set(JS_STR("movementY"),JS_NUM(movementY));
-  evt->Set(JS_STR("ctrlKey"),JS_BOOL(glfwGetKey(window, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_RIGHT_CONTROL) == GLFW_PRESS));
-  evt->Set(JS_STR("shiftKey"),JS_BOOL(glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_RIGHT_SHIFT) == GLFW_PRESS));
-  evt->Set(JS_STR("altKey"),JS_BOOL(glfwGetKey(window, GLFW_KEY_LEFT_ALT) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_RIGHT_ALT) == GLFW_PRESS));
-  evt->Set(JS_STR("metaKey"),JS_BOOL(glfwGetKey(window, GLFW_KEY_LEFT_SUPER) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_RIGHT_SUPER) == GLFW_PRESS));
-  evt->Set(JS_STR("windowHandle"), pointerToArray(window));
+    Local<Object> evt = Nan::New<Object>();
+    evt->Set(JS_STR("type"),JS_STR("mousemove"));
+    evt->Set(JS_STR("clientX"),JS_NUM(x));
+    evt->Set(JS_STR("clientY"),JS_NUM(y));
+    evt->Set(JS_STR("pageX"),JS_NUM(x));
+    evt->Set(JS_STR("pageY"),JS_NUM(y));
+    evt->Set(JS_STR("offsetX"),JS_NUM(x));
+    evt->Set(JS_STR("offsetY"),JS_NUM(y));
+    evt->Set(JS_STR("movementX"),JS_NUM(movementX));
+    evt->Set(JS_STR("movementY"),JS_NUM(movementY));
+    evt->Set(JS_STR("ctrlKey"),JS_BOOL(glfwGetKey(window, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_RIGHT_CONTROL) == GLFW_PRESS));
+    evt->Set(JS_STR("shiftKey"),JS_BOOL(glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_RIGHT_SHIFT) == GLFW_PRESS));
+    evt->Set(JS_STR("altKey"),JS_BOOL(glfwGetKey(window, GLFW_KEY_LEFT_ALT) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_RIGHT_ALT) == GLFW_PRESS));
+    evt->Set(JS_STR("metaKey"),JS_BOOL(glfwGetKey(window, GLFW_KEY_LEFT_SUPER) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_RIGHT_SUPER) == GLFW_PRESS));
+    evt->Set(JS_STR("windowHandle"), pointerToArray(window));
 
-  Local<Value> argv[] = {
-    JS_STR("mousemove"), // event name
-    evt,
-  };
-  CallEmitter(sizeof(argv)/sizeof(argv[0]), argv);
+    Local<Value> argv[] = {
+      JS_STR("mousemove"), // event name
+      evt,
+    };
+    CallEmitter(sizeof(argv)/sizeof(argv[0]), argv);
+  }
 }
 
 void APIENTRY cursorEnterCB(NATIVEwindow* window, int entered) {
@@ -553,7 +666,13 @@ void APIENTRY cursorEnterCB(NATIVEwindow* window, int entered) {
 void APIENTRY mouseButtonCB(NATIVEwindow *window, int button, int action, int mods) {
   Nan::HandleScope scope;
 
-  {
+  if (double *record = pushEventRecord(window, action ? EVENT_RING_MOUSEDOWN : EVENT_RING_MOUSEUP)) {
+    record[3] = button;
+    record[4] = lastX;
+    record[5] = lastY;
+    record[6] = 0;
+    record[7] = mods;
+  } else {
     Local<Object> evt = Nan::New<Object>();
     evt->Set(JS_STR("type"),JS_STR(action ? "mousedown" : "mouseup"));
     evt->Set(JS_STR("button"),JS_INT(button));
@@ -578,31 +697,48 @@ void APIENTRY mouseButtonCB(NATIVEwindow *window, int button, int action, int mo
   }
 
   if (!action) {
-    Local<Object> evt = Nan::New<Object>();
-    evt->Set(JS_STR("type"),JS_STR("click"));
-    evt->Set(JS_STR("button"),JS_INT(button));
-    evt->Set(JS_STR("which"),JS_INT(button));
-    evt->Set(JS_STR("clientX"),JS_INT(lastX));
-    evt->Set(JS_STR("clientY"),JS_INT(lastY));
-    evt->Set(JS_STR("pageX"),JS_INT(lastX));
-    evt->Set(JS_STR("pageY"),JS_INT(lastY));
-    evt->Set(JS_STR("offsetX"),JS_INT(lastX));
-    evt->Set(JS_STR("offsetY"),JS_INT(lastY));
-    evt->Set(JS_STR("shiftKey"),JS_BOOL(mods & GLFW_MOD_SHIFT));
-    evt->Set(JS_STR("ctrlKey"),JS_BOOL(mods & GLFW_MOD_CONTROL));
-    evt->Set(JS_STR("altKey"),JS_BOOL(mods & GLFW_MOD_ALT));
-    evt->Set(JS_STR("metaKey"),JS_BOOL(mods & GLFW_MOD_SUPER));
-    evt->Set(JS_STR("windowHandle"), pointerToArray(window));
-
-    Local<Value> argv[] = {
-      JS_STR("click"), // event name
-      evt,
-    };
-    CallEmitter(sizeof(argv)/sizeof(argv[0]), argv);
+    if (double *record = pushEventRecord(window, EVENT_RING_CLICK)) {
+      record[3] = button;
+      record[4] = lastX;
+      record[5] = lastY;
+      record[6] = 0;
+      record[7] = mods;
+    } else {
+      Local<Object> evt = Nan::New<Object>();
+      evt->Set(JS_STR("type"),JS_STR("click"));
+      evt->Set(JS_STR("button"),JS_INT(button));
+      evt->Set(JS_STR("which"),JS_INT(button));
+      evt->Set(JS_STR("clientX"),JS_INT(lastX));
+      evt->Set(JS_STR("clientY"),JS_INT(lastY));
+      evt->Set(JS_STR("pageX"),JS_INT(lastX));
+      evt->Set(JS_STR("pageY"),JS_INT(lastY));
+      evt->Set(JS_STR("offsetX"),JS_INT(lastX));
+      evt->Set(JS_STR("offsetY"),JS_INT(lastY));
+      evt->Set(JS_STR("shiftKey"),JS_BOOL(mods & GLFW_MOD_SHIFT));
+      evt->Set(JS_STR("ctrlKey"),JS_BOOL(mods & GLFW_MOD_CONTROL));
+      evt->Set(JS_STR("altKey"),JS_BOOL(mods & GLFW_MOD_ALT));
+      evt->Set(JS_STR("metaKey"),JS_BOOL(mods & GLFW_MOD_SUPER));
+      evt->Set(JS_STR("windowHandle"), pointerToArray(window));
+
+      Local<Value> argv[] = {
+        JS_STR("click"), // event name
+        evt,
+      };
+      CallEmitter(sizeof(argv)/sizeof(argv[0]), argv);
+    }
   }
 }
 
 void APIENTRY scrollCB(NATIVEwindow *window, double xoffset, double yoffset) {
+  if (double *record = pushEventRecord(window, EVENT_RING_WHEEL)) {
+    record[3] = 0.0 - xoffset*120; // 0.0 - rather than negation, so a zero offset stays +0
+    record[4] = 0.0 - yoffset*120;
+    record[5] = 0;
+    record[6] = 0;
+    record[7] = 0;
+    return;
+  }
+
   Nan::HandleScope scope;
 
   Local<Object> evt = Nan::New<Object>();
@@ -846,6 +982,11 @@ NAN_METHOD(BlitFrameBuffer) {
   bool color = info[7]->BooleanValue();
   bool depth = info[8]->BooleanValue();
   bool stencil = info[9]->BooleanValue();
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(glObj);
+
+  if (gl->gpuProfiler) {
+    gl->gpuProfiler->Begin(GPU_TIMER_PHASE_BLIT);
+  }
 
   glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo1);
   glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo2);
@@ -859,7 +1000,10 @@ NAN_METHOD(BlitFrameBuffer) {
     (stencil ? GL_STENCIL_BUFFER_BIT : 0),
     (depth || stencil) ? GL_NEAREST : GL_LINEAR);
 
-  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(glObj);
+  if (gl->gpuProfiler) {
+    gl->gpuProfiler->End(GPU_TIMER_PHASE_BLIT);
+  }
+
   if (gl->HasFramebufferBinding(GL_READ_FRAMEBUFFER)) {
     glBindFramebuffer(GL_READ_FRAMEBUFFER, gl->GetFramebufferBinding(GL_READ_FRAMEBUFFER));
   } else {
@@ -1252,6 +1396,62 @@ NAN_METHOD(SetEventHandler) {
   (*eventHandler).Reset(Local<Function>::Cast(info[0]));
 }
 
+NAN_METHOD(SetEventRing) {
+  if (info[0]->IsFloat64Array()) {
+    Local<Float64Array> array = Local<Float64Array>::Cast(info[0]);
+    size_t length = array->Length();
+    if (length >= EVENT_RING_HEADER_SIZE + EVENT_RING_RECORD_SIZE) {
+      eventRingArray.Reset(array);
+      eventRing = (double *)((char *)array->Buffer()->GetContents().Data() + array->ByteOffset());
+      eventRingCapacity = (length - EVENT_RING_HEADER_SIZE) / EVENT_RING_RECORD_SIZE;
+      eventRing[0] = 0;
+      eventRing[1] = 0;
+      if (info[1]->IsFunction()) {
+        eventRingDrainFn.Reset(Local<Function>::Cast(info[1]));
+      } else {
+        eventRingDrainFn.Reset();
+      }
+      eventRingDropped = 0;
+    } else {
+      Nan::ThrowError("setEventRing: array too small");
+    }
+  } else if (info[0]->IsNull() || info[0]->IsUndefined()) {
+    eventRingArray.Reset();
+    eventRingDrainFn.Reset();
+    eventRing = nullptr;
+    eventRingCapacity = 0;
+  } else {
+    Nan::ThrowError("setEventRing: invalid arguments");
+  }
+}
+
+NAN_METHOD(GetEventRingDropped) {
+  info.GetReturnValue().Set(JS_INT(eventRingDropped));
+}
+
+// Feeds synthetic input through the same callbacks GLFW would invoke, for testing without a real input device.
+NAN_METHOD(InjectEvent) {
+  if (info[0]->IsArray() && info[1]->IsString()) {
+    NATIVEwindow *window = (NATIVEwindow *)arrayToPointer(Local<Array>::Cast(info[0]));
+    Nan::Utf8String typeUtf8(info[1]);
+    std::string type(*typeUtf8, typeUtf8.length());
+
+    if (type == "key") {
+      keyCB(window, info[2]->Int32Value(), 0, info[3]->Int32Value(), info[4]->Int32Value());
+    } else if (type == "cursorPos") {
+      cursorPosCB(window, info[2]->NumberValue(), info[3]->NumberValue());
+    } else if (type == "mouseButton") {
+      mouseButtonCB(window, info[2]->Int32Value(), info[3]->Int32Value(), info[4]->Int32Value());
+    } else if (type == "scroll") {
+      scrollCB(window, info[2]->NumberValue(), info[3]->NumberValue());
+    } else {
+      Nan::ThrowError("injectEvent: unknown event type");
+    }
+  } else {
+    Nan::ThrowError("injectEvent: invalid arguments");
+  }
+}
+
 NAN_METHOD(PollEvents) {
   glfwPollEvents();
 }
@@ -1697,6 +1897,9 @@ Local<Object> makeWindow() {
   Nan::SetMethod(target, "iconifyWindow", glfw::IconifyWindow);
   Nan::SetMethod(target, "restoreWindow", glfw::RestoreWindow);
   Nan::SetMethod(target, "setEventHandler", glfw::SetEventHandler);
+  Nan::SetMethod(target, "setEventRing", glfw::SetEventRing);
+  Nan::SetMethod(target, "getEventRingDropped", glfw::GetEventRingDropped);
+  Nan::SetMethod(target, "injectEvent", glfw::InjectEvent);
   Nan::SetMethod(target, "pollEvents", glfw::PollEvents);
   Nan::SetMethod(target, "swapBuffers", glfw::SwapBuffers);
   Nan::SetMethod(target, "getRefreshRate", glfw::GetRefreshRate);
@@ -0,0 +1,47 @@
+#ifndef _EXTERNAL_MEMORY_H_
+#define _EXTERNAL_MEMORY_H_
+
+#include <v8.h>
+#include <nan.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace externalmemory {
+
+enum ExternalMemoryCategory {
+  EXTERNAL_MEMORY_CANVAS,
+  EXTERNAL_MEMORY_IMAGE,
+  EXTERNAL_MEMORY_IMAGE_DATA,
+  EXTERNAL_MEMORY_IMAGE_BITMAP,
+  EXTERNAL_MEMORY_TEXTURE,
+  EXTERNAL_MEMORY_VIDEO,
+  EXTERNAL_MEMORY_AUDIO,
+  EXTERNAL_MEMORY_COUNT,
+};
+
+// The native allocation size of one wrapper object. Changes are counted in getMemoryStats() and, unless the
+// memory is already visible to V8 or is not freed by GC (GPU textures), reported through
+// AdjustAmountOfExternalMemory so the collector feels pressure from it. Must be updated on the main thread.
+class ExternalMemory {
+public:
+  ExternalMemory(ExternalMemoryCategory category, bool reportToV8 = true);
+  ~ExternalMemory();
+
+  void Set(size_t newSize);
+  size_t Get() const;
+
+private:
+  ExternalMemoryCategory category;
+  bool reportToV8;
+  size_t size;
+};
+
+void Adjust(ExternalMemoryCategory category, int64_t delta, int64_t countDelta, bool reportToV8);
+int64_t GetBytes(ExternalMemoryCategory category);
+
+v8::Local<v8::Object> Initialize(v8::Isolate *isolate);
+
+}
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+#include <v8.h>
+#include <nan.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Events per thread buffer; once full, later events on that thread are dropped until the next trace starts.
+#define TRACE_BUFFER_SIZE (16 * 1024)
+
+#if defined(_MSC_VER)
+#define TRACE_FUNCTION_SIGNATURE __FUNCSIG__
+#else
+#define TRACE_FUNCTION_SIGNATURE __PRETTY_FUNCTION__
+#endif
+
+#define TRACE_CONCAT_INNER(a, b) a ## b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(category, name) trace::TraceScope TRACE_CONCAT(traceScope, __LINE__)(category, name)
+
+namespace trace {
+
+struct TraceEvent {
+  const char *category;
+  const char *name;
+  uint64_t start;
+  uint64_t duration;
+  uint32_t tid;
+};
+
+// Written only by the thread that currently owns it; readers see events up to the release-stored numEvents.
+class TraceBuffer {
+public:
+  TraceBuffer();
+
+  std::atomic<uint32_t> epoch;
+  std::atomic<uint32_t> numEvents;
+  std::atomic<uint32_t> numDropped;
+  TraceEvent events[TRACE_BUFFER_SIZE];
+};
+
+extern std::atomic<bool> enabled;
+
+inline bool IsEnabled() {
+  return enabled.load(std::memory_order_relaxed);
+}
+uint64_t Now();
+void Push(const char *category, const char *name, uint64_t start, uint64_t duration);
+const char *Intern(const std::string &s);
+const char *InternFunctionName(const char *signature);
+void Start();
+void Stop();
+std::string Dump(uint32_t pid);
+
+class TraceScope {
+public:
+  TraceScope(const char *category, const char *name) : name(IsEnabled() ? name : nullptr) {
+    if (this->name) {
+      this->category = category;
+      start = Now();
+    }
+  }
+  ~TraceScope() {
+    if (name) {
+      Push(category, name, start, Now() - start);
+    }
+  }
+
+private:
+  const char *category;
+  const char *name;
+  uint64_t start;
+};
+
+v8::Local<v8::Object> Initialize(v8::Isolate *isolate);
+
+}
+
+#endif
@@ -0,0 +1,94 @@
+#include <external-memory.h>
+#include <defines.h>
+
+#include <atomic>
+
+namespace externalmemory {
+
+namespace {
+  std::atomic<int64_t> bytes[EXTERNAL_MEMORY_COUNT];
+  std::atomic<int64_t> counts[EXTERNAL_MEMORY_COUNT];
+
+  const char *categoryNames[EXTERNAL_MEMORY_COUNT] = {
+    "canvas",
+    "image",
+    "imageData",
+    "imageBitmap",
+    "texture",
+    "video",
+    "audio",
+  };
+}
+
+ExternalMemory::ExternalMemory(ExternalMemoryCategory category, bool reportToV8) : category(category), reportToV8(reportToV8), size(0) {}
+
+ExternalMemory::~ExternalMemory() {
+  Set(0);
+}
+
+void ExternalMemory::Set(size_t newSize) {
+  if (newSize != size) {
+    int64_t countDelta = (size == 0 ? 1 : 0) - (newSize == 0 ? 1 : 0);
+    Adjust(category, (int64_t)newSize - (int64_t)size, countDelta, reportToV8);
+    size = newSize;
+  }
+}
+
+size_t ExternalMemory::Get() const {
+  return size;
+}
+
+void Adjust(ExternalMemoryCategory category, int64_t delta, int64_t countDelta, bool reportToV8) {
+  bytes[category] += delta;
+  counts[category] += countDelta;
+
+  if (reportToV8) {
+    // wrappers can be destroyed during teardown, after the isolate is gone
+    Isolate *isolate = Isolate::GetCurrent();
+    if (isolate) {
+      isolate->AdjustAmountOfExternalMemory(delta);
+    }
+  }
+}
+
+int64_t GetBytes(ExternalMemoryCategory category) {
+  return bytes[category];
+}
+
+// getMemoryStats() -> {canvas: {bytes, count}, image: ..., total}
+NAN_METHOD(GetMemoryStats) {
+  Local<Object> result = Nan::New<Object>();
+
+  int64_t totalBytes = 0;
+  int64_t totalCount = 0;
+  for (int i = 0; i < EXTERNAL_MEMORY_COUNT; i++) {
+    int64_t categoryBytes = bytes[i];
+    int64_t categoryCount = counts[i];
+
+    Local<Object> categoryObj = Nan::New<Object>();
+    categoryObj->Set(JS_STR("bytes"), JS_NUM((double)categoryBytes));
+    categoryObj->Set(JS_STR("count"), JS_NUM((double)categoryCount));
+    result->Set(JS_STR(categoryNames[i]), categoryObj);
+
+    totalBytes += categoryBytes;
+    totalCount += categoryCount;
+  }
+
+  Local<Object> totalObj = Nan::New<Object>();
+  totalObj->Set(JS_STR("bytes"), JS_NUM((double)totalBytes));
+  totalObj->Set(JS_STR("count"), JS_NUM((double)totalCount));
+  result->Set(JS_STR("total"), totalObj);
+
+  info.GetReturnValue().Set(result);
+}
+
+Local<Object> Initialize(Isolate *isolate) {
+  Nan::EscapableHandleScope scope;
+
+  Local<Object> result = Nan::New<Object>();
+  Nan::SetMethod(result, "getMemoryStats", GetMemoryStats);
+
+  return scope.Escape(result);
+}
+
+}
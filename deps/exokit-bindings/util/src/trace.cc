@@ -0,0 +1,252 @@
+#include <trace.h>
+#include <defines.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+namespace trace {
+
+namespace {
+  std::mutex buffersMutex;
+  std::vector<TraceBuffer *> buffers;
+  std::vector<TraceBuffer *> freeBuffers;
+  std::atomic<uint32_t> currentEpoch(0);
+  std::atomic<uint32_t> nextTid(1);
+  uint32_t mainTid = 0;
+
+  std::mutex internMutex;
+  std::unordered_set<std::string> internedStrings;
+
+  const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+  // Buffers outlive their threads: on exit a thread hands its buffer back for the next thread to append to,
+  // so short-lived decode threads neither lose their events nor grow memory without bound.
+  class ThreadState {
+  public:
+    ThreadState() : buffer(nullptr), tid(nextTid++) {}
+    ~ThreadState() {
+      if (buffer) {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        freeBuffers.push_back(buffer);
+      }
+    }
+
+    TraceBuffer *buffer;
+    uint32_t tid;
+  };
+  thread_local ThreadState threadState;
+
+  TraceBuffer *AcquireBuffer() {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+
+    if (freeBuffers.size() > 0) {
+      TraceBuffer *buffer = freeBuffers.back();
+      freeBuffers.pop_back();
+      return buffer;
+    } else {
+      TraceBuffer *buffer = new TraceBuffer();
+      buffers.push_back(buffer);
+      return buffer;
+    }
+  }
+
+  void AppendEscaped(std::string &s, const char *value) {
+    for (const char *c = value; *c; c++) {
+      if (*c == '"' || *c == '\\') {
+        s += '\\';
+        s += *c;
+      } else if ((unsigned char)*c < 0x20) {
+        char escaped[8];
+        snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned int)*c);
+        s += escaped;
+      } else {
+        s += *c;
+      }
+    }
+  }
+}
+
+std::atomic<bool> enabled(false);
+
+TraceBuffer::TraceBuffer() : epoch(0), numEvents(0), numDropped(0) {}
+
+uint64_t Now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void Push(const char *category, const char *name, uint64_t start, uint64_t duration) {
+  ThreadState &state = threadState;
+  TraceBuffer *buffer = state.buffer;
+  if (!buffer) {
+    buffer = AcquireBuffer();
+    state.buffer = buffer;
+  }
+
+  // the owning thread is the only writer, so it clears its own buffer when a new trace has started
+  uint32_t epoch = currentEpoch.load(std::memory_order_acquire);
+  if (buffer->epoch.load(std::memory_order_relaxed) != epoch) {
+    buffer->numEvents.store(0, std::memory_order_relaxed);
+    buffer->numDropped.store(0, std::memory_order_relaxed);
+    buffer->epoch.store(epoch, std::memory_order_release);
+  }
+
+  uint32_t numEvents = buffer->numEvents.load(std::memory_order_relaxed);
+  if (numEvents < TRACE_BUFFER_SIZE) {
+    TraceEvent &event = buffer->events[numEvents];
+    event.category = category;
+    event.name = name;
+    event.start = start;
+    event.duration = duration;
+    event.tid = state.tid;
+    buffer->numEvents.store(numEvents + 1, std::memory_order_release);
+  } else {
+    buffer->numDropped.store(buffer->numDropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+}
+
+const char *Intern(const std::string &s) {
+  std::lock_guard<std::mutex> lock(internMutex);
+  return internedStrings.insert(s).first->c_str();
+}
+
+// Pulls the wrapped function's name out of a template wrapper's signature, e.g.
+// "... [with ... F = WebGLRenderingContext::Clear]" or "glCallWrap<&WebGLRenderingContext::Clear>(...)" -> "Clear".
+const char *InternFunctionName(const char *signature) {
+  std::string s(signature);
+  size_t start = s.rfind("= ");
+  size_t end;
+  if (start != std::string::npos) {
+    start += 2;
+    end = s.find_first_of("];,", start);
+  } else {
+    start = s.find('<');
+    end = start != std::string::npos ? s.find('>', start) : std::string::npos;
+    if (start != std::string::npos) {
+      start++;
+    }
+  }
+  if (start != std::string::npos && end != std::string::npos && end > start) {
+    s = s.substr(start, end - start);
+  }
+  size_t scope = s.rfind("::");
+  if (scope != std::string::npos) {
+    s = s.substr(scope + 2);
+  }
+  if (s.size() > 0 && s[0] == '&') {
+    s = s.substr(1);
+  }
+  return Intern(s);
+}
+
+void Start() {
+  currentEpoch.fetch_add(1, std::memory_order_acq_rel);
+  enabled.store(true, std::memory_order_relaxed);
+}
+
+void Stop() {
+  enabled.store(false, std::memory_order_relaxed);
+}
+
+// Chrome trace_event JSON (chrome://tracing, Perfetto) of every event recorded since the last Start.
+std::string Dump(uint32_t pid) {
+  std::vector<TraceBuffer *> localBuffers;
+  {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    localBuffers = buffers;
+  }
+
+  uint32_t epoch = currentEpoch.load(std::memory_order_acquire);
+  uint32_t numDropped = 0;
+  std::string s;
+  s.reserve(4096);
+  s += "{\"traceEvents\":[";
+
+  char eventString[128];
+  snprintf(eventString, sizeof(eventString), "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"exokit\"}}", pid, mainTid);
+  s += eventString;
+  snprintf(eventString, sizeof(eventString), ",{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"main\"}}", pid, mainTid);
+  s += eventString;
+
+  for (size_t i = 0; i < localBuffers.size(); i++) {
+    TraceBuffer *buffer = localBuffers[i];
+    if (buffer->epoch.load(std::memory_order_acquire) == epoch) {
+      uint32_t numEvents = buffer->numEvents.load(std::memory_order_acquire);
+      for (uint32_t j = 0; j < numEvents; j++) {
+        const TraceEvent &event = buffer->events[j];
+        s += ",{\"cat\":\"";
+        AppendEscaped(s, event.category);
+        s += "\",\"name\":\"";
+        AppendEscaped(s, event.name);
+        snprintf(eventString, sizeof(eventString), "\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%u,\"tid\":%u}", (double)event.start / 1000.0, (double)event.duration / 1000.0, pid, event.tid);
+        s += eventString;
+      }
+      numDropped += buffer->numDropped.load(std::memory_order_relaxed);
+    }
+  }
+
+  snprintf(eventString, sizeof(eventString), "],\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":%u}}", numDropped);
+  s += eventString;
+  return s;
+}
+
+NAN_METHOD(StartTrace) {
+  Start();
+}
+
+NAN_METHOD(StopTrace) {
+  Stop();
+}
+
+NAN_METHOD(IsTraceEnabled) {
+  info.GetReturnValue().Set(JS_BOOL(IsEnabled()));
+}
+
+NAN_METHOD(TraceNow) {
+  info.GetReturnValue().Set(JS_NUM((double)Now() / 1000.0));
+}
+
+// addSpan(category, name, start, end), with start and end in microseconds from now().
+NAN_METHOD(AddSpan) {
+  if (IsEnabled()) {
+    if (info[0]->IsString() && info[1]->IsString() && info[2]->IsNumber() && info[3]->IsNumber()) {
+      const char *category = Intern(*Nan::Utf8String(info[0]));
+      const char *name = Intern(*Nan::Utf8String(info[1]));
+      // round rather than truncate, so a time taken from now() maps back to the same nanosecond
+      long long start = std::max(std::llround(info[2]->NumberValue() * 1000.0), 0LL);
+      long long end = std::max(std::llround(info[3]->NumberValue() * 1000.0), start);
+      Push(category, name, (uint64_t)start, (uint64_t)(end - start));
+    } else {
+      Nan::ThrowError("Trace::AddSpan: invalid arguments");
+    }
+  }
+}
+
+NAN_METHOD(DumpTrace) {
+  uint32_t pid = info[0]->IsNumber() ? info[0]->Uint32Value() : 0;
+  std::string s = Dump(pid);
+  info.GetReturnValue().Set(JS_STR(s.c_str(), s.size()));
+}
+
+Local<Object> Initialize(Isolate *isolate) {
+  Nan::EscapableHandleScope scope;
+
+  mainTid = threadState.tid;
+
+  Local<Object> result = Nan::New<Object>();
+  Nan::SetMethod(result, "start", StartTrace);
+  Nan::SetMethod(result, "stop", StopTrace);
+  Nan::SetMethod(result, "isEnabled", IsTraceEnabled);
+  Nan::SetMethod(result, "now", TraceNow);
+  Nan::SetMethod(result, "addSpan", AddSpan);
+  Nan::SetMethod(result, "dump", DumpTrace);
+
+  return scope.Escape(result);
+}
+
+}
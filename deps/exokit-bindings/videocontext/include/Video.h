@@ -14,6 +14,7 @@ extern "C" {
 }
 
 #include <defines.h>
+#include <external-memory.h>
 
 using namespace std;
 using namespace v8;
@@ -100,6 +101,7 @@ private:
   double startFrameTime;
   Nan::Persistent<Uint8ClampedArray> dataArray;
   bool dataDirty;
+  externalmemory::ExternalMemory externalMemory;
 };
 
 class VideoCamera;
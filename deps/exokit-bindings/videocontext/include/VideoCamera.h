@@ -5,7 +5,7 @@
 
 // #include <cassert>
 // #include <iomanip> // setprecision
-#include <mutex>
+#include <atomic>
 #include <thread>
 
 extern "C" {
@@ -17,15 +17,28 @@ extern "C" {
 
 namespace ffmpeg {
 
+// Number of preallocated RGBA frames shared between the capture thread and the reader.
+// One is written by the capture thread, one is held by the reader and one is in flight.
+#define VIDEO_CAMERA_NUM_FRAMES 3
+
 class VideoCamera
 {
 public:
   AVFormatContext *pFormatCtx;
-  AVFrame *pFrameRGB;
   int videoStream;
-  bool *pLive;
-  std::mutex *pMutex;
-  bool *pFrameReady;
+  size_t width;
+  size_t height;
+  std::atomic<bool> live;
+  std::thread thread;
+
+  // capture thread state
+  struct SwsContext *pSwsCtx;
+  int backIndex;
+  // latest published frame index, with FRAME_NEW_BIT set until the reader picks it up
+  std::atomic<int> readyIndex;
+  // reader state
+  int frontIndex;
+  uint8_t *frames[VIDEO_CAMERA_NUM_FRAMES];
 
   VideoCamera(AVFormatContext *formatContext, int videoStream);
   ~VideoCamera();
@@ -36,11 +49,15 @@ public:
   size_t getHeight() const;
   size_t getSize() const;
   bool isFrameReady() const;
-  void pullUpdate(uint8_t *buffer) const;
+  void pullUpdate(uint8_t *buffer);
   static VideoCamera* open(const char *deviceName, AVDictionary *options);
+
+protected:
+  void captureLoop();
+  void publishFrame(AVFrame *pFrame);
+  static int interruptCallback(void *opaque);
 };
 
 }
 
 #endif
-
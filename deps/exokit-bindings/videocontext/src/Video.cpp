@@ -1,6 +1,7 @@
 #include <Video.h>
 #include <VideoMode.h>
 #include <VideoCamera.h>
+#include <trace.h>
 
 using namespace v8;
 
@@ -26,8 +27,9 @@ void AppData::resetState() {
     av_frame = nullptr;
   }
   if (gl_frame) {
-    av_free(gl_frame);
-    gl_frame = nullptr;
+    // the picture buffer was attached with avpicture_fill, so the frame does not own it
+    av_free(gl_frame->data[0]);
+    av_frame_free(&gl_frame);
   }
   if (packet) {
     av_free_packet(packet);
@@ -216,12 +218,13 @@ double AppData::getTimeBase() {
   }
 }
 
-Video::Video() : loaded(false), playing(false), loop(false), startTime(0), startFrameTime(0), dataDirty(true) {
+Video::Video() : loaded(false), playing(false), loop(false), startTime(0), startFrameTime(0), dataDirty(true), externalMemory(externalmemory::EXTERNAL_MEMORY_VIDEO) {
   videos.push_back(this);
 }
 
 Video::~Video() {
   videos.erase(std::find(videos.begin(), videos.end(), this));
+  dataArray.Reset();
 }
 
 Handle<Object> Video::Initialize(Isolate *isolate) {
@@ -279,7 +282,11 @@ bool Video::Load(unsigned char *bufferValue, size_t bufferLength, string *error)
   std::vector<unsigned char> bufferData(bufferLength);
   memcpy(bufferData.data(), bufferValue, bufferLength);
 
-  if (data.set(bufferData, error)) { // takes ownership of bufferData
+  bool ok = data.set(bufferData, error); // takes ownership of bufferData
+  // the file copy plus the decoded RGB frame
+  externalMemory.Set(data.data.size() + (data.gl_frame ? (size_t)data.codec_ctx->width * data.codec_ctx->height * 3 : 0));
+
+  if (ok) {
     // scan to the first frame
     FrameStatus status = advanceToFrameAt(0);
     if (status == FRAME_STATUS_OK) {
@@ -544,6 +551,7 @@ double Video::getFrameCurrentTimeS() {
 }
 
 FrameStatus Video::advanceToFrameAt(double timestamp) {
+  TRACE_SCOPE("video", "advanceToFrameAt");
   FrameStatus status = data.advanceToFrameAt(timestamp);
   if (status == FRAME_STATUS_OK) {
     dataDirty = true;
@@ -5,8 +5,11 @@ extern "C" {
 #include <libavcodec/avcodec.h>
 #include <libavdevice/avdevice.h>
 #include <libswscale/swscale.h>
+#include <libavutil/time.h>
 }
 
+#include <cstring>
+
 namespace ffmpeg {
 
 // https://stackoverflow.com/a/23216860
@@ -28,61 +31,125 @@ static AVPixelFormat normalizeFormat(AVPixelFormat pixFormat) {
   return pixFormat;
 }
 
+#define FRAME_NEW_BIT 0x4
+#define FRAME_INDEX_MASK 0x3
+
 VideoCamera::VideoCamera(AVFormatContext *pFormatCtx, int videoStream)
 : pFormatCtx(pFormatCtx)
 , videoStream(videoStream)
+, live(true)
+, pSwsCtx(nullptr)
+, backIndex(0)
+, readyIndex(1)
+, frontIndex(2)
 {
+  width = getCodecContext()->width;
+  height = getCodecContext()->height;
+  for (int i = 0; i < VIDEO_CAMERA_NUM_FRAMES; i++) {
+    frames[i] = (uint8_t *)av_mallocz(getSize() * sizeof(uint8_t));
+  }
+
+  // never spin on EAGAIN; block in the device until a frame arrives or we are closed
+  pFormatCtx->flags &= ~AVFMT_FLAG_NONBLOCK;
+  pFormatCtx->interrupt_callback.callback = interruptCallback;
+  pFormatCtx->interrupt_callback.opaque = this;
+
+  thread = std::thread([this]() -> void {
+    captureLoop();
+  });
+}
+
+VideoCamera::~VideoCamera() {
+  live = false;
+  thread.join();
+
+  sws_freeContext(pSwsCtx);
+  for (int i = 0; i < VIDEO_CAMERA_NUM_FRAMES; i++) {
+    av_free(frames[i]);
+  }
+  avcodec_close(getCodecContext());
+  avformat_close_input(&pFormatCtx);
+}
+
+int VideoCamera::interruptCallback(void *opaque) {
+  VideoCamera *camera = (VideoCamera *)opaque;
+  return !camera->live;
+}
+
+void VideoCamera::captureLoop() {
+  AVCodecContext *pCodecCtx = getCodecContext();
+  AVRational timeBase = pFormatCtx->streams[videoStream]->time_base;
   AVFrame *pFrame = av_frame_alloc();
-  AVFrame *pFrameRGB = av_frame_alloc();
-  uint8_t *internal_buffer = (uint8_t *)av_malloc(getSize() * sizeof(uint8_t));
-  avpicture_fill((AVPicture *)pFrameRGB, internal_buffer, AV_PIX_FMT_RGBA, getWidth(), getHeight());
-  
-  this->pFrameRGB = pFrameRGB;
-  bool *pLive = new bool(true);
-  this->pLive = pLive;
-  std::mutex *pMutex = new std::mutex();
-  this->pMutex = pMutex;
-  bool *pFrameReady = new bool(false);
-  this->pFrameReady = pFrameReady;
-
-  std::thread([pFormatCtx, videoStream, pFrame, pFrameRGB, pLive, pMutex, pFrameReady]() mutable -> void {
-    AVPacket packet;
-
-    while (*pLive) {
-      int frameFinished = 0;
-      if (av_read_frame(pFormatCtx, &packet) >= 0) {
-        if (packet.stream_index == videoStream) {
-          AVCodecContext *pCodecCtx = pFormatCtx->streams[videoStream]->codec;
-          avcodec_decode_video2(pCodecCtx, pFrame, &frameFinished, &packet);
+  AVPacket packet;
+  av_init_packet(&packet);
 
-          if (frameFinished) {
-            struct SwsContext *img_convert_ctx;
-            img_convert_ctx = sws_getCachedContext(nullptr, pCodecCtx->width, pCodecCtx->height, normalizeFormat(pCodecCtx->pix_fmt), pCodecCtx->width, pCodecCtx->height, AV_PIX_FMT_RGBA, SWS_BICUBIC, nullptr, nullptr, nullptr);
+  // file and lavfi stand-ins decode faster than real time, so pace them by pts;
+  // live devices deliver at wall clock rate and never sleep here
+  int64_t startPts = AV_NOPTS_VALUE;
+  int64_t startTime = 0;
 
-            {
-              std::lock_guard<std::mutex> lock(*pMutex);
-              sws_scale(img_convert_ctx, ((AVPicture*)pFrame)->data, ((AVPicture*)pFrame)->linesize, 0, pCodecCtx->height, ((AVPicture *)pFrameRGB)->data, ((AVPicture *)pFrameRGB)->linesize);
-              *pFrameReady = true;
-            }
+  while (live) {
+    int ret = av_read_frame(pFormatCtx, &packet);
+    if (ret == AVERROR(EAGAIN)) {
+      av_usleep(1000);
+      continue;
+    } else if (ret == AVERROR_EOF) {
+      // loop file stand-ins
+      if (av_seek_frame(pFormatCtx, videoStream, 0, AVSEEK_FLAG_BACKWARD) < 0) {
+        break;
+      }
+      avcodec_flush_buffers(pCodecCtx);
+      startPts = AV_NOPTS_VALUE;
+      continue;
+    } else if (ret < 0) {
+      break;
+    }
 
-            sws_freeContext(img_convert_ctx);
+    if (packet.stream_index == videoStream) {
+      int frameFinished = 0;
+      avcodec_decode_video2(pCodecCtx, pFrame, &frameFinished, &packet);
+
+      if (frameFinished) {
+        int64_t pts = av_frame_get_best_effort_timestamp(pFrame);
+        if (pts != AV_NOPTS_VALUE) {
+          int64_t now = av_gettime_relative();
+          if (startPts == AV_NOPTS_VALUE) {
+            startPts = pts;
+            startTime = now;
+          } else {
+            int64_t delay = av_rescale_q(pts - startPts, timeBase, AV_TIME_BASE_Q) - (now - startTime);
+            if (delay > 0 && delay < AV_TIME_BASE) {
+              av_usleep(delay);
+            } else if (delay >= AV_TIME_BASE) {
+              startPts = pts;
+              startTime = now;
+            }
           }
         }
+
+        publishFrame(pFrame);
       }
     }
 
     av_free_packet(&packet);
-    av_free(pFrameRGB);
-    av_free(pFrame);
-    avformat_close_input(&pFormatCtx);
-    delete pLive;
-    delete pMutex;
-    delete pFrameReady;
-  }).detach();
+  }
+
+  av_frame_free(&pFrame);
 }
 
-VideoCamera::~VideoCamera() {
-  *pLive = false;
+void VideoCamera::publishFrame(AVFrame *pFrame) {
+  pSwsCtx = sws_getCachedContext(pSwsCtx, pFrame->width, pFrame->height, normalizeFormat((AVPixelFormat)pFrame->format), width, height, AV_PIX_FMT_RGBA, SWS_BICUBIC, nullptr, nullptr, nullptr);
+  if (!pSwsCtx) {
+    return;
+  }
+
+  uint8_t *dstData[4] = {frames[backIndex], nullptr, nullptr, nullptr};
+  int dstLinesize[4] = {(int)(width * 4), 0, 0, 0};
+  sws_scale(pSwsCtx, pFrame->data, pFrame->linesize, 0, pFrame->height, dstData, dstLinesize);
+
+  // latest frame wins: whatever the reader did not pick up becomes our next back buffer
+  int oldIndex = readyIndex.exchange(backIndex | FRAME_NEW_BIT);
+  backIndex = oldIndex & FRAME_INDEX_MASK;
 }
 
 AVCodecContext*
@@ -100,13 +167,13 @@ VideoCamera::getFormat() const
 size_t
 VideoCamera::getWidth() const
 {
-  return getCodecContext()->width;
+  return width;
 }
 
 size_t
 VideoCamera::getHeight() const
 {
-  return getCodecContext()->height;
+  return height;
 }
 
 size_t
@@ -116,21 +183,34 @@ VideoCamera::getSize() const
 }
 
 bool VideoCamera::isFrameReady() const {
-  std::lock_guard<std::mutex> lock(*pMutex);
-  return *pFrameReady;
+  return (readyIndex.load() & FRAME_NEW_BIT) != 0;
 }
 
-void VideoCamera::pullUpdate(uint8_t *buffer) const {
-  std::lock_guard<std::mutex> lock(*pMutex);
-  avpicture_fill((AVPicture*)pFrameRGB, buffer, AV_PIX_FMT_RGBA, getWidth(), getHeight());
-  *pFrameReady = false;
+void VideoCamera::pullUpdate(uint8_t *buffer) {
+  if (readyIndex.load() & FRAME_NEW_BIT) {
+    int newIndex = readyIndex.exchange(frontIndex);
+    frontIndex = newIndex & FRAME_INDEX_MASK;
+  }
+  memcpy(buffer, frames[frontIndex], getSize());
 }
 
 static AVInputFormat*
-getInputFormat()
+getInputFormat(AVDictionary **options)
 {
   AVInputFormat* iformat = nullptr;
-#if USING_V4L
+
+  // "f=<format>" picks an explicit input format, e.g. lavfi or a plain file as a stand-in device
+  AVDictionaryEntry *entry = av_dict_get(*options, "f", nullptr, 0);
+  if (entry) {
+    std::string formatName(entry->value);
+    av_dict_set(options, "f", nullptr, 0);
+    if ((iformat = av_find_input_format(formatName.c_str())))
+      return iformat;
+    fprintf(stderr, "Unknown input format %s\n", formatName.c_str());
+    return nullptr;
+  }
+
+#if EXO_USING_V4L
   if ((iformat = av_find_input_format("v4l2")))
       return iformat;
 #endif
@@ -154,7 +234,7 @@ getInputFormat()
 VideoCamera*
 VideoCamera::open(const char* deviceName, AVDictionary* options)
 {
-  AVInputFormat* format = getInputFormat();
+  AVInputFormat* format = getInputFormat(&options);
   if (format) {
     AVFormatContext *pFormatCtx = avformat_alloc_context();
     if (avformat_open_input(&pFormatCtx, deviceName, format, &options) >= 0) {
@@ -164,7 +244,7 @@ VideoCamera::open(const char* deviceName, AVDictionary* options)
         int videoStream = -1;
         for (unsigned int i=0; i < pFormatCtx->nb_streams; i++)
         {
-          if (pFormatCtx->streams[i]->codec->coder_type==AVMEDIA_TYPE_VIDEO)
+          if (pFormatCtx->streams[i]->codec->codec_type==AVMEDIA_TYPE_VIDEO)
           {
             videoStream = i;
             break;
@@ -175,6 +255,7 @@ VideoCamera::open(const char* deviceName, AVDictionary* options)
           AVCodec *pCodec = avcodec_find_decoder(pCodecCtx->codec_id);
           if (pCodec) {
             if (avcodec_open2(pCodecCtx, pCodec, nullptr) >= 0) {
+              av_dict_free(&options);
               VideoCamera* device = new VideoCamera(pFormatCtx, videoStream);
               return device;
             }
@@ -184,6 +265,7 @@ VideoCamera::open(const char* deviceName, AVDictionary* options)
       avformat_close_input(&pFormatCtx);
     }
   }
+  av_dict_free(&options);
   return nullptr;
 }
 
@@ -7,6 +7,7 @@
 #include <functional>
 // #include "LabSound/extended/LabSound.h"
 #include <defines.h>
+#include <external-memory.h>
 #include <AudioNode.h>
 
 using namespace std;
@@ -38,6 +39,7 @@ protected:
 
   uint32_t sampleRate;
   Nan::Persistent<Array> buffers;
+  externalmemory::ExternalMemory externalMemory;
 
   friend class AudioBufferSourceNode;
   friend class ScriptProcessorNode;
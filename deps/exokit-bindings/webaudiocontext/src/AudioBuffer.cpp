@@ -3,8 +3,19 @@
 
 namespace webaudio {
 
-AudioBuffer::AudioBuffer(uint32_t sampleRate, Local<Array> buffers) : sampleRate(sampleRate), buffers(buffers) {}
-AudioBuffer::~AudioBuffer() {}
+AudioBuffer::AudioBuffer(uint32_t sampleRate, Local<Array> buffers) : sampleRate(sampleRate), buffers(buffers), externalMemory(externalmemory::EXTERNAL_MEMORY_AUDIO, false) {
+  size_t size = 0;
+  for (uint32_t i = 0; i < buffers->Length(); i++) {
+    Local<Value> buffer = buffers->Get(i);
+    if (buffer->IsArrayBufferView()) {
+      size += Local<ArrayBufferView>::Cast(buffer)->ByteLength();
+    }
+  }
+  externalMemory.Set(size);
+}
+AudioBuffer::~AudioBuffer() {
+  buffers.Reset();
+}
 Handle<Object> AudioBuffer::Initialize(Isolate *isolate) {
   Nan::EscapableHandleScope scope;
 
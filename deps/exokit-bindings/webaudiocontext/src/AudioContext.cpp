@@ -1,4 +1,5 @@
 #include <AudioContext.h>
+#include <trace.h>
 
 namespace webaudio {
 
@@ -481,6 +482,7 @@ NAN_GETTER(AudioContext::SampleRateGetter) {
 }
 
 void QueueOnMainThread(lab::ContextRenderLock &r, function<void()> &&newThreadFn) {
+  TRACE_SCOPE("audio", "QueueOnMainThread");
   threadFn = std::move(newThreadFn);
 
   {
@@ -492,6 +494,7 @@ void QueueOnMainThread(lab::ContextRenderLock &r, function<void()> &&newThreadFn
   threadFn = function<void()>();
 }
 void RunInMainThread(uv_async_t *handle) {
+  TRACE_SCOPE("audio", "RunInMainThread");
   threadFn();
   uv_sem_post(&threadSemaphore);
 }
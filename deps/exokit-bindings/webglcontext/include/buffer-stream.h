@@ -0,0 +1,50 @@
+#ifndef _WEBGLCONTEXT_BUFFER_STREAM_H_
+#define _WEBGLCONTEXT_BUFFER_STREAM_H_
+
+#include <webgl.h>
+
+#include <cstdint>
+#include <cstring>
+
+// Persistently mapped buffers need glBufferStorage (GL 4.4 / ARB_buffer_storage); GLES only has EXT_buffer_storage.
+#if defined(LUMIN) || defined(__ANDROID__) || (defined(__APPLE__) && TARGET_OS_IPHONE)
+#define BUFFER_STORAGE_SUPPORTED 0
+#else
+#define BUFFER_STORAGE_SUPPORTED 1
+#endif
+
+#define BUFFER_STREAM_RING_SIZE (8 * 1024 * 1024)
+#define BUFFER_STREAM_SEGMENTS 4
+
+// Staging ring for bufferSubData on dynamic buffers. Uploads are memcpy'd into a persistently mapped, coherent
+// buffer and copied to their destination on the GPU. Each quarter of the ring is fenced once it fills up; if the
+// next quarter is still in flight the upload is refused (and counted as a stall) rather than waited on.
+class BufferStream {
+public:
+  BufferStream();
+  ~BufferStream();
+
+  static bool IsSupported();
+  // ring offset of the written bytes, or -1 if the caller must upload directly
+  GLintptr Write(const void *data, GLsizeiptr size);
+  GLuint GetBuffer() const;
+  void DeleteBuffers();
+
+  uint32_t orphans;
+  uint32_t streamed;
+  uint32_t stalls;
+  uint32_t direct;
+  uint64_t bytes;
+
+private:
+  bool Init();
+
+  GLuint buffer;
+  char *mapped;
+  bool failed;
+  int segment;
+  GLsizeiptr offset;
+  GLsync fences[BUFFER_STREAM_SEGMENTS];
+};
+
+#endif
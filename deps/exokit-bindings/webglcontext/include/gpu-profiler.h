@@ -0,0 +1,62 @@
+#ifndef _WEBGLCONTEXT_GPU_PROFILER_H_
+#define _WEBGLCONTEXT_GPU_PROFILER_H_
+
+#include <webgl.h>
+
+#include <cstdint>
+#include <cstring>
+
+// GL_TIMESTAMP queries need desktop GL; GLES targets only have them through EXT_disjoint_timer_query.
+#if defined(LUMIN) || defined(__ANDROID__) || (defined(__APPLE__) && TARGET_OS_IPHONE)
+#define GPU_TIMERS_SUPPORTED 0
+#else
+#define GPU_TIMERS_SUPPORTED 1
+#endif
+
+#ifndef GL_GPU_DISJOINT_EXT
+#define GL_GPU_DISJOINT_EXT 0x8FBB
+#endif
+
+#define GPU_TIMER_RING_SIZE 4
+
+enum GpuTimerPhase {
+  GPU_TIMER_PHASE_DRAW,
+  GPU_TIMER_PHASE_COMPOSE,
+  GPU_TIMER_PHASE_BLIT,
+  GPU_TIMER_PHASE_COUNT,
+};
+
+// Per-phase GPU frame timing with rings of GL_TIMESTAMP query pairs. Timestamps never occupy the single
+// GL_TIME_ELAPSED slot, so content's own elapsed-time queries keep working while profiling. Results are read
+// back only once GL_QUERY_RESULT_AVAILABLE says so; if a phase's ring is full the sample is dropped rather than waited on.
+class GpuProfiler {
+public:
+  GpuProfiler();
+  ~GpuProfiler();
+
+  static bool IsSupported();
+  void Begin(GpuTimerPhase phase);
+  void End(GpuTimerPhase phase);
+  void Poll();
+  void DeleteQueries();
+
+  // mean nanoseconds per sample since the last Reset, or -1 if there were none
+  double GetMean(GpuTimerPhase phase) const;
+  uint32_t GetSamples(GpuTimerPhase phase) const;
+  uint32_t GetDropped(GpuTimerPhase phase) const;
+  void Reset();
+
+private:
+  void Poll(GpuTimerPhase phase);
+
+  // [begin, end] timestamp per sample
+  GLuint queries[GPU_TIMER_PHASE_COUNT][GPU_TIMER_RING_SIZE][2];
+  int heads[GPU_TIMER_PHASE_COUNT];
+  int numPending[GPU_TIMER_PHASE_COUNT];
+  bool active[GPU_TIMER_PHASE_COUNT];
+  uint64_t totals[GPU_TIMER_PHASE_COUNT];
+  uint32_t samples[GPU_TIMER_PHASE_COUNT];
+  uint32_t dropped[GPU_TIMER_PHASE_COUNT];
+};
+
+#endif
@@ -10,6 +10,8 @@
 
 #include <nan.h>
 
+#include <vector>
+
 #if defined(LUMIN) || defined(__ANDROID__)
 #ifndef GL_GLEXT_PROTOTYPES
 #define GL_GLEXT_PROTOTYPES
@@ -70,6 +72,7 @@
 #define MAX_CLIENT_WAIT_TIMEOUT_WEBGL ((uint32_t)2e7)
 
 #include <defines.h>
+#include <external-memory.h>
 
 #if !defined(LUMIN) && !defined(__ANDROID__)
 #include <glfw/include/glfw.h>
@@ -84,6 +87,9 @@ enum GlKey {
   GL_KEY_COMPOSE,
 };
 
+class GpuProfiler;
+class BufferStream;
+
 void flipImageData(char *dstData, char *srcData, size_t width, size_t height, size_t pixelSize);
 
 class ViewportState {
@@ -110,6 +116,22 @@ public:
   bool valid;
 };
 
+class BufferReadback {
+public:
+  BufferReadback(GLsync sync = nullptr, GLsizeiptr size = 0);
+
+  GLsync sync;
+  GLsizeiptr size;
+};
+
+class BufferStorage {
+public:
+  BufferStorage(GLenum usage = 0, GLsizeiptr size = 0);
+
+  GLenum usage;
+  GLsizeiptr size;
+};
+
 class WebGLRenderingContext : public ObjectWrap {
 public:
   static std::pair<Local<Object>, Local<FunctionTemplate>> Initialize(Isolate *isolate);
@@ -166,6 +188,12 @@ public:
   static NAN_METHOD(DrawArrays);
   static NAN_METHOD(DrawArraysInstanced);
   static NAN_METHOD(DrawArraysInstancedANGLE);
+  static NAN_METHOD(MultiDrawArraysWEBGL);
+  static NAN_METHOD(MultiDrawElementsWEBGL);
+  static NAN_METHOD(MultiDrawArraysInstancedWEBGL);
+  static NAN_METHOD(MultiDrawElementsInstancedWEBGL);
+  static NAN_METHOD(DrawArraysInstancedBaseInstanceWEBGL);
+  static NAN_METHOD(DrawElementsInstancedBaseVertexBaseInstanceWEBGL);
   static NAN_METHOD(GenerateMipmap);
   static NAN_METHOD(GetAttribLocation);
   static NAN_METHOD(DepthFunc);
@@ -198,10 +226,24 @@ public:
   static NAN_METHOD(CreateBuffer);
   static NAN_METHOD(BindBuffer);
   static NAN_METHOD(BindBufferBase);
+  static NAN_METHOD(BindBufferRange);
+  static NAN_METHOD(CopyBufferSubData);
+  static NAN_METHOD(GetBufferSubData);
+  static NAN_METHOD(BeginBufferReadback);
+  static NAN_METHOD(FinishBufferReadback);
+  static NAN_METHOD(DeleteBufferReadback);
   static NAN_METHOD(CreateFramebuffer);
   static NAN_METHOD(BindFramebuffer);
   static NAN_METHOD(BindFramebufferRaw);
   static NAN_METHOD(FramebufferTexture2D);
+  static NAN_METHOD(FramebufferTextureLayer);
+  static NAN_METHOD(InvalidateFramebuffer);
+  static NAN_METHOD(InvalidateSubFramebuffer);
+  static NAN_METHOD(ReadBuffer);
+  static NAN_METHOD(ClearBufferfv);
+  static NAN_METHOD(ClearBufferiv);
+  static NAN_METHOD(ClearBufferuiv);
+  static NAN_METHOD(ClearBufferfi);
   static NAN_METHOD(BlitFramebuffer);
   static NAN_METHOD(BufferData);
   static NAN_METHOD(BufferSubData);
@@ -285,11 +327,18 @@ public:
   static NAN_METHOD(IsSync);
 
   static NAN_METHOD(RenderbufferStorage);
+  static NAN_METHOD(RenderbufferStorageMultisample);
   static NAN_METHOD(GetShaderSource);
   static NAN_METHOD(ValidateProgram);
 
   static NAN_METHOD(TexSubImage2D);
   static NAN_METHOD(TexStorage2D);
+  static NAN_METHOD(TexImage3D);
+  static NAN_METHOD(TexSubImage3D);
+  static NAN_METHOD(TexStorage3D);
+  static NAN_METHOD(CompressedTexImage3D);
+  static NAN_METHOD(CompressedTexSubImage3D);
+  static NAN_METHOD(CopyTexSubImage3D);
 
   static NAN_METHOD(ReadPixels);
   static NAN_METHOD(GetTexParameter);
@@ -305,6 +354,9 @@ public:
   static NAN_METHOD(GetVertexAttrib);
   static NAN_METHOD(GetSupportedExtensions);
   static NAN_METHOD(GetExtension);
+  static Local<Value> MakeExtension(Local<Object> glObj, const char *sname);
+  const std::vector<const char *> &GetSupportedExtensionNames();
+  bool IsExtensionSupported(const char *name);
   static NAN_METHOD(CheckFramebufferStatus);
 
   static NAN_METHOD(CreateVertexArray);
@@ -312,16 +364,50 @@ public:
   static NAN_METHOD(BindVertexArray);
   static NAN_METHOD(BindVertexArrayOES);
 
+  static NAN_METHOD(CreateTransformFeedback);
+  static NAN_METHOD(DeleteTransformFeedback);
+  static NAN_METHOD(IsTransformFeedback);
+  static NAN_METHOD(BindTransformFeedback);
+  static NAN_METHOD(BeginTransformFeedback);
+  static NAN_METHOD(EndTransformFeedback);
+  static NAN_METHOD(PauseTransformFeedback);
+  static NAN_METHOD(ResumeTransformFeedback);
+  static NAN_METHOD(TransformFeedbackVaryings);
+  static NAN_METHOD(GetTransformFeedbackVarying);
+
   static NAN_METHOD(FenceSync);
   static NAN_METHOD(DeleteSync);
   static NAN_METHOD(ClientWaitSync);
   static NAN_METHOD(WaitSync);
   static NAN_METHOD(GetSyncParameter);
 
+  static NAN_METHOD(CreateQuery);
+  static NAN_METHOD(DeleteQuery);
+  static NAN_METHOD(IsQuery);
+  static NAN_METHOD(BeginQuery);
+  static NAN_METHOD(EndQuery);
+  static NAN_METHOD(GetQuery);
+  static NAN_METHOD(GetQueryParameter);
+  static NAN_METHOD(QueryCounterEXT);
+
+  static NAN_METHOD(CreateSampler);
+  static NAN_METHOD(DeleteSampler);
+  static NAN_METHOD(IsSampler);
+  static NAN_METHOD(BindSampler);
+  static NAN_METHOD(SamplerParameteri);
+  static NAN_METHOD(SamplerParameterf);
+  static NAN_METHOD(GetSamplerParameter);
+
   static NAN_METHOD(FrontFace);
 
   static NAN_METHOD(IsContextLost);
 
+  static NAN_METHOD(SetGpuTimersEnabled);
+  static NAN_METHOD(BeginGpuTimer);
+  static NAN_METHOD(EndGpuTimer);
+  static NAN_METHOD(GetGpuTimes);
+  static NAN_METHOD(GetBufferUploadStats);
+
   static NAN_GETTER(DrawingBufferWidthGetter);
   static NAN_GETTER(DrawingBufferHeightGetter);
 
@@ -378,6 +464,16 @@ public:
     return textureBindings.find(std::make_pair(framebuffer, target)) != textureBindings.end();
   }
 
+  void SetSamplerBinding(GLuint unit, GLuint sampler) {
+    samplerBindings[unit] = sampler;
+  }
+  GLuint GetSamplerBinding(GLuint unit) {
+    return samplerBindings[unit];
+  }
+  bool HasSamplerBinding(GLuint unit) {
+    return samplerBindings.find(unit) != samplerBindings.end();
+  }
+
   void SetProgramBinding(GLuint program) {
     programBindings[GL_VERTEX_SHADER] = program;
   }
@@ -388,6 +484,9 @@ public:
     return programBindings.find(GL_VERTEX_SHADER) != programBindings.end();
   }
 
+  void SetTextureMemory(GLenum target, GLint level, size_t size);
+  void DeleteTextureMemory(GLuint texture);
+
   bool live;
   NATIVEwindow *windowHandle;
   GLuint defaultVao;
@@ -403,10 +502,22 @@ public:
   std::map<GLenum, GLuint> renderbufferBindings;
   std::map<GLenum, GLuint> bufferBindings;
   std::map<std::pair<GLenum, GLenum>, GLuint> textureBindings;
+  std::map<GLuint, GLuint> samplerBindings;
   std::map<GLenum, GLuint> programBindings;
   ViewportState viewportState;
   ColorMaskState colorMaskState;
   std::map<GlKey, void *> keys;
+  // staging buffer -> fence for readbacks started with beginBufferReadback
+  std::map<GLuint, BufferReadback> bufferReadbacks;
+  // buffer -> usage and size from its last bufferData, so bufferSubData does not query the driver
+  std::map<GLuint, BufferStorage> bufferStorages;
+  bool supportedExtensionsQueried;
+  std::vector<const char *> supportedExtensions;
+  GpuProfiler *gpuProfiler;
+  BufferStream *bufferStream;
+  // estimated bytes per (texture, face target << 8 | level), summed into textureMemory
+  std::map<std::pair<GLuint, uint32_t>, size_t> textureLevelSizes;
+  externalmemory::ExternalMemory textureMemory;
 };
 
 class WebGL2RenderingContext : public WebGLRenderingContext {
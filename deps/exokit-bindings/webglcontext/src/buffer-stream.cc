@@ -0,0 +1,97 @@
+#include <webglcontext/include/buffer-stream.h>
+
+#define BUFFER_STREAM_SEGMENT_SIZE (BUFFER_STREAM_RING_SIZE / BUFFER_STREAM_SEGMENTS)
+
+BufferStream::BufferStream() : orphans(0), streamed(0), stalls(0), direct(0), bytes(0), buffer(0), mapped(nullptr), failed(false), segment(0), offset(0) {
+  memset(fences, 0, sizeof(fences));
+}
+
+// GL objects are released by DeleteBuffers, which must run with the owning context current.
+BufferStream::~BufferStream() {}
+
+bool BufferStream::IsSupported() {
+#if BUFFER_STORAGE_SUPPORTED
+  return GLEW_ARB_buffer_storage;
+#else
+  return false;
+#endif
+}
+
+bool BufferStream::Init() {
+#if BUFFER_STORAGE_SUPPORTED
+  if (!failed && IsSupported()) {
+    GLint oldBinding;
+    glGetIntegerv(GL_COPY_READ_BUFFER_BINDING, &oldBinding);
+
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+    glBufferStorage(GL_COPY_READ_BUFFER, BUFFER_STREAM_RING_SIZE, nullptr, flags);
+    mapped = (char *)glMapBufferRange(GL_COPY_READ_BUFFER, 0, BUFFER_STREAM_RING_SIZE, flags);
+    glBindBuffer(GL_COPY_READ_BUFFER, oldBinding);
+
+    if (!mapped) {
+      glDeleteBuffers(1, &buffer);
+      buffer = 0;
+    }
+  }
+#endif
+  failed = !mapped;
+  return mapped;
+}
+
+GLintptr BufferStream::Write(const void *data, GLsizeiptr size) {
+  if (size <= 0 || size > BUFFER_STREAM_SEGMENT_SIZE || (!mapped && !Init())) {
+    return -1;
+  }
+
+  if (offset + size > BUFFER_STREAM_SEGMENT_SIZE) {
+    int nextSegment = (segment + 1) % BUFFER_STREAM_SEGMENTS;
+    GLsync &nextFence = fences[nextSegment];
+    if (nextFence) {
+      GLenum status = glClientWaitSync(nextFence, 0, 0);
+      if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+        stalls++;
+        return -1;
+      }
+      glDeleteSync(nextFence);
+      nextFence = nullptr;
+    }
+
+    fences[segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    segment = nextSegment;
+    offset = 0;
+  }
+
+  GLintptr ringOffset = segment * BUFFER_STREAM_SEGMENT_SIZE + offset;
+  memcpy(mapped + ringOffset, data, size);
+  offset += size;
+  streamed++;
+  bytes += size;
+  return ringOffset;
+}
+
+GLuint BufferStream::GetBuffer() const {
+  return buffer;
+}
+
+void BufferStream::DeleteBuffers() {
+  for (int i = 0; i < BUFFER_STREAM_SEGMENTS; i++) {
+    if (fences[i]) {
+      glDeleteSync(fences[i]);
+      fences[i] = nullptr;
+    }
+  }
+  if (buffer) {
+    GLint oldBinding;
+    glGetIntegerv(GL_COPY_READ_BUFFER_BINDING, &oldBinding);
+    glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+    glUnmapBuffer(GL_COPY_READ_BUFFER);
+    glBindBuffer(GL_COPY_READ_BUFFER, (GLuint)oldBinding == buffer ? 0 : oldBinding);
+    glDeleteBuffers(1, &buffer);
+    buffer = 0;
+  }
+  mapped = nullptr;
+  segment = 0;
+  offset = 0;
+}
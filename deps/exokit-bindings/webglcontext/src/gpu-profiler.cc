@@ -0,0 +1,101 @@
+#include <webglcontext/include/gpu-profiler.h>
+
+GpuProfiler::GpuProfiler() {
+#if GPU_TIMERS_SUPPORTED
+  glGenQueries(GPU_TIMER_PHASE_COUNT * GPU_TIMER_RING_SIZE * 2, &queries[0][0][0]);
+#else
+  memset(queries, 0, sizeof(queries));
+#endif
+  memset(heads, 0, sizeof(heads));
+  memset(numPending, 0, sizeof(numPending));
+  memset(active, 0, sizeof(active));
+  Reset();
+}
+
+// GL objects are released by DeleteQueries, which must run with the owning context current.
+GpuProfiler::~GpuProfiler() {}
+
+bool GpuProfiler::IsSupported() {
+  return GPU_TIMERS_SUPPORTED;
+}
+
+void GpuProfiler::Begin(GpuTimerPhase phase) {
+#if GPU_TIMERS_SUPPORTED
+  Poll(phase);
+
+  if (!active[phase] && numPending[phase] < GPU_TIMER_RING_SIZE) {
+    glQueryCounter(queries[phase][heads[phase]][0], GL_TIMESTAMP);
+    active[phase] = true;
+  } else {
+    dropped[phase]++;
+  }
+#endif
+}
+
+void GpuProfiler::End(GpuTimerPhase phase) {
+#if GPU_TIMERS_SUPPORTED
+  if (active[phase]) {
+    glQueryCounter(queries[phase][heads[phase]][1], GL_TIMESTAMP);
+    heads[phase] = (heads[phase] + 1) % GPU_TIMER_RING_SIZE;
+    numPending[phase]++;
+    active[phase] = false;
+  }
+#endif
+}
+
+void GpuProfiler::Poll() {
+  for (int i = 0; i < GPU_TIMER_PHASE_COUNT; i++) {
+    Poll((GpuTimerPhase)i);
+  }
+}
+
+void GpuProfiler::Poll(GpuTimerPhase phase) {
+#if GPU_TIMERS_SUPPORTED
+  while (numPending[phase] > 0) {
+    int tail = (heads[phase] - numPending[phase] + GPU_TIMER_RING_SIZE) % GPU_TIMER_RING_SIZE;
+    GLuint *pair = queries[phase][tail];
+
+    // the end timestamp lands after the begin one
+    GLuint available = 0;
+    glGetQueryObjectuiv(pair[1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available) {
+      GLuint64 begin = 0;
+      GLuint64 end = 0;
+      glGetQueryObjectui64v(pair[0], GL_QUERY_RESULT, &begin);
+      glGetQueryObjectui64v(pair[1], GL_QUERY_RESULT, &end);
+      totals[phase] += end > begin ? end - begin : 0;
+      samples[phase]++;
+      numPending[phase]--;
+    } else {
+      break;
+    }
+  }
+#endif
+}
+
+void GpuProfiler::DeleteQueries() {
+#if GPU_TIMERS_SUPPORTED
+  glDeleteQueries(GPU_TIMER_PHASE_COUNT * GPU_TIMER_RING_SIZE * 2, &queries[0][0][0]);
+  memset(queries, 0, sizeof(queries));
+  memset(numPending, 0, sizeof(numPending));
+  memset(active, 0, sizeof(active));
+#endif
+}
+
+double GpuProfiler::GetMean(GpuTimerPhase phase) const {
+  return samples[phase] > 0 ? (double)totals[phase] / (double)samples[phase] : -1;
+}
+
+uint32_t GpuProfiler::GetSamples(GpuTimerPhase phase) const {
+  return samples[phase];
+}
+
+uint32_t GpuProfiler::GetDropped(GpuTimerPhase phase) const {
+  return dropped[phase];
+}
+
+void GpuProfiler::Reset() {
+  memset(totals, 0, sizeof(totals));
+  memset(samples, 0, sizeof(samples));
+  memset(dropped, 0, sizeof(dropped));
+}
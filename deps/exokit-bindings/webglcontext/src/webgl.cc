@@ -1,7 +1,13 @@
+#include <algorithm>
 #include <cstring>
+#include <set>
+#include <string>
 #include <vector>
 
 #include <webglcontext/include/webgl.h>
+#include <webglcontext/include/gpu-profiler.h>
+#include <webglcontext/include/buffer-stream.h>
+#include <trace.h>
 #include <canvascontext/include/imageData-context.h>
 // #include <node.h>
 
@@ -47,7 +53,13 @@ NAN_METHOD(glCallWrap) {
       windowsystem::SetCurrentWindowContext(gl->windowHandle);
     }
 
-    F(info);
+    if (trace::IsEnabled()) {
+      static const char *traceName = trace::InternFunctionName(TRACE_FUNCTION_SIGNATURE);
+      TRACE_SCOPE("gl", traceName);
+      F(info);
+    } else {
+      F(info);
+    }
   }
 }
 template<NAN_METHOD(F)>
@@ -64,6 +76,25 @@ NAN_METHOD(glSwitchCallWrap) {
     F(info);
   }
 }
+// For methods on extension objects, whose context is their "context" property rather than the receiver.
+template<NAN_METHOD(F)>
+NAN_METHOD(glExtensionCallWrap) {
+  Local<Object> glObj = Local<Object>::Cast(info.This()->Get(JS_STR("context")));
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(glObj);
+  if (gl->live) {
+    if (gl->windowHandle) {
+      windowsystem::SetCurrentWindowContext(gl->windowHandle);
+    }
+
+    if (trace::IsEnabled()) {
+      static const char *traceName = trace::InternFunctionName(TRACE_FUNCTION_SIGNATURE);
+      TRACE_SCOPE("gl", traceName);
+      F(info);
+    } else {
+      F(info);
+    }
+  }
+}
 
 template <typename T>
 void setGlConstants(T &proto) {
@@ -150,10 +181,36 @@ void setGlConstants(T &proto) {
   JS_GL_CONSTANT(UNIFORM_BUFFER);
   JS_GL_CONSTANT(PIXEL_PACK_BUFFER);
   JS_GL_CONSTANT(PIXEL_UNPACK_BUFFER);
+  JS_GL_CONSTANT(UNIFORM_BUFFER_BINDING);
+  JS_GL_CONSTANT(COPY_READ_BUFFER_BINDING);
+  JS_GL_CONSTANT(COPY_WRITE_BUFFER_BINDING);
+
+  /* Transform feedback */
+  JS_GL_CONSTANT(TRANSFORM_FEEDBACK);
+  JS_GL_CONSTANT(TRANSFORM_FEEDBACK_BINDING);
+  JS_GL_CONSTANT(TRANSFORM_FEEDBACK_ACTIVE);
+  JS_GL_CONSTANT(TRANSFORM_FEEDBACK_PAUSED);
+  JS_GL_CONSTANT(TRANSFORM_FEEDBACK_BUFFER_BINDING);
+  JS_GL_CONSTANT(TRANSFORM_FEEDBACK_BUFFER_START);
+  JS_GL_CONSTANT(TRANSFORM_FEEDBACK_BUFFER_SIZE);
+  JS_GL_CONSTANT(TRANSFORM_FEEDBACK_BUFFER_MODE);
+  JS_GL_CONSTANT(TRANSFORM_FEEDBACK_VARYINGS);
+  JS_GL_CONSTANT(INTERLEAVED_ATTRIBS);
+  JS_GL_CONSTANT(SEPARATE_ATTRIBS);
+  JS_GL_CONSTANT(RASTERIZER_DISCARD);
+  JS_GL_CONSTANT(MAX_TRANSFORM_FEEDBACK_SEPARATE_ATTRIBS);
+  JS_GL_CONSTANT(MAX_TRANSFORM_FEEDBACK_INTERLEAVED_COMPONENTS);
+  JS_GL_CONSTANT(MAX_TRANSFORM_FEEDBACK_SEPARATE_COMPONENTS);
 
   JS_GL_CONSTANT(STREAM_DRAW);
   JS_GL_CONSTANT(STATIC_DRAW);
   JS_GL_CONSTANT(DYNAMIC_DRAW);
+  JS_GL_CONSTANT(STREAM_READ);
+  JS_GL_CONSTANT(STATIC_READ);
+  JS_GL_CONSTANT(DYNAMIC_READ);
+  JS_GL_CONSTANT(STREAM_COPY);
+  JS_GL_CONSTANT(STATIC_COPY);
+  JS_GL_CONSTANT(DYNAMIC_COPY);
 
   JS_GL_CONSTANT(BUFFER_SIZE);
   JS_GL_CONSTANT(BUFFER_USAGE);
@@ -375,6 +432,32 @@ void setGlConstants(T &proto) {
   JS_GL_CONSTANT(TEXTURE_CUBE_MAP_NEGATIVE_Z);
   JS_GL_CONSTANT(MAX_CUBE_MAP_TEXTURE_SIZE);
 
+  /* 3D and array textures */
+  JS_GL_CONSTANT(TEXTURE_3D);
+  JS_GL_CONSTANT(TEXTURE_2D_ARRAY);
+  JS_GL_CONSTANT(TEXTURE_BINDING_3D);
+  JS_GL_CONSTANT(TEXTURE_BINDING_2D_ARRAY);
+  JS_GL_CONSTANT(TEXTURE_WRAP_R);
+  JS_GL_CONSTANT(TEXTURE_BASE_LEVEL);
+  JS_GL_CONSTANT(TEXTURE_MAX_LEVEL);
+  JS_GL_CONSTANT(TEXTURE_MIN_LOD);
+  JS_GL_CONSTANT(TEXTURE_MAX_LOD);
+  JS_GL_CONSTANT(TEXTURE_IMMUTABLE_FORMAT);
+  JS_GL_CONSTANT(TEXTURE_IMMUTABLE_LEVELS);
+  JS_GL_CONSTANT(MAX_3D_TEXTURE_SIZE);
+  JS_GL_CONSTANT(MAX_ARRAY_TEXTURE_LAYERS);
+  JS_GL_CONSTANT(UNPACK_ROW_LENGTH);
+  JS_GL_CONSTANT(UNPACK_SKIP_ROWS);
+  JS_GL_CONSTANT(UNPACK_SKIP_PIXELS);
+  JS_GL_CONSTANT(UNPACK_IMAGE_HEIGHT);
+  JS_GL_CONSTANT(UNPACK_SKIP_IMAGES);
+
+  /* Samplers */
+  JS_GL_CONSTANT(SAMPLER_BINDING);
+  JS_GL_CONSTANT(TEXTURE_COMPARE_MODE);
+  JS_GL_CONSTANT(TEXTURE_COMPARE_FUNC);
+  JS_GL_CONSTANT(COMPARE_REF_TO_TEXTURE);
+
   /* TextureUnit */
   JS_GL_CONSTANT(TEXTURE0);
   JS_GL_CONSTANT(TEXTURE1);
@@ -487,6 +570,9 @@ void setGlConstants(T &proto) {
   JS_GL_CONSTANT(STENCIL_INDEX8);
   JS_GL_CONSTANT(DEPTH_STENCIL);
   JS_GL_CONSTANT(DEPTH24_STENCIL8);
+  JS_GL_CONSTANT(DEPTH_COMPONENT24);
+  JS_GL_CONSTANT(DEPTH_COMPONENT32F);
+  JS_GL_CONSTANT(DEPTH32F_STENCIL8);
 
   JS_GL_CONSTANT(RENDERBUFFER_WIDTH);
   JS_GL_CONSTANT(RENDERBUFFER_HEIGHT);
@@ -497,6 +583,12 @@ void setGlConstants(T &proto) {
   JS_GL_CONSTANT(RENDERBUFFER_ALPHA_SIZE);
   JS_GL_CONSTANT(RENDERBUFFER_DEPTH_SIZE);
   JS_GL_CONSTANT(RENDERBUFFER_STENCIL_SIZE);
+  JS_GL_CONSTANT(RENDERBUFFER_SAMPLES);
+  JS_GL_CONSTANT(MAX_SAMPLES);
+  JS_GL_CONSTANT(READ_BUFFER);
+  JS_GL_CONSTANT(COLOR);
+  JS_GL_CONSTANT(DEPTH);
+  JS_GL_CONSTANT(STENCIL);
 
   JS_GL_CONSTANT(FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE);
   JS_GL_CONSTANT(FRAMEBUFFER_ATTACHMENT_OBJECT_NAME);
@@ -578,6 +670,14 @@ void setGlConstants(T &proto) {
   double GL_TIMEOUT_IGNORED_TEMP_DOUBLE = *(double *)(&GL_TIMEOUT_IGNORED_TEMP_64);
   proto->Set(JS_STR("TIMEOUT_IGNORED"), Nan::New<v8::Number>(GL_TIMEOUT_IGNORED_TEMP_DOUBLE));
 
+  /* Queries */
+  JS_GL_CONSTANT(ANY_SAMPLES_PASSED);
+  JS_GL_CONSTANT(ANY_SAMPLES_PASSED_CONSERVATIVE);
+  JS_GL_CONSTANT(TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN);
+  JS_GL_CONSTANT(CURRENT_QUERY);
+  JS_GL_CONSTANT(QUERY_RESULT);
+  JS_GL_CONSTANT(QUERY_RESULT_AVAILABLE);
+
   /* Floating Point Textures */
   JS_GL_CONSTANT(HALF_FLOAT);
   JS_GL_CONSTANT(FLOAT);
@@ -625,8 +725,17 @@ void setGlConstants(T &proto) {
 
   // external
   JS_GL_SET_CONSTANT("TEXTURE_EXTERNAL_OES", 0x8D65);
+
+  // gpu timer phases
+  JS_GL_SET_CONSTANT("GPU_TIMER_DRAW", GPU_TIMER_PHASE_DRAW);
+  JS_GL_SET_CONSTANT("GPU_TIMER_COMPOSE", GPU_TIMER_PHASE_COMPOSE);
+  JS_GL_SET_CONSTANT("GPU_TIMER_BLIT", GPU_TIMER_PHASE_BLIT);
 }
 
+BufferReadback::BufferReadback(GLsync sync, GLsizeiptr size) : sync(sync), size(size) {}
+
+BufferStorage::BufferStorage(GLenum usage, GLsizeiptr size) : usage(usage), size(size) {}
+
 ViewportState::ViewportState(GLint x, GLint y, GLsizei w, GLsizei h, bool valid) : x(x), y(y), w(w), h(h), valid(valid) {}
 
 ViewportState &ViewportState::operator=(const ViewportState &viewportState) {
@@ -747,10 +856,24 @@ std::pair<Local<Object>, Local<FunctionTemplate>> WebGLRenderingContext::Initial
   Nan::SetMethod(proto, "bindFramebuffer", glCallWrap<BindFramebuffer>);
   Nan::SetMethod(proto, "bindFramebufferRaw", glCallWrap<BindFramebufferRaw>);
   Nan::SetMethod(proto, "framebufferTexture2D", glCallWrap<FramebufferTexture2D>);
+  Nan::SetMethod(proto, "framebufferTextureLayer", glCallWrap<FramebufferTextureLayer>);
   Nan::SetMethod(proto, "blitFramebuffer", glCallWrap<BlitFramebuffer>);
+  Nan::SetMethod(proto, "invalidateFramebuffer", glCallWrap<InvalidateFramebuffer>);
+  Nan::SetMethod(proto, "invalidateSubFramebuffer", glCallWrap<InvalidateSubFramebuffer>);
+  Nan::SetMethod(proto, "readBuffer", glCallWrap<ReadBuffer>);
+  Nan::SetMethod(proto, "clearBufferfv", glCallWrap<ClearBufferfv>);
+  Nan::SetMethod(proto, "clearBufferiv", glCallWrap<ClearBufferiv>);
+  Nan::SetMethod(proto, "clearBufferuiv", glCallWrap<ClearBufferuiv>);
+  Nan::SetMethod(proto, "clearBufferfi", glCallWrap<ClearBufferfi>);
   Nan::SetMethod(proto, "createBuffer", glCallWrap<CreateBuffer>);
   Nan::SetMethod(proto, "bindBuffer", glCallWrap<BindBuffer>);
   Nan::SetMethod(proto, "bindBufferBase", glCallWrap<BindBufferBase>);
+  Nan::SetMethod(proto, "bindBufferRange", glCallWrap<BindBufferRange>);
+  Nan::SetMethod(proto, "copyBufferSubData", glCallWrap<CopyBufferSubData>);
+  Nan::SetMethod(proto, "getBufferSubData", glCallWrap<GetBufferSubData>);
+  Nan::SetMethod(proto, "beginBufferReadback", glCallWrap<BeginBufferReadback>);
+  Nan::SetMethod(proto, "finishBufferReadback", glCallWrap<FinishBufferReadback>);
+  Nan::SetMethod(proto, "deleteBufferReadback", glCallWrap<DeleteBufferReadback>);
   Nan::SetMethod(proto, "bufferData", glCallWrap<BufferData>);
   Nan::SetMethod(proto, "bufferSubData", glCallWrap<BufferSubData>);
   Nan::SetMethod(proto, "enable", glCallWrap<Enable>);
@@ -833,11 +956,18 @@ std::pair<Local<Object>, Local<FunctionTemplate>> WebGLRenderingContext::Initial
   Nan::SetMethod(proto, "isSync", glCallWrap<IsSync>);
 
   Nan::SetMethod(proto, "renderbufferStorage", glCallWrap<RenderbufferStorage>);
+  Nan::SetMethod(proto, "renderbufferStorageMultisample", glCallWrap<RenderbufferStorageMultisample>);
   Nan::SetMethod(proto, "getShaderSource", glCallWrap<GetShaderSource>);
   Nan::SetMethod(proto, "validateProgram", glCallWrap<ValidateProgram>);
 
   Nan::SetMethod(proto, "texSubImage2D", glCallWrap<TexSubImage2D>);
   Nan::SetMethod(proto, "texStorage2D", glCallWrap<TexStorage2D>);
+  Nan::SetMethod(proto, "texImage3D", glCallWrap<TexImage3D>);
+  Nan::SetMethod(proto, "texSubImage3D", glCallWrap<TexSubImage3D>);
+  Nan::SetMethod(proto, "texStorage3D", glCallWrap<TexStorage3D>);
+  Nan::SetMethod(proto, "compressedTexImage3D", glCallWrap<CompressedTexImage3D>);
+  Nan::SetMethod(proto, "compressedTexSubImage3D", glCallWrap<CompressedTexSubImage3D>);
+  Nan::SetMethod(proto, "copyTexSubImage3D", glCallWrap<CopyTexSubImage3D>);
 
   Nan::SetMethod(proto, "readPixels", glCallWrap<ReadPixels>);
   Nan::SetMethod(proto, "getTexParameter", glCallWrap<GetTexParameter>);
@@ -859,15 +989,48 @@ std::pair<Local<Object>, Local<FunctionTemplate>> WebGLRenderingContext::Initial
   Nan::SetMethod(proto, "deleteVertexArray", glCallWrap<DeleteVertexArray>);
   Nan::SetMethod(proto, "bindVertexArray", glCallWrap<BindVertexArray>);
 
+  Nan::SetMethod(proto, "createTransformFeedback", glCallWrap<CreateTransformFeedback>);
+  Nan::SetMethod(proto, "deleteTransformFeedback", glCallWrap<DeleteTransformFeedback>);
+  Nan::SetMethod(proto, "isTransformFeedback", glCallWrap<IsTransformFeedback>);
+  Nan::SetMethod(proto, "bindTransformFeedback", glCallWrap<BindTransformFeedback>);
+  Nan::SetMethod(proto, "beginTransformFeedback", glCallWrap<BeginTransformFeedback>);
+  Nan::SetMethod(proto, "endTransformFeedback", glCallWrap<EndTransformFeedback>);
+  Nan::SetMethod(proto, "pauseTransformFeedback", glCallWrap<PauseTransformFeedback>);
+  Nan::SetMethod(proto, "resumeTransformFeedback", glCallWrap<ResumeTransformFeedback>);
+  Nan::SetMethod(proto, "transformFeedbackVaryings", glCallWrap<TransformFeedbackVaryings>);
+  Nan::SetMethod(proto, "getTransformFeedbackVarying", glCallWrap<GetTransformFeedbackVarying>);
+
   Nan::SetMethod(proto, "fenceSync", glCallWrap<FenceSync>);
   Nan::SetMethod(proto, "deleteSync", glCallWrap<DeleteSync>);
   Nan::SetMethod(proto, "clientWaitSync", glCallWrap<ClientWaitSync>);
   Nan::SetMethod(proto, "waitSync", glCallWrap<WaitSync>);
   Nan::SetMethod(proto, "getSyncParameter", glCallWrap<GetSyncParameter>);
 
+  Nan::SetMethod(proto, "createQuery", glCallWrap<CreateQuery>);
+  Nan::SetMethod(proto, "deleteQuery", glCallWrap<DeleteQuery>);
+  Nan::SetMethod(proto, "isQuery", glCallWrap<IsQuery>);
+  Nan::SetMethod(proto, "beginQuery", glCallWrap<BeginQuery>);
+  Nan::SetMethod(proto, "endQuery", glCallWrap<EndQuery>);
+  Nan::SetMethod(proto, "getQuery", glCallWrap<GetQuery>);
+  Nan::SetMethod(proto, "getQueryParameter", glCallWrap<GetQueryParameter>);
+
+  Nan::SetMethod(proto, "createSampler", glCallWrap<CreateSampler>);
+  Nan::SetMethod(proto, "deleteSampler", glCallWrap<DeleteSampler>);
+  Nan::SetMethod(proto, "isSampler", glCallWrap<IsSampler>);
+  Nan::SetMethod(proto, "bindSampler", glCallWrap<BindSampler>);
+  Nan::SetMethod(proto, "samplerParameteri", glCallWrap<SamplerParameteri>);
+  Nan::SetMethod(proto, "samplerParameterf", glCallWrap<SamplerParameterf>);
+  Nan::SetMethod(proto, "getSamplerParameter", glCallWrap<GetSamplerParameter>);
+
   Nan::SetMethod(proto, "frontFace", glCallWrap<FrontFace>);
 
-  Nan::SetMethod(proto, "isContextLost", glCallWrap<IsContextLost>);
+  Nan::SetMethod(proto, "isContextLost", IsContextLost);
+
+  Nan::SetMethod(proto, "setGpuTimersEnabled", glCallWrap<SetGpuTimersEnabled>);
+  Nan::SetMethod(proto, "beginGpuTimer", glCallWrap<BeginGpuTimer>);
+  Nan::SetMethod(proto, "endGpuTimer", glCallWrap<EndGpuTimer>);
+  Nan::SetMethod(proto, "getGpuTimes", glCallWrap<GetGpuTimes>);
+  Nan::SetMethod(proto, "getBufferUploadStats", glCallWrap<GetBufferUploadStats>);
 
   Nan::SetAccessor(proto, JS_STR("drawingBufferWidth"), DrawingBufferWidthGetter);
   Nan::SetAccessor(proto, JS_STR("drawingBufferHeight"), DrawingBufferHeightGetter);
@@ -894,10 +1057,18 @@ WebGLRenderingContext::WebGLRenderingContext() :
   premultiplyAlpha(true),
   packAlignment(4),
   unpackAlignment(4),
-  activeTexture(GL_TEXTURE0)
+  activeTexture(GL_TEXTURE0),
+  supportedExtensionsQueried(false),
+  gpuProfiler(nullptr),
+  bufferStream(new BufferStream()),
+  // GPU memory is not freed by the JS GC, so it is counted but not reported to V8
+  textureMemory(externalmemory::EXTERNAL_MEMORY_TEXTURE, false)
   {}
 
-WebGLRenderingContext::~WebGLRenderingContext() {}
+WebGLRenderingContext::~WebGLRenderingContext() {
+  delete gpuProfiler;
+  delete bufferStream;
+}
 
 NAN_METHOD(WebGLRenderingContext::New) {
   WebGLRenderingContext *gl = new WebGLRenderingContext();
@@ -909,7 +1080,49 @@ NAN_METHOD(WebGLRenderingContext::New) {
 
 NAN_METHOD(WebGLRenderingContext::Destroy) {
   WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+  if (gl->live) {
+    // the window and its context outlive this call, and GL objects live on in the shared context group
+    if (gl->windowHandle) {
+      windowsystem::SetCurrentWindowContext(gl->windowHandle);
+    }
+    for (auto iter = gl->bufferReadbacks.begin(); iter != gl->bufferReadbacks.end(); iter++) {
+      GLuint staging = iter->first;
+      glDeleteSync(iter->second.sync);
+      glDeleteBuffers(1, &staging);
+    }
+    gl->bufferStream->DeleteBuffers();
+    if (gl->gpuProfiler) {
+      gl->gpuProfiler->DeleteQueries();
+    }
+  }
   gl->live = false;
+  gl->bufferReadbacks.clear();
+  gl->bufferStorages.clear();
+  gl->textureLevelSizes.clear();
+  gl->textureMemory.Set(0);
+}
+
+void WebGLRenderingContext::SetTextureMemory(GLenum target, GLint level, size_t size) {
+  GLenum bindingTarget = (target >= GL_TEXTURE_CUBE_MAP_POSITIVE_X && target <= GL_TEXTURE_CUBE_MAP_NEGATIVE_Z) ? GL_TEXTURE_CUBE_MAP : target;
+  if (HasTextureBinding(activeTexture, bindingTarget)) {
+    GLuint texture = GetTextureBinding(activeTexture, bindingTarget);
+    if (texture != 0) {
+      size_t &levelSize = textureLevelSizes[std::make_pair(texture, (uint32_t)((target << 8) | (level & 0xFF)))];
+      textureMemory.Set(textureMemory.Get() - levelSize + size);
+      levelSize = size;
+    }
+  }
+}
+
+void WebGLRenderingContext::DeleteTextureMemory(GLuint texture) {
+  auto begin = textureLevelSizes.lower_bound(std::make_pair(texture, (uint32_t)0));
+  auto end = textureLevelSizes.lower_bound(std::make_pair(texture + 1, (uint32_t)0));
+  size_t size = 0;
+  for (auto iter = begin; iter != end; iter++) {
+    size += iter->second;
+  }
+  textureLevelSizes.erase(begin, end);
+  textureMemory.Set(textureMemory.Get() - size);
 }
 
 NAN_METHOD(WebGLRenderingContext::GetWindowHandle) {
@@ -2072,7 +2285,8 @@ NAN_METHOD(WebGLRenderingContext::FrontFace) {
 }
 
 NAN_METHOD(WebGLRenderingContext::IsContextLost) {
-  info.GetReturnValue().Set(JS_BOOL(false));
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+  info.GetReturnValue().Set(JS_BOOL(!gl->live));
 }
 
 NAN_GETTER(WebGLRenderingContext::DrawingBufferWidthGetter) {
@@ -2191,9 +2405,69 @@ NAN_METHOD(WebGLRenderingContext::AttachShader) {
 }
 
 
+Local<Object> makeUniformLocation(GLint location) {
+  Local<Object> locationObject = Nan::New<Object>();
+  locationObject->Set(JS_STR("id"), JS_INT(location));
+  return locationObject;
+}
+
+// Builds the name -> location object table for a freshly linked program, so that getUniformLocation answers
+// from memory with identity-stable objects. Array uniforms are entered under their base name and every element.
+Local<v8::Map> getUniformLocations(GLuint programId) {
+  Local<Context> context = Isolate::GetCurrent()->GetCurrentContext();
+  Local<v8::Map> uniformLocations = v8::Map::New(Isolate::GetCurrent());
+
+  GLint numUniforms = 0;
+  GLint maxNameLength = 0;
+  glGetProgramiv(programId, GL_ACTIVE_UNIFORMS, &numUniforms);
+  glGetProgramiv(programId, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+  std::vector<char> nameBuffer(std::max(maxNameLength, 1));
+
+  for (GLint i = 0; i < numUniforms; i++) {
+    GLsizei length = 0;
+    GLint size;
+    GLenum type;
+    glGetActiveUniform(programId, i, nameBuffer.size(), &length, &size, &type, nameBuffer.data());
+    std::string name(nameBuffer.data(), length);
+
+    GLint location = glGetUniformLocation(programId, name.c_str());
+    if (location == -1) { // uniform block member
+      continue;
+    }
+    Local<Object> locationObject = makeUniformLocation(location);
+    uniformLocations->Set(context, JS_STR(name.c_str()), locationObject).ToLocalChecked();
+
+    size_t arraySuffix = name.rfind("[0]");
+    if (arraySuffix != std::string::npos && arraySuffix + 3 == name.size()) {
+      std::string baseName = name.substr(0, arraySuffix);
+      uniformLocations->Set(context, JS_STR(baseName.c_str()), locationObject).ToLocalChecked();
+
+      for (GLint j = 1; j < size; j++) {
+        std::string elementName = baseName + "[" + std::to_string(j) + "]";
+        GLint elementLocation = glGetUniformLocation(programId, elementName.c_str());
+        if (elementLocation != -1) {
+          uniformLocations->Set(context, JS_STR(elementName.c_str()), makeUniformLocation(elementLocation)).ToLocalChecked();
+        }
+      }
+    }
+  }
+
+  return uniformLocations;
+}
+
 NAN_METHOD(WebGLRenderingContext::LinkProgram) {
-  GLint programId = info[0]->ToObject()->Get(JS_STR("id"))->Int32Value();
+  Local<Object> programObject = info[0]->ToObject();
+  GLint programId = programObject->Get(JS_STR("id"))->Int32Value();
   glLinkProgram(programId);
+
+  Local<String> uniformLocationsKey = JS_STR("uniformLocations");
+  GLint linkStatus = GL_FALSE;
+  glGetProgramiv(programId, GL_LINK_STATUS, &linkStatus);
+  if (linkStatus) {
+    Nan::SetPrivate(programObject, uniformLocationsKey, getUniformLocations(programId));
+  } else {
+    Nan::DeletePrivate(programObject, uniformLocationsKey);
+  }
 }
 
 
@@ -2212,6 +2486,9 @@ NAN_METHOD(WebGLRenderingContext::GetProgramParameter) {
     case GL_ATTACHED_SHADERS:
     case GL_ACTIVE_ATTRIBUTES:
     case GL_ACTIVE_UNIFORMS:
+    case GL_ACTIVE_UNIFORM_BLOCKS:
+    case GL_TRANSFORM_FEEDBACK_BUFFER_MODE:
+    case GL_TRANSFORM_FEEDBACK_VARYINGS:
       glGetProgramiv(programId, pname, &value);
       info.GetReturnValue().Set(JS_FLOAT(static_cast<long>(value)));
       break;
@@ -2222,18 +2499,29 @@ NAN_METHOD(WebGLRenderingContext::GetProgramParameter) {
 
 
 NAN_METHOD(WebGLRenderingContext::GetUniformLocation) {
-  GLint programId = info[0]->ToObject()->Get(JS_STR("id"))->Int32Value();
-  v8::String::Utf8Value name(info[1]);
+  Local<Context> context = Isolate::GetCurrent()->GetCurrentContext();
+  Local<Object> programObject = info[0]->ToObject();
+  Local<String> nameString = info[1]->ToString();
+
+  Local<Value> uniformLocationsValue;
+  bool hasUniformLocations = Nan::GetPrivate(programObject, JS_STR("uniformLocations")).ToLocal(&uniformLocationsValue) && uniformLocationsValue->IsMap();
+  if (hasUniformLocations) {
+    Local<v8::Map> uniformLocations = Local<v8::Map>::Cast(uniformLocationsValue);
+    if (uniformLocations->Has(context, nameString).FromMaybe(false)) {
+      return info.GetReturnValue().Set(uniformLocations->Get(context, nameString).ToLocalChecked());
+    }
+  }
 
+  // names the table does not spell out (e.g. struct array members); the answer is cached until the next link
+  GLint programId = programObject->Get(JS_STR("id"))->Int32Value();
+  v8::String::Utf8Value name(nameString);
   GLint location = glGetUniformLocation(programId, *name);
 
-  if (location != -1) {
-    Local<Object> locationObject = Nan::New<Object>();
-    locationObject->Set(JS_STR("id"), JS_INT(location));
-    info.GetReturnValue().Set(locationObject);
-  } else {
-    info.GetReturnValue().Set(Nan::Null());
+  Local<Value> result = location != -1 ? Local<Value>(makeUniformLocation(location)) : Local<Value>(Nan::Null());
+  if (hasUniformLocations) {
+    Local<v8::Map>::Cast(uniformLocationsValue)->Set(context, nameString, result).ToLocalChecked();
   }
+  info.GetReturnValue().Set(result);
 }
 
 NAN_METHOD(WebGLRenderingContext::GetUniformBlockIndex) {
@@ -2391,6 +2679,73 @@ size_t getTypeSize(int type) {
   }
 }
 
+// Bytes per pixel of a format/type pair as uploaded; packed types carry all components in one value.
+size_t getPixelSize(int format, int type) {
+  switch (type) {
+    case GL_UNSIGNED_SHORT_5_6_5:
+    case GL_UNSIGNED_SHORT_4_4_4_4:
+    case GL_UNSIGNED_SHORT_5_5_5_1:
+      return 2;
+    case GL_UNSIGNED_INT_2_10_10_10_REV:
+    case GL_UNSIGNED_INT_10F_11F_11F_REV:
+    case GL_UNSIGNED_INT_5_9_9_9_REV:
+    case GL_UNSIGNED_INT_24_8:
+      return 4;
+    case GL_FLOAT_32_UNSIGNED_INT_24_8_REV:
+      return 8;
+    default:
+      return getFormatSize(format) * getTypeSize(type);
+  }
+}
+
+// Approximate bytes per pixel of a sized internal format, for immutable storage.
+size_t getInternalFormatSize(int internalformat) {
+  switch (internalformat) {
+    case GL_R8:
+    case GL_R8I:
+    case GL_R8UI:
+    case GL_STENCIL_INDEX8:
+      return 1;
+    case GL_RG8:
+    case GL_R16F:
+    case GL_R16I:
+    case GL_R16UI:
+    case GL_RGB565:
+    case GL_RGBA4:
+    case GL_RGB5_A1:
+    case GL_DEPTH_COMPONENT16:
+      return 2;
+    case GL_RGB8:
+    case GL_SRGB8:
+      return 3;
+    case GL_RG16F:
+    case GL_R32F:
+    case GL_R32I:
+    case GL_R32UI:
+    case GL_RGBA8:
+    case GL_SRGB8_ALPHA8:
+    case GL_RGB10_A2:
+    case GL_R11F_G11F_B10F:
+    case GL_RGB9_E5:
+    case GL_DEPTH_COMPONENT24:
+    case GL_DEPTH_COMPONENT32F:
+    case GL_DEPTH24_STENCIL8:
+      return 4;
+    case GL_RGB16F:
+      return 6;
+    case GL_RG32F:
+    case GL_RGBA16F:
+    case GL_DEPTH32F_STENCIL8:
+      return 8;
+    case GL_RGB32F:
+      return 12;
+    case GL_RGBA32F:
+      return 16;
+    default:
+      return 4;
+  }
+}
+
 int formatMap[] = {
   GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE,
   GL_RGBA8_SNORM, GL_RGBA, GL_BYTE,
@@ -2696,8 +3051,12 @@ NAN_METHOD(WebGLRenderingContext::TexImage2D) {
       glPixelStorei(GL_UNPACK_ALIGNMENT, gl->unpackAlignment);
     }
   } else {
-    Nan::ThrowError(String::Concat(JS_STR("Invalid texture argument: "), pixels->ToString()));
+    return Nan::ThrowError(String::Concat(JS_STR("Invalid texture argument: "), pixels->ToString()));
   }
+
+  // luminance and alpha uploads are expanded to RGBA above
+  bool expanded = formatV == GL_LUMINANCE || formatV == GL_ALPHA || formatV == GL_LUMINANCE_ALPHA;
+  gl->SetTextureMemory(targetV, levelV, (size_t)widthV * heightV * getPixelSize(expanded ? GL_RGBA : formatV, typeV));
 }
 
 NAN_METHOD(WebGLRenderingContext::CompressedTexImage2D) {
@@ -2732,7 +3091,17 @@ NAN_METHOD(WebGLRenderingContext::CompressedTexImage2D) {
     int heightV = height->Int32Value();
     int borderV = border->Int32Value();
 
+#if !defined(LUMIN) && !defined(__ANDROID__) && !(defined(__APPLE__) && TARGET_OS_IPHONE)
+    // desktop drivers expose ETC1 through ARB_ES3_compatibility only, as part of ETC2
+    if (internalformatV == GL_ETC1_RGB8_OES) {
+      internalformatV = GL_COMPRESSED_RGB8_ETC2;
+    }
+#endif
+
     glCompressedTexImage2D(targetV, levelV, internalformatV, widthV, heightV, borderV, dataLengthV, dataV);
+
+    WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+    gl->SetTextureMemory(targetV, levelV, dataLengthV);
   } else {
     Nan::ThrowError("compressedTexImage2D: invalid arguments");
   }
@@ -2766,6 +3135,86 @@ NAN_METHOD(WebGLRenderingContext::Clear) {
   gl->dirty = true;
 }
 
+// clearBuffer[fiu]v(buffer, drawbuffer, values, srcOffset), with values an Array or a matching typed array.
+template<typename T>
+bool getClearBufferValues(Local<Value> value, Local<Value> srcOffset, bool isMatchingTypedArray, T values[4]) {
+  uint32_t offset = srcOffset->IsNumber() ? srcOffset->Uint32Value() : 0;
+  if (value->IsArray()) {
+    Local<Array> array = Local<Array>::Cast(value);
+    for (uint32_t i = 0; i < 4; i++) {
+      values[i] = offset + i < array->Length() ? (T)array->Get(offset + i)->NumberValue() : 0;
+    }
+    return true;
+  } else if (isMatchingTypedArray) {
+    Local<ArrayBufferView> arrayBufferView = Local<ArrayBufferView>::Cast(value);
+    size_t length = arrayBufferView->ByteLength() / sizeof(T);
+    T *data = (T *)((char *)arrayBufferView->Buffer()->GetContents().Data() + arrayBufferView->ByteOffset());
+    for (uint32_t i = 0; i < 4; i++) {
+      values[i] = offset + i < length ? data[offset + i] : 0;
+    }
+    return true;
+  } else {
+    return false;
+  }
+}
+
+NAN_METHOD(WebGLRenderingContext::ClearBufferfv) {
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+  GLenum buffer = info[0]->Uint32Value();
+  GLint drawbuffer = info[1]->Int32Value();
+
+  GLfloat values[4];
+  if (getClearBufferValues<GLfloat>(info[2], info[3], info[2]->IsFloat32Array(), values)) {
+    glClearBufferfv(buffer, drawbuffer, values);
+
+    gl->dirty = true;
+  } else {
+    Nan::ThrowError("clearBufferfv: invalid arguments");
+  }
+}
+
+NAN_METHOD(WebGLRenderingContext::ClearBufferiv) {
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+  GLenum buffer = info[0]->Uint32Value();
+  GLint drawbuffer = info[1]->Int32Value();
+
+  GLint values[4];
+  if (getClearBufferValues<GLint>(info[2], info[3], info[2]->IsInt32Array(), values)) {
+    glClearBufferiv(buffer, drawbuffer, values);
+
+    gl->dirty = true;
+  } else {
+    Nan::ThrowError("clearBufferiv: invalid arguments");
+  }
+}
+
+NAN_METHOD(WebGLRenderingContext::ClearBufferuiv) {
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+  GLenum buffer = info[0]->Uint32Value();
+  GLint drawbuffer = info[1]->Int32Value();
+
+  GLuint values[4];
+  if (getClearBufferValues<GLuint>(info[2], info[3], info[2]->IsUint32Array(), values)) {
+    glClearBufferuiv(buffer, drawbuffer, values);
+
+    gl->dirty = true;
+  } else {
+    Nan::ThrowError("clearBufferuiv: invalid arguments");
+  }
+}
+
+NAN_METHOD(WebGLRenderingContext::ClearBufferfi) {
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+  GLenum buffer = info[0]->Uint32Value();
+  GLint drawbuffer = info[1]->Int32Value();
+  GLfloat depth = info[2]->NumberValue();
+  GLint stencil = info[3]->Int32Value();
+
+  glClearBufferfi(buffer, drawbuffer, depth, stencil);
+
+  gl->dirty = true;
+}
+
 
 NAN_METHOD(WebGLRenderingContext::UseProgram) {
   WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
@@ -2811,11 +3260,158 @@ NAN_METHOD(WebGLRenderingContext::BindBuffer) {
 }
 
 NAN_METHOD(WebGLRenderingContext::BindBufferBase) {
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
   GLenum target = info[0]->Uint32Value();
   GLuint index = info[1]->Uint32Value();
-  GLuint buffer = info[2]->ToObject()->Get(JS_STR("id"))->Uint32Value();
+  GLuint buffer = info[2]->IsObject() ? info[2]->ToObject()->Get(JS_STR("id"))->Uint32Value() : 0;
 
   glBindBufferBase(target, index, buffer);
+
+  // indexed binds also replace the generic binding point
+  gl->SetBufferBinding(target, buffer);
+}
+
+NAN_METHOD(WebGLRenderingContext::BindBufferRange) {
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+  GLenum target = info[0]->Uint32Value();
+  GLuint index = info[1]->Uint32Value();
+  GLuint buffer = info[2]->IsObject() ? info[2]->ToObject()->Get(JS_STR("id"))->Uint32Value() : 0;
+  GLintptr offset = info[3]->IntegerValue();
+  GLsizeiptr size = info[4]->IntegerValue();
+
+  glBindBufferRange(target, index, buffer, offset, size);
+
+  gl->SetBufferBinding(target, buffer);
+}
+
+NAN_METHOD(WebGLRenderingContext::CopyBufferSubData) {
+  GLenum readTarget = info[0]->Uint32Value();
+  GLenum writeTarget = info[1]->Uint32Value();
+  GLintptr readOffset = info[2]->IntegerValue();
+  GLintptr writeOffset = info[3]->IntegerValue();
+  GLsizeiptr size = info[4]->IntegerValue();
+
+  glCopyBufferSubData(readTarget, writeTarget, readOffset, writeOffset, size);
+}
+
+// Resolves getBufferSubData's (dstBuffer, dstOffset, length) into a byte range; offsets and lengths count elements.
+bool getBufferSubDataDst(Local<Value> dstData, Local<Value> dstOffset, Local<Value> length, char *&dstV, size_t &dstLengthV) {
+  if (dstData->IsArrayBufferView()) {
+    Local<ArrayBufferView> arrayBufferView = Local<ArrayBufferView>::Cast(dstData);
+    size_t elementSize = getArrayBufferViewElementSize(arrayBufferView);
+    size_t offset = dstOffset->IsNumber() ? dstOffset->Uint32Value() * elementSize : 0;
+    if (offset > arrayBufferView->ByteLength()) {
+      return false;
+    }
+    dstV = (char *)arrayBufferView->Buffer()->GetContents().Data() + arrayBufferView->ByteOffset() + offset;
+    dstLengthV = arrayBufferView->ByteLength() - offset;
+    if (length->IsNumber() && length->Uint32Value() > 0) {
+      size_t lengthBytes = length->Uint32Value() * elementSize;
+      if (lengthBytes > dstLengthV) {
+        return false;
+      }
+      dstLengthV = lengthBytes;
+    }
+    return true;
+  } else {
+    return false;
+  }
+}
+
+void copyMappedBuffer(GLenum target, GLintptr offset, char *dst, size_t length) {
+  if (length > 0) {
+    void *src = glMapBufferRange(target, offset, length, GL_MAP_READ_BIT);
+    if (src) {
+      memcpy(dst, src, length);
+      glUnmapBuffer(target);
+    }
+  }
+}
+
+// Synchronous readback; stalls until the GPU has written the range. See beginBufferReadback for the non-stalling path.
+NAN_METHOD(WebGLRenderingContext::GetBufferSubData) {
+  GLenum target = info[0]->Uint32Value();
+  GLintptr srcByteOffset = info[1]->IntegerValue();
+
+  char *dstV;
+  size_t dstLengthV;
+  if (getBufferSubDataDst(info[2], info[3], info[4], dstV, dstLengthV)) {
+    copyMappedBuffer(target, srcByteOffset, dstV, dstLengthV);
+  } else {
+    Nan::ThrowError("getBufferSubData: invalid arguments");
+  }
+}
+
+// Snapshots a buffer range into a staging buffer and fences it, so that finishBufferReadback on a later frame can
+// copy the data out without waiting on the GPU. The snapshot is taken now; later writes to the source are not seen.
+NAN_METHOD(WebGLRenderingContext::BeginBufferReadback) {
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+  GLenum target = info[0]->Uint32Value();
+  GLintptr srcByteOffset = info[1]->IntegerValue();
+  GLsizeiptr size = info[2]->IntegerValue();
+
+  GLenum stagingTarget = target == GL_COPY_WRITE_BUFFER ? GL_COPY_READ_BUFFER : GL_COPY_WRITE_BUFFER;
+  GLuint staging;
+  glGenBuffers(1, &staging);
+  glBindBuffer(stagingTarget, staging);
+  glBufferData(stagingTarget, size, nullptr, GL_STREAM_READ);
+  glCopyBufferSubData(target, stagingTarget, srcByteOffset, 0, size);
+  glBindBuffer(stagingTarget, gl->HasBufferBinding(stagingTarget) ? gl->GetBufferBinding(stagingTarget) : 0);
+
+  GLsync sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  glFlush();
+
+  gl->bufferReadbacks[staging] = BufferReadback(sync, size);
+
+  Local<Object> readbackObject = Nan::New<Object>();
+  readbackObject->Set(JS_STR("id"), JS_INT(staging));
+  info.GetReturnValue().Set(readbackObject);
+}
+
+// finishBufferReadback(readback, dstBuffer, dstOffset, length): false while the GPU is still working, else copies and frees.
+NAN_METHOD(WebGLRenderingContext::FinishBufferReadback) {
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+  GLuint staging = info[0]->IsObject() ? info[0]->ToObject()->Get(JS_STR("id"))->Uint32Value() : 0;
+
+  auto iter = gl->bufferReadbacks.find(staging);
+  if (iter == gl->bufferReadbacks.end()) {
+    return Nan::ThrowError("finishBufferReadback: unknown readback");
+  }
+  char *dstV;
+  size_t dstLengthV;
+  if (!getBufferSubDataDst(info[1], info[2], info[3], dstV, dstLengthV)) {
+    return Nan::ThrowError("finishBufferReadback: invalid arguments");
+  }
+
+  BufferReadback &readback = iter->second;
+  GLenum status = glClientWaitSync(readback.sync, 0, 0);
+  if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED) {
+    glBindBuffer(GL_COPY_READ_BUFFER, staging);
+    copyMappedBuffer(GL_COPY_READ_BUFFER, 0, dstV, std::min<size_t>(dstLengthV, readback.size));
+    glBindBuffer(GL_COPY_READ_BUFFER, gl->HasBufferBinding(GL_COPY_READ_BUFFER) ? gl->GetBufferBinding(GL_COPY_READ_BUFFER) : 0);
+
+    glDeleteSync(readback.sync);
+    glDeleteBuffers(1, &staging);
+    gl->bufferReadbacks.erase(iter);
+
+    info.GetReturnValue().Set(JS_BOOL(true));
+  } else if (status == GL_WAIT_FAILED) {
+    return Nan::ThrowError("finishBufferReadback: wait failed");
+  } else {
+    info.GetReturnValue().Set(JS_BOOL(false));
+  }
+}
+
+NAN_METHOD(WebGLRenderingContext::DeleteBufferReadback) {
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+  GLuint staging = info[0]->IsObject() ? info[0]->ToObject()->Get(JS_STR("id"))->Uint32Value() : 0;
+
+  auto iter = gl->bufferReadbacks.find(staging);
+  if (iter != gl->bufferReadbacks.end()) {
+    glDeleteSync(iter->second.sync);
+    glDeleteBuffers(1, &staging);
+    gl->bufferReadbacks.erase(iter);
+  }
 }
 
 NAN_METHOD(WebGLRenderingContext::CreateFramebuffer) {
@@ -2838,8 +3434,8 @@ NAN_METHOD(WebGLRenderingContext::BindFramebuffer) {
 
   gl->SetFramebufferBinding(target, framebuffer);
   if (target == GL_FRAMEBUFFER) {
-    gl->SetFramebufferBinding(target == GL_DRAW_FRAMEBUFFER, framebuffer);
-    gl->SetFramebufferBinding(target == GL_READ_FRAMEBUFFER, framebuffer);
+    gl->SetFramebufferBinding(GL_DRAW_FRAMEBUFFER, framebuffer);
+    gl->SetFramebufferBinding(GL_READ_FRAMEBUFFER, framebuffer);
   }
 }
 
@@ -2864,6 +3460,16 @@ NAN_METHOD(WebGLRenderingContext::FramebufferTexture2D) {
   // info.GetReturnValue().Set(Nan::Undefined());
 }
 
+NAN_METHOD(WebGLRenderingContext::FramebufferTextureLayer) {
+  GLenum target = info[0]->Uint32Value();
+  GLenum attachment = info[1]->Uint32Value();
+  GLuint texture = info[2]->IsObject() ? info[2]->ToObject()->Get(JS_STR("id"))->Uint32Value() : 0;
+  GLint level = info[3]->Int32Value();
+  GLint layer = info[4]->Int32Value();
+
+  glFramebufferTextureLayer(target, attachment, texture, level, layer);
+}
+
 NAN_METHOD(WebGLRenderingContext::BlitFramebuffer) {
   int sx = info[0]->Uint32Value();
   int sy = info[1]->Uint32Value();
@@ -2888,6 +3494,94 @@ NAN_METHOD(WebGLRenderingContext::BlitFramebuffer) {
   // info.GetReturnValue().Set(Nan::Undefined());
 }
 
+// The WebGL default framebuffer is normally one of our FBOs, so its BACK/COLOR/DEPTH/STENCIL buffers are really attachments.
+GLenum getDefaultFramebufferAttachment(WebGLRenderingContext *gl, GLenum target, GLenum attachment) {
+  GLenum bindingTarget = target == GL_READ_FRAMEBUFFER ? GL_READ_FRAMEBUFFER : GL_DRAW_FRAMEBUFFER;
+  GLuint framebuffer = gl->HasFramebufferBinding(bindingTarget) ? gl->GetFramebufferBinding(bindingTarget) : gl->defaultFramebuffer;
+  if (framebuffer != 0 && framebuffer == gl->defaultFramebuffer) {
+    switch (attachment) {
+      case GL_BACK:
+      case GL_COLOR: return GL_COLOR_ATTACHMENT0;
+      case GL_DEPTH: return GL_DEPTH_ATTACHMENT;
+      case GL_STENCIL: return GL_STENCIL_ATTACHMENT;
+    }
+  }
+  return attachment;
+}
+
+// Invalidation is core in GLES 3.0 but needs GL 4.3 / ARB_invalidate_subdata on desktop (not macOS's 4.1 core profile).
+// It is only a hint, so without it the calls do nothing.
+bool isInvalidateSupported() {
+#if defined(LUMIN) || defined(__ANDROID__) || (defined(__APPLE__) && TARGET_OS_IPHONE)
+  return true;
+#else
+  return GLEW_ARB_invalidate_subdata;
+#endif
+}
+
+bool getInvalidateAttachments(WebGLRenderingContext *gl, GLenum target, Local<Value> value, std::vector<GLenum> &attachments) {
+  if (value->IsArray()) {
+    Local<Array> array = Local<Array>::Cast(value);
+    attachments.resize(array->Length());
+    for (uint32_t i = 0; i < array->Length(); i++) {
+      attachments[i] = getDefaultFramebufferAttachment(gl, target, array->Get(i)->Uint32Value());
+    }
+    return true;
+  } else {
+    return false;
+  }
+}
+
+NAN_METHOD(WebGLRenderingContext::InvalidateFramebuffer) {
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+  GLenum target = info[0]->Uint32Value();
+
+  std::vector<GLenum> attachments;
+  if (getInvalidateAttachments(gl, target, info[1], attachments)) {
+    if (isInvalidateSupported()) {
+      glInvalidateFramebuffer(target, attachments.size(), attachments.data());
+    }
+  } else {
+    Nan::ThrowError("invalidateFramebuffer: invalid arguments");
+  }
+}
+
+NAN_METHOD(WebGLRenderingContext::InvalidateSubFramebuffer) {
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+  GLenum target = info[0]->Uint32Value();
+  GLint x = info[2]->Int32Value();
+  GLint y = info[3]->Int32Value();
+  GLsizei width = info[4]->Int32Value();
+  GLsizei height = info[5]->Int32Value();
+
+  std::vector<GLenum> attachments;
+  if (getInvalidateAttachments(gl, target, info[1], attachments)) {
+    if (isInvalidateSupported()) {
+      glInvalidateSubFramebuffer(target, attachments.size(), attachments.data(), x, y, width, height);
+    }
+  } else {
+    Nan::ThrowError("invalidateSubFramebuffer: invalid arguments");
+  }
+}
+
+NAN_METHOD(WebGLRenderingContext::ReadBuffer) {
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+  GLenum src = info[0]->Uint32Value();
+
+  glReadBuffer(getDefaultFramebufferAttachment(gl, GL_READ_FRAMEBUFFER, src));
+}
+
+// The element array binding is vertex array state, so it is queried rather than taken from the tracked bindings.
+GLuint getBoundBuffer(WebGLRenderingContext *gl, GLenum target) {
+  if (target == GL_ELEMENT_ARRAY_BUFFER) {
+    GLint buffer;
+    glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &buffer);
+    return buffer;
+  } else {
+    return gl->HasBufferBinding(target) ? gl->GetBufferBinding(target) : 0;
+  }
+}
+
 NAN_METHOD(WebGLRenderingContext::BufferData) {
   GLenum target = info[0]->Uint32Value();
   Local<Object> obj = Local<Object>::Cast(info[1]);
@@ -2929,6 +3623,12 @@ NAN_METHOD(WebGLRenderingContext::BufferData) {
   }
 
   glBufferData(target, size, data, usage);
+
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+  GLuint buffer = getBoundBuffer(gl, target);
+  if (buffer != 0) {
+    gl->bufferStorages[buffer] = BufferStorage(usage, size);
+  }
 }
 
 
@@ -2962,7 +3662,30 @@ NAN_METHOD(WebGLRenderingContext::BufferSubData) {
     return;
   }
 
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+  BufferStream *bufferStream = gl->bufferStream;
+  auto iter = gl->bufferStorages.find(getBoundBuffer(gl, target));
+  GLenum usage = iter != gl->bufferStorages.end() ? iter->second.usage : 0;
+  if (usage == GL_DYNAMIC_DRAW || usage == GL_STREAM_DRAW) {
+    if (dstOffset == 0 && (GLsizeiptr)size == iter->second.size) {
+      // whole-buffer rewrite: orphan the old storage instead of waiting for draws that still read it
+      glBufferData(target, size, data, usage);
+      bufferStream->orphans++;
+      return;
+    }
+
+    GLintptr ringOffset = bufferStream->Write(data, size);
+    if (ringOffset != -1) {
+      GLenum stagingTarget = target == GL_COPY_READ_BUFFER ? GL_COPY_WRITE_BUFFER : GL_COPY_READ_BUFFER;
+      glBindBuffer(stagingTarget, bufferStream->GetBuffer());
+      glCopyBufferSubData(stagingTarget, target, ringOffset, dstOffset, size);
+      glBindBuffer(stagingTarget, gl->HasBufferBinding(stagingTarget) ? gl->GetBufferBinding(stagingTarget) : 0);
+      return;
+    }
+  }
+
   glBufferSubData(target, dstOffset, size, data);
+  bufferStream->direct++;
 }
 
 
@@ -3089,25 +3812,196 @@ NAN_METHOD(WebGLRenderingContext::DrawRangeElements) {
   gl->dirty = true;
 }
 
-NAN_METHOD(WebGLRenderingContext::Flush) {
-  // Nan::HandleScope scope;
-
-  glFlush();
+// GLES has neither glMultiDraw* nor base instance in core; there the multi draws loop natively instead.
+#if defined(LUMIN) || defined(__ANDROID__) || (defined(__APPLE__) && TARGET_OS_IPHONE)
+#define MULTI_DRAW_SUPPORTED 0
+#else
+#define MULTI_DRAW_SUPPORTED 1
+#endif
 
-  // info.GetReturnValue().Set(Nan::Undefined());
+// Resolves a WEBGL_multi_draw list argument (Int32Array or array) at an element offset to drawcount values,
+// pointing into the typed array directly when possible.
+bool getMultiDrawList(Local<Value> value, Local<Value> offsetValue, GLsizei drawcount, std::vector<GLint> &storage, const GLint *&list) {
+  if (offsetValue->Int32Value() < 0) {
+    return false;
+  }
+  size_t offset = offsetValue->Uint32Value();
+  if (value->IsInt32Array()) {
+    Local<Int32Array> int32Array = Local<Int32Array>::Cast(value);
+    size_t length = int32Array->Length();
+    if (offset > length || (size_t)drawcount > length - offset) {
+      return false;
+    }
+    list = (const GLint *)((char *)int32Array->Buffer()->GetContents().Data() + int32Array->ByteOffset()) + offset;
+    return true;
+  } else if (value->IsArray()) {
+    Local<Array> array = Local<Array>::Cast(value);
+    size_t length = array->Length();
+    if (offset > length || (size_t)drawcount > length - offset) {
+      return false;
+    }
+    storage.resize(drawcount);
+    for (GLsizei i = 0; i < drawcount; i++) {
+      storage[i] = array->Get(offset + i)->Int32Value();
+    }
+    list = storage.data();
+    return true;
+  } else {
+    return false;
+  }
 }
 
-NAN_METHOD(WebGLRenderingContext::Finish) {
-  // Nan::HandleScope scope;
+// multiDrawArraysWEBGL(mode, firstsList, firstsOffset, countsList, countsOffset, drawcount)
+NAN_METHOD(WebGLRenderingContext::MultiDrawArraysWEBGL) {
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(Local<Object>::Cast(info.This()->Get(JS_STR("context"))));
+  GLenum mode = info[0]->Uint32Value();
+  GLsizei drawcount = info[5]->Int32Value();
 
-  glFinish();
+  std::vector<GLint> firstsStorage, countsStorage;
+  const GLint *firsts, *counts;
+  if (drawcount < 0 || !getMultiDrawList(info[1], info[2], drawcount, firstsStorage, firsts) || !getMultiDrawList(info[3], info[4], drawcount, countsStorage, counts)) {
+    return Nan::ThrowError("multiDrawArraysWEBGL: invalid arguments");
+  }
 
-  // info.GetReturnValue().Set(Nan::Undefined());
+#if MULTI_DRAW_SUPPORTED
+  glMultiDrawArrays(mode, firsts, counts, drawcount);
+#else
+  for (GLsizei i = 0; i < drawcount; i++) {
+    glDrawArrays(mode, firsts[i], counts[i]);
+  }
+#endif
+
+  gl->dirty = true;
 }
 
-NAN_METHOD(WebGLRenderingContext::VertexAttrib1f) {
-  GLuint indx = info[0]->Int32Value();
-  GLfloat x = info[1]->NumberValue();
+// multiDrawElementsWEBGL(mode, countsList, countsOffset, type, offsetsList, offsetsOffset, drawcount)
+NAN_METHOD(WebGLRenderingContext::MultiDrawElementsWEBGL) {
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(Local<Object>::Cast(info.This()->Get(JS_STR("context"))));
+  GLenum mode = info[0]->Uint32Value();
+  GLenum type = info[3]->Uint32Value();
+  GLsizei drawcount = info[6]->Int32Value();
+
+  std::vector<GLint> countsStorage, offsetsStorage;
+  const GLint *counts, *offsets;
+  if (drawcount < 0 || !getMultiDrawList(info[1], info[2], drawcount, countsStorage, counts) || !getMultiDrawList(info[4], info[5], drawcount, offsetsStorage, offsets)) {
+    return Nan::ThrowError("multiDrawElementsWEBGL: invalid arguments");
+  }
+
+#if MULTI_DRAW_SUPPORTED
+  std::vector<const GLvoid *> indices(drawcount);
+  for (GLsizei i = 0; i < drawcount; i++) {
+    indices[i] = reinterpret_cast<const GLvoid *>((GLintptr)offsets[i]);
+  }
+  glMultiDrawElements(mode, counts, type, indices.data(), drawcount);
+#else
+  for (GLsizei i = 0; i < drawcount; i++) {
+    glDrawElements(mode, counts[i], type, reinterpret_cast<const GLvoid *>((GLintptr)offsets[i]));
+  }
+#endif
+
+  gl->dirty = true;
+}
+
+// multiDrawArraysInstancedWEBGL(mode, firstsList, firstsOffset, countsList, countsOffset, instanceCountsList, instanceCountsOffset, drawcount)
+NAN_METHOD(WebGLRenderingContext::MultiDrawArraysInstancedWEBGL) {
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(Local<Object>::Cast(info.This()->Get(JS_STR("context"))));
+  GLenum mode = info[0]->Uint32Value();
+  GLsizei drawcount = info[7]->Int32Value();
+
+  std::vector<GLint> firstsStorage, countsStorage, instanceCountsStorage;
+  const GLint *firsts, *counts, *instanceCounts;
+  if (
+    drawcount < 0 ||
+    !getMultiDrawList(info[1], info[2], drawcount, firstsStorage, firsts) ||
+    !getMultiDrawList(info[3], info[4], drawcount, countsStorage, counts) ||
+    !getMultiDrawList(info[5], info[6], drawcount, instanceCountsStorage, instanceCounts)
+  ) {
+    return Nan::ThrowError("multiDrawArraysInstancedWEBGL: invalid arguments");
+  }
+
+  for (GLsizei i = 0; i < drawcount; i++) {
+    glDrawArraysInstanced(mode, firsts[i], counts[i], instanceCounts[i]);
+  }
+
+  gl->dirty = true;
+}
+
+// multiDrawElementsInstancedWEBGL(mode, countsList, countsOffset, type, offsetsList, offsetsOffset, instanceCountsList, instanceCountsOffset, drawcount)
+NAN_METHOD(WebGLRenderingContext::MultiDrawElementsInstancedWEBGL) {
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(Local<Object>::Cast(info.This()->Get(JS_STR("context"))));
+  GLenum mode = info[0]->Uint32Value();
+  GLenum type = info[3]->Uint32Value();
+  GLsizei drawcount = info[8]->Int32Value();
+
+  std::vector<GLint> countsStorage, offsetsStorage, instanceCountsStorage;
+  const GLint *counts, *offsets, *instanceCounts;
+  if (
+    drawcount < 0 ||
+    !getMultiDrawList(info[1], info[2], drawcount, countsStorage, counts) ||
+    !getMultiDrawList(info[4], info[5], drawcount, offsetsStorage, offsets) ||
+    !getMultiDrawList(info[6], info[7], drawcount, instanceCountsStorage, instanceCounts)
+  ) {
+    return Nan::ThrowError("multiDrawElementsInstancedWEBGL: invalid arguments");
+  }
+
+  for (GLsizei i = 0; i < drawcount; i++) {
+    glDrawElementsInstanced(mode, counts[i], type, reinterpret_cast<const GLvoid *>((GLintptr)offsets[i]), instanceCounts[i]);
+  }
+
+  gl->dirty = true;
+}
+
+NAN_METHOD(WebGLRenderingContext::DrawArraysInstancedBaseInstanceWEBGL) {
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(Local<Object>::Cast(info.This()->Get(JS_STR("context"))));
+  GLenum mode = info[0]->Uint32Value();
+  GLint first = info[1]->Int32Value();
+  GLsizei count = info[2]->Int32Value();
+  GLsizei instanceCount = info[3]->Int32Value();
+  GLuint baseInstance = info[4]->Uint32Value();
+
+#if MULTI_DRAW_SUPPORTED
+  glDrawArraysInstancedBaseInstance(mode, first, count, instanceCount, baseInstance);
+#endif
+
+  gl->dirty = true;
+}
+
+NAN_METHOD(WebGLRenderingContext::DrawElementsInstancedBaseVertexBaseInstanceWEBGL) {
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(Local<Object>::Cast(info.This()->Get(JS_STR("context"))));
+  GLenum mode = info[0]->Uint32Value();
+  GLsizei count = info[1]->Int32Value();
+  GLenum type = info[2]->Uint32Value();
+  GLintptr offset = info[3]->Int32Value();
+  GLsizei instanceCount = info[4]->Int32Value();
+  GLint baseVertex = info[5]->Int32Value();
+  GLuint baseInstance = info[6]->Uint32Value();
+
+#if MULTI_DRAW_SUPPORTED
+  glDrawElementsInstancedBaseVertexBaseInstance(mode, count, type, (void *)offset, instanceCount, baseVertex, baseInstance);
+#endif
+
+  gl->dirty = true;
+}
+
+NAN_METHOD(WebGLRenderingContext::Flush) {
+  // Nan::HandleScope scope;
+
+  glFlush();
+
+  // info.GetReturnValue().Set(Nan::Undefined());
+}
+
+NAN_METHOD(WebGLRenderingContext::Finish) {
+  // Nan::HandleScope scope;
+
+  glFinish();
+
+  // info.GetReturnValue().Set(Nan::Undefined());
+}
+
+NAN_METHOD(WebGLRenderingContext::VertexAttrib1f) {
+  GLuint indx = info[0]->Int32Value();
+  GLfloat x = info[1]->NumberValue();
 
   glVertexAttrib1f(indx, x);
 }
@@ -3575,6 +4469,9 @@ NAN_METHOD(WebGLRenderingContext::DeleteBuffer) {
 
   glDeleteBuffers(1, &buffer);
 
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+  gl->bufferStorages.erase(buffer);
+
   // info.GetReturnValue().Set(Nan::Undefined());
 }
 
@@ -3613,6 +4510,9 @@ NAN_METHOD(WebGLRenderingContext::DeleteTexture) {
 
   glDeleteTextures(1, &texture);
 
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+  gl->DeleteTextureMemory(texture);
+
   // info.GetReturnValue().Set(Nan::Undefined());
 }
 
@@ -3768,6 +4668,16 @@ NAN_METHOD(WebGLRenderingContext::RenderbufferStorage) {
   // info.GetReturnValue().Set(Nan::Undefined());
 }
 
+NAN_METHOD(WebGLRenderingContext::RenderbufferStorageMultisample) {
+  GLenum target = info[0]->Uint32Value();
+  GLsizei samples = info[1]->Int32Value();
+  GLenum internalformat = info[2]->Uint32Value();
+  GLsizei width = info[3]->Uint32Value();
+  GLsizei height = info[4]->Uint32Value();
+
+  glRenderbufferStorageMultisample(target, samples, internalformat, width, height);
+}
+
 NAN_METHOD(WebGLRenderingContext::GetShaderSource) {
   GLuint shaderId = info[0]->ToObject()->Get(JS_STR("id"))->Uint32Value();
 
@@ -3859,6 +4769,257 @@ NAN_METHOD(WebGLRenderingContext::TexStorage2D) {
   GLsizei height = info[4]->Uint32Value();
 
   glTexStorage2D(target, levels, internalFormat, width, height);
+
+  size_t pixelSize = getInternalFormatSize(internalFormat);
+  for (GLint i = 0; i < levels; i++) {
+    size_t levelSize = (size_t)std::max<GLsizei>(width >> i, 1) * std::max<GLsizei>(height >> i, 1) * pixelSize;
+    if (target == GL_TEXTURE_CUBE_MAP) {
+      for (GLenum face = GL_TEXTURE_CUBE_MAP_POSITIVE_X; face <= GL_TEXTURE_CUBE_MAP_NEGATIVE_Z; face++) {
+        gl->SetTextureMemory(face, i, levelSize);
+      }
+    } else {
+      gl->SetTextureMemory(target, i, levelSize);
+    }
+  }
+}
+
+// Bytes a 3D upload of width x height x depth reads from client memory under the current unpack state.
+uint64_t getTexImage3DUploadSize(WebGLRenderingContext *gl, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type) {
+  if (width <= 0 || height <= 0 || depth <= 0) {
+    return 0;
+  }
+
+  GLint rowLength, imageHeight, skipPixels, skipRows, skipImages;
+  glGetIntegerv(GL_UNPACK_ROW_LENGTH, &rowLength);
+  glGetIntegerv(GL_UNPACK_IMAGE_HEIGHT, &imageHeight);
+  glGetIntegerv(GL_UNPACK_SKIP_PIXELS, &skipPixels);
+  glGetIntegerv(GL_UNPACK_SKIP_ROWS, &skipRows);
+  glGetIntegerv(GL_UNPACK_SKIP_IMAGES, &skipImages);
+
+  uint64_t pixelSize = getPixelSize(format, type);
+  uint64_t alignment = gl->unpackAlignment > 0 ? gl->unpackAlignment : 1;
+  uint64_t rowSize = (uint64_t)(rowLength > 0 ? rowLength : width) * pixelSize;
+  rowSize = (rowSize + alignment - 1) / alignment * alignment;
+  uint64_t imageSize = (uint64_t)(imageHeight > 0 ? imageHeight : height) * rowSize;
+  return ((uint64_t)skipImages + depth - 1) * imageSize +
+    ((uint64_t)skipRows + height - 1) * rowSize +
+    (uint64_t)skipPixels * pixelSize +
+    (uint64_t)width * pixelSize;
+}
+
+// Resolves a texImage3D/texSubImage3D source to an upload pointer. Image sources hold depth slices stacked vertically
+// and are reformatted and flipped slice by slice, the same way texSubImage2D treats a single image.
+bool getTexImage3DPixels(WebGLRenderingContext *gl, Local<Value> pixels, Local<Value> srcOffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, char *&pixelsV, unique_ptr<char[]> &pixelsBuffer) {
+  if (pixels->IsArrayBufferView()) {
+    Local<ArrayBufferView> arrayBufferView = Local<ArrayBufferView>::Cast(pixels);
+    size_t extraOffset = srcOffset->IsNumber() ? (size_t)srcOffset->Uint32Value() * getArrayBufferViewElementSize(arrayBufferView) : 0;
+    if (extraOffset > arrayBufferView->ByteLength()) {
+      return false;
+    }
+    // the driver reads the full extent regardless of the view's length
+    if ((uint64_t)(arrayBufferView->ByteLength() - extraOffset) < getTexImage3DUploadSize(gl, width, height, depth, format, type)) {
+      return false;
+    }
+    if (extraOffset > 0) {
+      pixels = Uint8Array::New(arrayBufferView->Buffer(), arrayBufferView->ByteOffset() + extraOffset, arrayBufferView->ByteLength() - extraOffset);
+    }
+  }
+
+  if (pixels->IsNull() || pixels->IsUndefined()) {
+    pixelsV = nullptr;
+    return true;
+  } else if (pixels->IsNumber()) {
+    pixelsV = (char *)(GLintptr)pixels->Uint32Value();
+    return true;
+  } else if (pixels->IsObject() && (pixelsV = (char *)getImageData(pixels)) != nullptr) {
+    if (!pixels->IsArrayBufferView()) {
+      // image sources hold the slices stacked vertically, so anything else would be read out of bounds
+      Local<Object> imageObj = Local<Object>::Cast(pixels);
+      uint32_t imageWidth = imageObj->Get(JS_STR("width"))->Uint32Value();
+      uint32_t imageHeight = imageObj->Get(JS_STR("height"))->Uint32Value();
+      if (imageWidth != (uint32_t)width || (uint64_t)imageHeight != (uint64_t)height * depth) {
+        return false;
+      }
+
+      size_t formatSize = getFormatSize(format);
+      size_t typeSize = getTypeSize(type);
+      size_t pixelSize = formatSize * typeSize;
+      size_t sliceSize = (size_t)width * height * pixelSize;
+      bool flip = canvas::ImageData::getFlip() && gl->flipY;
+
+      if (formatSize != 4 || flip) {
+        pixelsBuffer.reset(new char[sliceSize * depth]);
+        char *srcData = pixelsV;
+        unique_ptr<char[]> reformatBuffer;
+        if (formatSize != 4) {
+          reformatBuffer.reset(new char[sliceSize * depth]);
+          reformatImageData(reformatBuffer.get(), srcData, pixelSize, 4 * typeSize, (size_t)width * height * depth);
+          srcData = reformatBuffer.get();
+        }
+        if (flip) {
+          for (GLsizei i = 0; i < depth; i++) {
+            flipImageData(pixelsBuffer.get() + i * sliceSize, srcData + i * sliceSize, width, height, pixelSize);
+          }
+        } else {
+          memcpy(pixelsBuffer.get(), srcData, sliceSize * depth);
+        }
+        pixelsV = pixelsBuffer.get();
+      }
+    }
+    return true;
+  } else {
+    return false;
+  }
+}
+
+NAN_METHOD(WebGLRenderingContext::TexImage3D) {
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+  GLenum targetV = info[0]->Uint32Value();
+  GLint levelV = info[1]->Int32Value();
+  GLenum internalformatV = info[2]->Uint32Value();
+  GLsizei widthV = info[3]->Uint32Value();
+  GLsizei heightV = info[4]->Uint32Value();
+  GLsizei depthV = info[5]->Uint32Value();
+  GLint borderV = info[6]->Int32Value();
+  GLenum formatV = info[7]->Uint32Value();
+  GLenum typeV = info[8]->Uint32Value();
+
+  internalformatV = normalizeInternalFormat(internalformatV, formatV, typeV);
+
+  char *pixelsV;
+  unique_ptr<char[]> pixelsBuffer;
+  if (getTexImage3DPixels(gl, info[9], info[10], widthV, heightV, depthV, formatV, typeV, pixelsV, pixelsBuffer)) {
+    glTexImage3D(targetV, levelV, internalformatV, widthV, heightV, depthV, borderV, formatV, typeV, pixelsV);
+
+    gl->SetTextureMemory(targetV, levelV, (size_t)widthV * heightV * depthV * getPixelSize(formatV, typeV));
+  } else {
+    Nan::ThrowError("texImage3D: invalid texture argument");
+  }
+}
+
+NAN_METHOD(WebGLRenderingContext::TexSubImage3D) {
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+  GLenum targetV = info[0]->Uint32Value();
+  GLint levelV = info[1]->Int32Value();
+  GLint xoffsetV = info[2]->Int32Value();
+  GLint yoffsetV = info[3]->Int32Value();
+  GLint zoffsetV = info[4]->Int32Value();
+  GLsizei widthV = info[5]->Uint32Value();
+  GLsizei heightV = info[6]->Uint32Value();
+  GLsizei depthV = info[7]->Uint32Value();
+  GLenum formatV = info[8]->Uint32Value();
+  GLenum typeV = info[9]->Uint32Value();
+
+  char *pixelsV;
+  unique_ptr<char[]> pixelsBuffer;
+  if (getTexImage3DPixels(gl, info[10], info[11], widthV, heightV, depthV, formatV, typeV, pixelsV, pixelsBuffer)) {
+    glTexSubImage3D(targetV, levelV, xoffsetV, yoffsetV, zoffsetV, widthV, heightV, depthV, formatV, typeV, pixelsV);
+  } else {
+    Nan::ThrowError("texSubImage3D: invalid texture argument");
+  }
+}
+
+NAN_METHOD(WebGLRenderingContext::TexStorage3D) {
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+  GLenum target = info[0]->Uint32Value();
+  GLint levels = info[1]->Int32Value();
+  GLenum internalFormat = info[2]->Uint32Value();
+  GLsizei width = info[3]->Uint32Value();
+  GLsizei height = info[4]->Uint32Value();
+  GLsizei depth = info[5]->Uint32Value();
+
+  glTexStorage3D(target, levels, internalFormat, width, height, depth);
+
+  // array layers keep their count at every level; only 3D textures halve in depth
+  size_t pixelSize = getInternalFormatSize(internalFormat);
+  for (GLint i = 0; i < levels; i++) {
+    GLsizei levelDepth = target == GL_TEXTURE_3D ? std::max<GLsizei>(depth >> i, 1) : depth;
+    gl->SetTextureMemory(target, i, (size_t)std::max<GLsizei>(width >> i, 1) * std::max<GLsizei>(height >> i, 1) * levelDepth * pixelSize);
+  }
+}
+
+// compressedTexImage3D(target, level, internalformat, width, height, depth, border, srcData, srcOffset, srcLengthOverride),
+// or with imageSize and offset in place of srcData and srcOffset when a PIXEL_UNPACK_BUFFER is bound.
+bool getCompressedTexData(Local<Value> data, Local<Value> srcOffset, Local<Value> srcLengthOverride, char *&dataV, size_t &dataLengthV) {
+  if (data->IsArrayBufferView()) {
+    Local<ArrayBufferView> arrayBufferView = Local<ArrayBufferView>::Cast(data);
+    size_t elementSize = getArrayBufferViewElementSize(arrayBufferView);
+    size_t offset = srcOffset->IsNumber() ? srcOffset->Uint32Value() * elementSize : 0;
+    if (offset > arrayBufferView->ByteLength()) {
+      return false;
+    }
+    dataV = (char *)arrayBufferView->Buffer()->GetContents().Data() + arrayBufferView->ByteOffset() + offset;
+    dataLengthV = arrayBufferView->ByteLength() - offset;
+    if (srcLengthOverride->IsNumber() && srcLengthOverride->Uint32Value() > 0) {
+      size_t lengthOverride = srcLengthOverride->Uint32Value() * elementSize;
+      if (lengthOverride > dataLengthV) {
+        return false;
+      }
+      dataLengthV = lengthOverride;
+    }
+    return true;
+  } else if (data->IsNumber() && srcOffset->IsNumber()) {
+    dataLengthV = data->Uint32Value();
+    dataV = (char *)(GLintptr)srcOffset->Uint32Value();
+    return true;
+  } else {
+    return false;
+  }
+}
+
+NAN_METHOD(WebGLRenderingContext::CompressedTexImage3D) {
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+  GLenum targetV = info[0]->Uint32Value();
+  GLint levelV = info[1]->Int32Value();
+  GLenum internalformatV = info[2]->Uint32Value();
+  GLsizei widthV = info[3]->Uint32Value();
+  GLsizei heightV = info[4]->Uint32Value();
+  GLsizei depthV = info[5]->Uint32Value();
+  GLint borderV = info[6]->Int32Value();
+
+  char *dataV;
+  size_t dataLengthV;
+  if (getCompressedTexData(info[7], info[8], info[9], dataV, dataLengthV)) {
+    glCompressedTexImage3D(targetV, levelV, internalformatV, widthV, heightV, depthV, borderV, dataLengthV, dataV);
+
+    gl->SetTextureMemory(targetV, levelV, dataLengthV);
+  } else {
+    Nan::ThrowError("compressedTexImage3D: invalid arguments");
+  }
+}
+
+NAN_METHOD(WebGLRenderingContext::CompressedTexSubImage3D) {
+  GLenum targetV = info[0]->Uint32Value();
+  GLint levelV = info[1]->Int32Value();
+  GLint xoffsetV = info[2]->Int32Value();
+  GLint yoffsetV = info[3]->Int32Value();
+  GLint zoffsetV = info[4]->Int32Value();
+  GLsizei widthV = info[5]->Uint32Value();
+  GLsizei heightV = info[6]->Uint32Value();
+  GLsizei depthV = info[7]->Uint32Value();
+  GLenum formatV = info[8]->Uint32Value();
+
+  char *dataV;
+  size_t dataLengthV;
+  if (getCompressedTexData(info[9], info[10], info[11], dataV, dataLengthV)) {
+    glCompressedTexSubImage3D(targetV, levelV, xoffsetV, yoffsetV, zoffsetV, widthV, heightV, depthV, formatV, dataLengthV, dataV);
+  } else {
+    Nan::ThrowError("compressedTexSubImage3D: invalid arguments");
+  }
+}
+
+NAN_METHOD(WebGLRenderingContext::CopyTexSubImage3D) {
+  GLenum target = info[0]->Uint32Value();
+  GLint level = info[1]->Int32Value();
+  GLint xoffset = info[2]->Int32Value();
+  GLint yoffset = info[3]->Int32Value();
+  GLint zoffset = info[4]->Int32Value();
+  GLint x = info[5]->Int32Value();
+  GLint y = info[6]->Int32Value();
+  GLsizei width = info[7]->Int32Value();
+  GLsizei height = info[8]->Int32Value();
+
+  glCopyTexSubImage3D(target, level, xoffset, yoffset, zoffset, x, y, width, height);
 }
 
 NAN_METHOD(WebGLRenderingContext::ReadPixels) {
@@ -3979,6 +5140,9 @@ NAN_METHOD(WebGLRenderingContext::GetParameter) {
     case GL_SAMPLE_COVERAGE_INVERT:
     case GL_SCISSOR_TEST:
     case GL_STENCIL_TEST:
+    case GL_RASTERIZER_DISCARD:
+    case GL_TRANSFORM_FEEDBACK_ACTIVE:
+    case GL_TRANSFORM_FEEDBACK_PAUSED:
     {
       // return a boolean
       GLboolean params;
@@ -4005,6 +5169,13 @@ NAN_METHOD(WebGLRenderingContext::GetParameter) {
     case GL_IMPLEMENTATION_COLOR_READ_TYPE:
     case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS:
     case GL_MAX_CUBE_MAP_TEXTURE_SIZE:
+    case GL_MAX_3D_TEXTURE_SIZE:
+    case GL_MAX_ARRAY_TEXTURE_LAYERS:
+    case GL_MAX_SAMPLES:
+    case GL_READ_BUFFER:
+    case GL_MAX_TRANSFORM_FEEDBACK_SEPARATE_ATTRIBS:
+    case GL_MAX_TRANSFORM_FEEDBACK_INTERLEAVED_COMPONENTS:
+    case GL_MAX_TRANSFORM_FEEDBACK_SEPARATE_COMPONENTS:
     case GL_MAX_FRAGMENT_UNIFORM_VECTORS:
     case GL_MAX_RENDERBUFFER_SIZE:
     case GL_MAX_TEXTURE_IMAGE_UNITS:
@@ -4035,6 +5206,11 @@ NAN_METHOD(WebGLRenderingContext::GetParameter) {
     case GL_STENCIL_WRITEMASK:
     case GL_SUBPIXEL_BITS:
     case GL_UNPACK_ALIGNMENT:
+    case GL_UNPACK_ROW_LENGTH:
+    case GL_UNPACK_SKIP_ROWS:
+    case GL_UNPACK_SKIP_PIXELS:
+    case GL_UNPACK_IMAGE_HEIGHT:
+    case GL_UNPACK_SKIP_IMAGES:
     case UNPACK_COLORSPACE_CONVERSION_WEBGL:
     {
       // return an int
@@ -4159,6 +5335,16 @@ NAN_METHOD(WebGLRenderingContext::GetParameter) {
     case GL_RENDERBUFFER_BINDING:
     case GL_TEXTURE_BINDING_2D:
     case GL_TEXTURE_BINDING_CUBE_MAP:
+    case GL_TEXTURE_BINDING_3D:
+    case GL_TEXTURE_BINDING_2D_ARRAY:
+    case GL_SAMPLER_BINDING:
+    case GL_TRANSFORM_FEEDBACK_BINDING:
+    case GL_TRANSFORM_FEEDBACK_BUFFER_BINDING:
+    case GL_UNIFORM_BUFFER_BINDING:
+    case GL_COPY_READ_BUFFER_BINDING:
+    case GL_COPY_WRITE_BUFFER_BINDING:
+    case GL_PIXEL_PACK_BUFFER_BINDING:
+    case GL_PIXEL_UNPACK_BUFFER_BINDING:
     case GL_ACTIVE_TEXTURE:
     case GL_CURRENT_PROGRAM:
     case GL_VERTEX_ARRAY_BINDING:
@@ -4190,6 +5376,19 @@ NAN_METHOD(WebGLRenderingContext::GetParameter) {
       info.GetReturnValue().Set(arr);
       break;
     }
+#if GPU_TIMERS_SUPPORTED
+    case GL_GPU_DISJOINT_EXT: {
+      // desktop GL timers are never invalidated by a disjoint event
+      info.GetReturnValue().Set(JS_BOOL(false));
+      break;
+    }
+    case GL_TIMESTAMP: {
+      GLint64 timestamp;
+      glGetInteger64v(GL_TIMESTAMP, &timestamp);
+      info.GetReturnValue().Set(JS_NUM((double)timestamp));
+      break;
+    }
+#endif
     case UNPACK_FLIP_Y_WEBGL: {
       WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
       // return a boolean
@@ -4424,61 +5623,136 @@ NAN_METHOD(WebGLRenderingContext::GetVertexAttrib) {
   //info.GetReturnValue().Set(Nan::Undefined());
 }
 
-const char *webglExtensions[] = {
-  "ANGLE_instanced_arrays",
-  "EXT_blend_minmax",
-  "EXT_color_buffer_float",
-  "EXT_color_buffer_half_float",
-  "EXT_disjoint_timer_query",
-  "EXT_frag_depth",
-  "EXT_sRGB",
-  "EXT_shader_texture_lod",
-  "EXT_texture_filter_anisotropic",
-  "OES_element_index_uint",
-  "OES_standard_derivatives",
-  "OES_texture_float",
-  "OES_texture_float_linear",
-  "OES_texture_half_float",
-  "OES_texture_half_float_linear",
-  "OES_vertex_array_object",
-  "WEBGL_color_buffer_float",
-  "WEBGL_compressed_texture_astc",
-  "WEBGL_compressed_texture_atc",
-  "WEBGL_compressed_texture_etc",
-  "WEBGL_compressed_texture_etc1",
-  "WEBGL_compressed_texture_pvrtc",
-  "WEBGL_compressed_texture_s3tc",
-  "WEBGL_compressed_texture_s3tc_srgb",
-  "WEBGL_debug_renderer_info",
-  "WEBGL_debug_shaders",
-  "WEBGL_depth_texture",
-  "WEBGL_draw_buffers",
-  "WEBGL_lose_context",
+// WebGL extensions getExtension can return, with the driver extensions that back them; nullptr means
+// the feature is core in the GL 3.3 / GLES 3.0 contexts we create.
+struct WebGLExtension {
+  const char *name;
+  const char *glExtensions; // space-separated, any one suffices
+};
+const WebGLExtension webglExtensions[] = {
+  {"ANGLE_instanced_arrays", nullptr},
+  {"EXT_blend_minmax", nullptr},
+#if defined(LUMIN) || defined(__ANDROID__) || (defined(__APPLE__) && TARGET_OS_IPHONE)
+  {"EXT_color_buffer_float", "GL_EXT_color_buffer_float"},
+  {"EXT_color_buffer_half_float", "GL_EXT_color_buffer_half_float GL_EXT_color_buffer_float"},
+#else
+  {"EXT_color_buffer_float", nullptr},
+  {"EXT_color_buffer_half_float", nullptr},
+#endif
+#if GPU_TIMERS_SUPPORTED
+  {"EXT_disjoint_timer_query_webgl2", nullptr},
+#endif
+  {"EXT_frag_depth", nullptr},
+  {"EXT_sRGB", nullptr},
+  {"EXT_shader_texture_lod", nullptr},
+  {"EXT_texture_filter_anisotropic", "GL_EXT_texture_filter_anisotropic GL_ARB_texture_filter_anisotropic"},
+  {"OES_element_index_uint", nullptr},
+  {"OES_standard_derivatives", nullptr},
+  {"OES_texture_float", nullptr},
+#if defined(LUMIN) || defined(__ANDROID__) || (defined(__APPLE__) && TARGET_OS_IPHONE)
+  {"OES_texture_float_linear", "GL_OES_texture_float_linear"},
+#else
+  {"OES_texture_float_linear", nullptr},
+#endif
+  {"OES_texture_half_float", nullptr},
+  {"OES_texture_half_float_linear", nullptr},
+  {"OES_vertex_array_object", nullptr},
+  // desktop uploads are remapped to ETC2, which decodes ETC1 data unchanged
+  {"WEBGL_compressed_texture_etc1", "GL_OES_compressed_ETC1_RGB8_texture GL_ARB_ES3_compatibility"},
+  {"WEBGL_compressed_texture_pvrtc", "GL_IMG_texture_compression_pvrtc"},
+  {"WEBGL_compressed_texture_s3tc", "GL_EXT_texture_compression_s3tc"},
+  {"WEBGL_debug_renderer_info", nullptr},
+  {"WEBGL_depth_texture", nullptr},
+  {"WEBGL_draw_buffers", nullptr},
+  {"WEBGL_draw_instanced_base_vertex_base_instance", "GL_ARB_base_instance"},
+  {"WEBGL_multi_draw", nullptr},
 };
-NAN_METHOD(WebGLRenderingContext::GetSupportedExtensions) {
-  // GLint numExtensions;
-  // glGetIntegerv(GL_NUM_EXTENSIONS, &numExtensions);
 
-  int numExtensions = sizeof(webglExtensions)/sizeof(webglExtensions[0]);
-  Local<Array> result = Nan::New<Array>(numExtensions);
-  for (GLint i = 0; i < numExtensions; i++) {
-    // char *extension = (char *)glGetStringi(GL_EXTENSIONS, i);
-    result->Set(i, JS_STR(webglExtensions[i]));
+// Queried once per context; the driver's extension list does not change under it.
+const std::vector<const char *> &WebGLRenderingContext::GetSupportedExtensionNames() {
+  if (!supportedExtensionsQueried) {
+    std::set<std::string> glExtensions;
+    GLint numGlExtensions = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &numGlExtensions);
+    for (GLint i = 0; i < numGlExtensions; i++) {
+      const char *glExtension = (const char *)glGetStringi(GL_EXTENSIONS, i);
+      if (glExtension) {
+        glExtensions.insert(glExtension);
+      }
+    }
+
+    for (size_t i = 0; i < sizeof(webglExtensions)/sizeof(webglExtensions[0]); i++) {
+      const WebGLExtension &extension = webglExtensions[i];
+      bool supported = !extension.glExtensions;
+      if (!supported) {
+        std::string requirements(extension.glExtensions);
+        size_t start = 0;
+        while (!supported && start < requirements.size()) {
+          size_t end = requirements.find(' ', start);
+          if (end == std::string::npos) {
+            end = requirements.size();
+          }
+          supported = glExtensions.find(requirements.substr(start, end - start)) != glExtensions.end();
+          start = end + 1;
+        }
+      }
+      if (supported) {
+        supportedExtensions.push_back(extension.name);
+      }
+    }
+    supportedExtensionsQueried = true;
   }
+  return supportedExtensions;
+}
 
-  /* for (GLint i = 0; i < numExtensions; i++) {
-    char *extension = (char *)glGetStringi(GL_EXTENSIONS, i);
-    result->Set(i, JS_STR(extension));
-  } */
+bool WebGLRenderingContext::IsExtensionSupported(const char *name) {
+  const std::vector<const char *> &names = GetSupportedExtensionNames();
+  for (size_t i = 0; i < names.size(); i++) {
+    if (strcmp(names[i], name) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
 
+// A new array per call, since content may mutate what it gets back; the names themselves are cached natively.
+NAN_METHOD(WebGLRenderingContext::GetSupportedExtensions) {
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+
+  const std::vector<const char *> &names = gl->GetSupportedExtensionNames();
+  Local<Array> result = Nan::New<Array>(names.size());
+  for (size_t i = 0; i < names.size(); i++) {
+    result->Set(i, JS_STR(names[i]));
+  }
   info.GetReturnValue().Set(result);
 }
 
-// TODO GetExtension(name) return the extension name if found, should be an object...
+// Extension objects are built once per context and name; later lookups, including misses, hit the cache.
 NAN_METHOD(WebGLRenderingContext::GetExtension) {
-  String::Utf8Value name(info[0]);
-  char *sname = *name;
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+  Local<Context> context = Isolate::GetCurrent()->GetCurrentContext();
+  Local<String> nameString = info[0]->ToString();
+  Local<String> extensionsKey = JS_STR("extensions");
+
+  Local<Value> extensionsValue;
+  Local<v8::Map> extensions;
+  if (Nan::GetPrivate(info.This(), extensionsKey).ToLocal(&extensionsValue) && extensionsValue->IsMap()) {
+    extensions = Local<v8::Map>::Cast(extensionsValue);
+    if (extensions->Has(context, nameString).FromMaybe(false)) {
+      return info.GetReturnValue().Set(extensions->Get(context, nameString).ToLocalChecked());
+    }
+  } else {
+    extensions = v8::Map::New(Isolate::GetCurrent());
+    Nan::SetPrivate(info.This(), extensionsKey, extensions);
+  }
+
+  String::Utf8Value name(nameString);
+  Local<Value> result = gl->IsExtensionSupported(*name) ? MakeExtension(info.This(), *name) : Null(Isolate::GetCurrent()).As<Value>();
+  extensions->Set(context, nameString, result).ToLocalChecked();
+  info.GetReturnValue().Set(result);
+}
 
+Local<Value> WebGLRenderingContext::MakeExtension(Local<Object> glObj, const char *sname) {
   if (
     strcmp(sname, "OES_texture_float") == 0 ||
     strcmp(sname, "OES_texture_float_linear") == 0 ||
@@ -4487,54 +5761,54 @@ NAN_METHOD(WebGLRenderingContext::GetExtension) {
     strcmp(sname, "EXT_shader_texture_lod") == 0 ||
     strcmp(sname, "EXT_frag_depth") == 0
   ) {
-    info.GetReturnValue().Set(Object::New(Isolate::GetCurrent()));
+    return Object::New(Isolate::GetCurrent());
   } else if (strcmp(sname, "OES_texture_half_float") == 0) {
     Local<Object> result = Object::New(Isolate::GetCurrent());
     result->Set(String::NewFromUtf8(Isolate::GetCurrent(), "HALF_FLOAT_OES"), Number::New(Isolate::GetCurrent(), GL_HALF_FLOAT_OES));
-    info.GetReturnValue().Set(result);
+    return result;
   } else if (strcmp(sname, "OES_standard_derivatives") == 0) {
     Local<Object> result = Object::New(Isolate::GetCurrent());
     result->Set(String::NewFromUtf8(Isolate::GetCurrent(), "FRAGMENT_SHADER_DERIVATIVE_HINT_OES"), Number::New(Isolate::GetCurrent(), GL_FRAGMENT_SHADER_DERIVATIVE_HINT_OES));
-    info.GetReturnValue().Set(result);
+    return result;
   } else if (strcmp(sname, "WEBGL_depth_texture") == 0) {
     Local<Object> result = Object::New(Isolate::GetCurrent());
     result->Set(String::NewFromUtf8(Isolate::GetCurrent(), "UNSIGNED_INT_24_8_WEBGL"), Number::New(Isolate::GetCurrent(), GL_UNSIGNED_INT_24_8_OES));
-    info.GetReturnValue().Set(result);
+    return result;
   } else if (strcmp(sname, "EXT_texture_filter_anisotropic") == 0) {
     Local<Object> result = Object::New(Isolate::GetCurrent());
     result->Set(String::NewFromUtf8(Isolate::GetCurrent(), "MAX_TEXTURE_MAX_ANISOTROPY_EXT"), Number::New(Isolate::GetCurrent(), GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT));
     result->Set(String::NewFromUtf8(Isolate::GetCurrent(), "TEXTURE_MAX_ANISOTROPY_EXT"), Number::New(Isolate::GetCurrent(), GL_TEXTURE_MAX_ANISOTROPY_EXT));
-    info.GetReturnValue().Set(result);
+    return result;
   } else if (strcmp(sname, "WEBGL_compressed_texture_s3tc") == 0) {
     Local<Object> result = Object::New(Isolate::GetCurrent());
     result->Set(String::NewFromUtf8(Isolate::GetCurrent(), "COMPRESSED_RGB_S3TC_DXT1_EXT"), Number::New(Isolate::GetCurrent(), GL_COMPRESSED_RGB_S3TC_DXT1_EXT));
     result->Set(String::NewFromUtf8(Isolate::GetCurrent(), "COMPRESSED_RGBA_S3TC_DXT1_EXT"), Number::New(Isolate::GetCurrent(), GL_COMPRESSED_RGBA_S3TC_DXT1_EXT));
     result->Set(String::NewFromUtf8(Isolate::GetCurrent(), "COMPRESSED_RGBA_S3TC_DXT3_EXT"), Number::New(Isolate::GetCurrent(), GL_COMPRESSED_RGBA_S3TC_DXT3_EXT));
     result->Set(String::NewFromUtf8(Isolate::GetCurrent(), "COMPRESSED_RGBA_S3TC_DXT5_EXT"), Number::New(Isolate::GetCurrent(), GL_COMPRESSED_RGBA_S3TC_DXT5_EXT));
-    info.GetReturnValue().Set(result);
+    return result;
   } else if (strcmp(sname, "WEBGL_compressed_texture_pvrtc") == 0) {
     Local<Object> result = Object::New(Isolate::GetCurrent());
     result->Set(String::NewFromUtf8(Isolate::GetCurrent(), "COMPRESSED_RGB_PVRTC_4BPPV1_IMG"), Number::New(Isolate::GetCurrent(), GL_COMPRESSED_RGB_PVRTC_4BPPV1_IMG));
     result->Set(String::NewFromUtf8(Isolate::GetCurrent(), "COMPRESSED_RGBA_PVRTC_4BPPV1_IMG"), Number::New(Isolate::GetCurrent(), GL_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG));
     result->Set(String::NewFromUtf8(Isolate::GetCurrent(), "COMPRESSED_RGB_PVRTC_2BPPV1_IMG"), Number::New(Isolate::GetCurrent(), GL_COMPRESSED_RGB_PVRTC_2BPPV1_IMG));
     result->Set(String::NewFromUtf8(Isolate::GetCurrent(), "COMPRESSED_RGBA_PVRTC_2BPPV1_IMG"), Number::New(Isolate::GetCurrent(), GL_COMPRESSED_RGBA_PVRTC_2BPPV1_IMG));
-    info.GetReturnValue().Set(result);
+    return result;
   } else if (strcmp(sname, "WEBGL_compressed_texture_etc1") == 0) {
     Local<Object> result = Object::New(Isolate::GetCurrent());
     result->Set(String::NewFromUtf8(Isolate::GetCurrent(), "COMPRESSED_RGB_ETC1_WEBGL"), Number::New(Isolate::GetCurrent(), GL_ETC1_RGB8_OES));
-    info.GetReturnValue().Set(result);
+    return result;
   } else if (strcmp(sname, "ANGLE_instanced_arrays") == 0) {
     Local<Object> result = Object::New(Isolate::GetCurrent());
     result->Set(String::NewFromUtf8(Isolate::GetCurrent(), "GL_VERTEX_ATTRIB_ARRAY_DIVISOR_ANGLE"), Number::New(Isolate::GetCurrent(), GL_VERTEX_ATTRIB_ARRAY_DIVISOR_ANGLE));
-    result->Set(JS_STR("context"), info.This());
+    result->Set(JS_STR("context"), glObj);
     Nan::SetMethod(result, "drawArraysInstancedANGLE", DrawArraysInstancedANGLE);
     Nan::SetMethod(result, "drawElementsInstancedANGLE", DrawElementsInstancedANGLE);
     Nan::SetMethod(result, "vertexAttribDivisorANGLE", VertexAttribDivisorANGLE);
-    info.GetReturnValue().Set(result);
+    return result;
   } else if (strcmp(sname, "WEBGL_draw_buffers") == 0) {
     Local<Object> result = Object::New(Isolate::GetCurrent());
 
-    result->Set(JS_STR("context"), info.This());
+    result->Set(JS_STR("context"), glObj);
     Nan::SetMethod(result, "drawBuffersWEBGL", DrawBuffersWEBGL);
 
     result->Set(JS_STR("COLOR_ATTACHMENT0_WEBGL"), JS_INT(GL_COLOR_ATTACHMENT0));
@@ -4574,46 +5848,72 @@ NAN_METHOD(WebGLRenderingContext::GetExtension) {
     result->Set(JS_STR("MAX_COLOR_ATTACHMENTS_WEBGL"), JS_INT(GL_MAX_COLOR_ATTACHMENTS));
     result->Set(JS_STR("MAX_DRAW_BUFFERS_WEBGL"), JS_INT(GL_MAX_DRAW_BUFFERS));
 
-    info.GetReturnValue().Set(result);
+    return result;
   } else if (strcmp(sname, "WEBGL_debug_renderer_info") == 0) {
     Local<Object> result = Object::New(Isolate::GetCurrent());
     result->Set(JS_STR("UNMASKED_RENDERER_WEBGL"), JS_INT(GL_RENDERER));
     result->Set(JS_STR("UNMASKED_VENDOR_WEBGL"), JS_INT(GL_VENDOR));
-    info.GetReturnValue().Set(result);
+    return result;
   } else if (strcmp(sname, "EXT_color_buffer_float") == 0) {
     Local<Object> result = Object::New(Isolate::GetCurrent());
-    info.GetReturnValue().Set(result);
+    return result;
   } else if (strcmp(sname, "EXT_color_buffer_half_float") == 0) {
     Local<Object> result = Object::New(Isolate::GetCurrent());
     result->Set(JS_STR("FRAMEBUFFER_ATTACHMENT_COMPONENT_TYPE_EXT"), JS_INT(GL_FRAMEBUFFER_ATTACHMENT_COMPONENT_TYPE_EXT));
     result->Set(JS_STR("RGB16F_EXT"), JS_INT(GL_RGB16F_EXT));
     result->Set(JS_STR("RGBA16F_EXT"), JS_INT(GL_RGBA16F_EXT));
     result->Set(JS_STR("UNSIGNED_NORMALIZED_EXT"), JS_INT(GL_UNSIGNED_NORMALIZED_EXT));
-    info.GetReturnValue().Set(result);
+    return result;
   } else if (strcmp(sname, "EXT_blend_minmax") == 0) {
     // Adds two constants: developer.mozilla.org/docs/Web/API/EXT_blend_minmax
     Local<Object> result = Object::New(Isolate::GetCurrent());
     result->Set(JS_STR("MIN_EXT"), JS_INT(GL_MIN_EXT));
     result->Set(JS_STR("MAX_EXT"), JS_INT(GL_MAX_EXT));
-    info.GetReturnValue().Set(result);
+    return result;
   } else if (strcmp(sname, "EXT_sRGB") == 0) {
     Local<Object> result = Object::New(Isolate::GetCurrent());
     result->Set(JS_STR("FRAMEBUFFER_ATTACHMENT_COLOR_ENCODING_EXT"), JS_INT(GL_FRAMEBUFFER_ATTACHMENT_COLOR_ENCODING_EXT));
     result->Set(JS_STR("SRGB8_ALPHA8_EXT"), JS_INT(GL_SRGB8_ALPHA8_EXT));
     result->Set(JS_STR("SRGB_ALPHA_EXT"), JS_INT(GL_SRGB_ALPHA_EXT));
     result->Set(JS_STR("SRGB_EXT"), JS_INT(GL_SRGB_EXT));
-    info.GetReturnValue().Set(result);
+    return result;
+#if GPU_TIMERS_SUPPORTED
+  } else if (strcmp(sname, "EXT_disjoint_timer_query_webgl2") == 0) {
+    // queries themselves go through the WebGL2 createQuery/beginQuery/getQueryParameter entry points
+    Local<Object> result = Object::New(Isolate::GetCurrent());
+    result->Set(JS_STR("context"), glObj);
+    result->Set(JS_STR("QUERY_COUNTER_BITS_EXT"), JS_INT(GL_QUERY_COUNTER_BITS));
+    result->Set(JS_STR("TIME_ELAPSED_EXT"), JS_INT(GL_TIME_ELAPSED));
+    result->Set(JS_STR("TIMESTAMP_EXT"), JS_INT(GL_TIMESTAMP));
+    result->Set(JS_STR("GPU_DISJOINT_EXT"), JS_INT(GL_GPU_DISJOINT_EXT));
+    Nan::SetMethod(result, "queryCounterEXT", QueryCounterEXT);
+    return result;
+#endif
+  } else if (strcmp(sname, "WEBGL_multi_draw") == 0) {
+    Local<Object> result = Object::New(Isolate::GetCurrent());
+    result->Set(JS_STR("context"), glObj);
+    Nan::SetMethod(result, "multiDrawArraysWEBGL", glExtensionCallWrap<MultiDrawArraysWEBGL>);
+    Nan::SetMethod(result, "multiDrawElementsWEBGL", glExtensionCallWrap<MultiDrawElementsWEBGL>);
+    Nan::SetMethod(result, "multiDrawArraysInstancedWEBGL", glExtensionCallWrap<MultiDrawArraysInstancedWEBGL>);
+    Nan::SetMethod(result, "multiDrawElementsInstancedWEBGL", glExtensionCallWrap<MultiDrawElementsInstancedWEBGL>);
+    return result;
+  } else if (strcmp(sname, "WEBGL_draw_instanced_base_vertex_base_instance") == 0) {
+    Local<Object> result = Object::New(Isolate::GetCurrent());
+    result->Set(JS_STR("context"), glObj);
+    Nan::SetMethod(result, "drawArraysInstancedBaseInstanceWEBGL", glExtensionCallWrap<DrawArraysInstancedBaseInstanceWEBGL>);
+    Nan::SetMethod(result, "drawElementsInstancedBaseVertexBaseInstanceWEBGL", glExtensionCallWrap<DrawElementsInstancedBaseVertexBaseInstanceWEBGL>);
+    return result;
   } else if (strcmp(sname, "OES_vertex_array_object") == 0) {
     // Same as other vertex array methods, but with the OES suffix for WebGL 1.
     Local<Object> result = Object::New(Isolate::GetCurrent());
-    result->Set(JS_STR("context"), info.This());
+    result->Set(JS_STR("context"), glObj);
     Nan::SetMethod(result, "createVertexArrayOES", CreateVertexArray);
     Nan::SetMethod(result, "deleteVertexArrayOES", DeleteVertexArray);
     Nan::SetMethod(result, "isVertexArrayOES", IsVertexArray);
     Nan::SetMethod(result, "bindVertexArrayOES", BindVertexArrayOES);
-    info.GetReturnValue().Set(result);
+    return result;
   } else {
-    info.GetReturnValue().Set(Null(Isolate::GetCurrent()));
+    return Null(Isolate::GetCurrent());
   }
 }
 
@@ -4661,6 +5961,95 @@ NAN_METHOD(WebGLRenderingContext::BindVertexArrayOES) {
   gl->SetVertexArrayBinding(vao);
 }
 
+NAN_METHOD(WebGLRenderingContext::CreateTransformFeedback) {
+  GLuint transformFeedback;
+  glGenTransformFeedbacks(1, &transformFeedback);
+
+  Local<Object> transformFeedbackObject = Nan::New<Object>();
+  transformFeedbackObject->Set(JS_STR("id"), JS_INT(transformFeedback));
+  info.GetReturnValue().Set(transformFeedbackObject);
+}
+
+NAN_METHOD(WebGLRenderingContext::DeleteTransformFeedback) {
+  GLuint transformFeedback = info[0]->IsObject() ? info[0]->ToObject()->Get(JS_STR("id"))->Uint32Value() : 0;
+
+  glDeleteTransformFeedbacks(1, &transformFeedback);
+}
+
+NAN_METHOD(WebGLRenderingContext::IsTransformFeedback) {
+  GLuint transformFeedback = info[0]->IsObject() ? info[0]->ToObject()->Get(JS_STR("id"))->Uint32Value() : 0;
+
+  info.GetReturnValue().Set(JS_BOOL(glIsTransformFeedback(transformFeedback)));
+}
+
+NAN_METHOD(WebGLRenderingContext::BindTransformFeedback) {
+  GLenum target = info[0]->Uint32Value();
+  GLuint transformFeedback = info[1]->IsObject() ? info[1]->ToObject()->Get(JS_STR("id"))->Uint32Value() : 0;
+
+  glBindTransformFeedback(target, transformFeedback);
+}
+
+NAN_METHOD(WebGLRenderingContext::BeginTransformFeedback) {
+  GLenum primitiveMode = info[0]->Uint32Value();
+
+  glBeginTransformFeedback(primitiveMode);
+}
+
+NAN_METHOD(WebGLRenderingContext::EndTransformFeedback) {
+  glEndTransformFeedback();
+}
+
+NAN_METHOD(WebGLRenderingContext::PauseTransformFeedback) {
+  glPauseTransformFeedback();
+}
+
+NAN_METHOD(WebGLRenderingContext::ResumeTransformFeedback) {
+  glResumeTransformFeedback();
+}
+
+// Varyings only take effect at the next linkProgram, as in WebGL2.
+NAN_METHOD(WebGLRenderingContext::TransformFeedbackVaryings) {
+  if (info[0]->IsObject() && info[1]->IsArray()) {
+    GLuint programId = info[0]->ToObject()->Get(JS_STR("id"))->Uint32Value();
+    Local<Array> varyings = Local<Array>::Cast(info[1]);
+    GLenum bufferMode = info[2]->Uint32Value();
+
+    std::vector<std::string> names(varyings->Length());
+    std::vector<const GLchar *> namePtrs(varyings->Length());
+    for (uint32_t i = 0; i < varyings->Length(); i++) {
+      names[i] = *Nan::Utf8String(varyings->Get(i));
+      namePtrs[i] = names[i].c_str();
+    }
+
+    glTransformFeedbackVaryings(programId, namePtrs.size(), namePtrs.data(), bufferMode);
+  } else {
+    Nan::ThrowError("transformFeedbackVaryings: invalid arguments");
+  }
+}
+
+NAN_METHOD(WebGLRenderingContext::GetTransformFeedbackVarying) {
+  GLuint programId = info[0]->ToObject()->Get(JS_STR("id"))->Uint32Value();
+  GLuint index = info[1]->Uint32Value();
+
+  char name[1024];
+  GLsizei length = 0;
+  GLsizei size;
+  GLenum type;
+
+  glGetTransformFeedbackVarying(programId, index, sizeof(name), &length, &size, &type, name);
+
+  if (length > 0) {
+    Local<Object> activeInfo = Nan::New<Object>();
+    activeInfo->Set(JS_STR("size"), JS_INT(size));
+    activeInfo->Set(JS_STR("type"), JS_INT((int)type));
+    activeInfo->Set(JS_STR("name"), JS_STR(name, length));
+
+    info.GetReturnValue().Set(activeInfo);
+  } else {
+    info.GetReturnValue().Set(Nan::Null());
+  }
+}
+
 NAN_METHOD(WebGLRenderingContext::FenceSync) {
   GLenum condition = info[0]->Uint32Value();
   GLbitfield flags = info[1]->Uint32Value();
@@ -4714,6 +6103,279 @@ NAN_METHOD(WebGLRenderingContext::GetSyncParameter) {
   info.GetReturnValue().Set(JS_INT(result));
 }
 
+// Desktop GL only has the conservative occlusion query from 4.3 on; the exact query is a valid, stricter answer.
+inline GLenum getQueryTarget(GLenum target) {
+#if !defined(LUMIN) && !defined(__ANDROID__) && !(defined(__APPLE__) && TARGET_OS_IPHONE)
+  if (target == GL_ANY_SAMPLES_PASSED_CONSERVATIVE) {
+    return GL_ANY_SAMPLES_PASSED;
+  }
+#endif
+  return target;
+}
+
+NAN_METHOD(WebGLRenderingContext::CreateQuery) {
+  GLuint query;
+  glGenQueries(1, &query);
+
+  Local<Object> queryObject = Nan::New<Object>();
+  queryObject->Set(JS_STR("id"), JS_INT(query));
+  info.GetReturnValue().Set(queryObject);
+}
+
+NAN_METHOD(WebGLRenderingContext::DeleteQuery) {
+  GLuint query = info[0]->IsObject() ? info[0]->ToObject()->Get(JS_STR("id"))->Uint32Value() : 0;
+
+  glDeleteQueries(1, &query);
+}
+
+NAN_METHOD(WebGLRenderingContext::IsQuery) {
+  GLuint query = info[0]->IsObject() ? info[0]->ToObject()->Get(JS_STR("id"))->Uint32Value() : 0;
+
+  info.GetReturnValue().Set(JS_BOOL(glIsQuery(query)));
+}
+
+NAN_METHOD(WebGLRenderingContext::BeginQuery) {
+  GLenum target = info[0]->Uint32Value();
+  GLuint query = info[1]->IsObject() ? info[1]->ToObject()->Get(JS_STR("id"))->Uint32Value() : 0;
+
+  glBeginQuery(getQueryTarget(target), query);
+}
+
+NAN_METHOD(WebGLRenderingContext::EndQuery) {
+  GLenum target = info[0]->Uint32Value();
+
+  glEndQuery(getQueryTarget(target));
+}
+
+NAN_METHOD(WebGLRenderingContext::GetQuery) {
+  GLenum target = info[0]->Uint32Value();
+  GLenum pname = info[1]->Uint32Value();
+
+  if (pname == GL_CURRENT_QUERY) {
+    GLint query = 0;
+    glGetQueryiv(getQueryTarget(target), GL_CURRENT_QUERY, &query);
+
+    if (query != 0) {
+      Local<Object> queryObject = Nan::New<Object>();
+      queryObject->Set(JS_STR("id"), JS_INT(query));
+      info.GetReturnValue().Set(queryObject);
+    } else {
+      info.GetReturnValue().Set(Nan::Null());
+    }
+#if GPU_TIMERS_SUPPORTED
+  } else if (pname == GL_QUERY_COUNTER_BITS) {
+    GLint bits = 0;
+    glGetQueryiv(target, GL_QUERY_COUNTER_BITS, &bits);
+    info.GetReturnValue().Set(JS_INT(bits));
+#endif
+  } else {
+    info.GetReturnValue().Set(Nan::Null());
+  }
+}
+
+NAN_METHOD(WebGLRenderingContext::GetQueryParameter) {
+  GLuint query = info[0]->IsObject() ? info[0]->ToObject()->Get(JS_STR("id"))->Uint32Value() : 0;
+  GLenum pname = info[1]->Uint32Value();
+
+  if (pname == GL_QUERY_RESULT_AVAILABLE) {
+    GLuint available = 0;
+    glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+    info.GetReturnValue().Set(JS_BOOL(available != 0));
+  } else if (pname == GL_QUERY_RESULT) {
+    // reading an unfinished result would stall until the GPU catches up, so report none yet
+    GLuint available = 0;
+    glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+      return info.GetReturnValue().Set(Nan::Null());
+    }
+
+#if GPU_TIMERS_SUPPORTED
+    // elapsed-time results are nanoseconds and can exceed 32 bits
+    GLuint64 result = 0;
+    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &result);
+    info.GetReturnValue().Set(JS_NUM((double)result));
+#else
+    GLuint result = 0;
+    glGetQueryObjectuiv(query, GL_QUERY_RESULT, &result);
+    info.GetReturnValue().Set(JS_NUM((double)result));
+#endif
+  } else {
+    info.GetReturnValue().Set(Nan::Null());
+  }
+}
+
+NAN_METHOD(WebGLRenderingContext::CreateSampler) {
+  GLuint sampler;
+  glGenSamplers(1, &sampler);
+
+  Local<Object> samplerObject = Nan::New<Object>();
+  samplerObject->Set(JS_STR("id"), JS_INT(sampler));
+  info.GetReturnValue().Set(samplerObject);
+}
+
+NAN_METHOD(WebGLRenderingContext::DeleteSampler) {
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+  GLuint sampler = info[0]->IsObject() ? info[0]->ToObject()->Get(JS_STR("id"))->Uint32Value() : 0;
+
+  glDeleteSamplers(1, &sampler);
+
+  // deleting a sampler unbinds it from every unit
+  if (sampler != 0) {
+    for (auto iter = gl->samplerBindings.begin(); iter != gl->samplerBindings.end(); iter++) {
+      if (iter->second == sampler) {
+        iter->second = 0;
+      }
+    }
+  }
+}
+
+NAN_METHOD(WebGLRenderingContext::IsSampler) {
+  GLuint sampler = info[0]->IsObject() ? info[0]->ToObject()->Get(JS_STR("id"))->Uint32Value() : 0;
+
+  info.GetReturnValue().Set(JS_BOOL(glIsSampler(sampler)));
+}
+
+NAN_METHOD(WebGLRenderingContext::BindSampler) {
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+  GLuint unit = info[0]->Uint32Value();
+  GLuint sampler = info[1]->IsObject() ? info[1]->ToObject()->Get(JS_STR("id"))->Uint32Value() : 0;
+
+  if (!gl->HasSamplerBinding(unit) || gl->GetSamplerBinding(unit) != sampler) {
+    glBindSampler(unit, sampler);
+
+    gl->SetSamplerBinding(unit, sampler);
+  }
+}
+
+NAN_METHOD(WebGLRenderingContext::SamplerParameteri) {
+  GLuint sampler = info[0]->IsObject() ? info[0]->ToObject()->Get(JS_STR("id"))->Uint32Value() : 0;
+  GLenum pname = info[1]->Uint32Value();
+  GLint param = info[2]->Int32Value();
+
+  glSamplerParameteri(sampler, pname, param);
+}
+
+NAN_METHOD(WebGLRenderingContext::SamplerParameterf) {
+  GLuint sampler = info[0]->IsObject() ? info[0]->ToObject()->Get(JS_STR("id"))->Uint32Value() : 0;
+  GLenum pname = info[1]->Uint32Value();
+  GLfloat param = info[2]->NumberValue();
+
+  glSamplerParameterf(sampler, pname, param);
+}
+
+NAN_METHOD(WebGLRenderingContext::GetSamplerParameter) {
+  GLuint sampler = info[0]->IsObject() ? info[0]->ToObject()->Get(JS_STR("id"))->Uint32Value() : 0;
+  GLenum pname = info[1]->Uint32Value();
+
+  if (pname == GL_TEXTURE_MIN_LOD || pname == GL_TEXTURE_MAX_LOD || pname == GL_TEXTURE_MAX_ANISOTROPY_EXT) {
+    GLfloat param = 0;
+    glGetSamplerParameterfv(sampler, pname, &param);
+    info.GetReturnValue().Set(JS_FLOAT(param));
+  } else {
+    GLint param = 0;
+    glGetSamplerParameteriv(sampler, pname, &param);
+    info.GetReturnValue().Set(JS_INT(param));
+  }
+}
+
+NAN_METHOD(WebGLRenderingContext::QueryCounterEXT) {
+  Local<Object> contextObj = Local<Object>::Cast(info.This()->Get(JS_STR("context")));
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(contextObj);
+  GLuint query = info[0]->IsObject() ? info[0]->ToObject()->Get(JS_STR("id"))->Uint32Value() : 0;
+
+  if (gl->live) {
+    if (gl->windowHandle) {
+      windowsystem::SetCurrentWindowContext(gl->windowHandle);
+    }
+#if GPU_TIMERS_SUPPORTED
+    glQueryCounter(query, GL_TIMESTAMP);
+#endif
+  }
+}
+
+NAN_METHOD(WebGLRenderingContext::SetGpuTimersEnabled) {
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+  bool enabled = info[0]->BooleanValue() && GpuProfiler::IsSupported();
+
+  if (enabled && !gl->gpuProfiler) {
+    gl->gpuProfiler = new GpuProfiler();
+  } else if (!enabled && gl->gpuProfiler) {
+    gl->gpuProfiler->DeleteQueries();
+    delete gl->gpuProfiler;
+    gl->gpuProfiler = nullptr;
+  }
+
+  info.GetReturnValue().Set(JS_BOOL(enabled));
+}
+
+// Returns how bufferSubData calls were serviced since the last call, then resets: orphaned whole-buffer rewrites,
+// uploads streamed through the staging ring, uploads that fell back to glBufferSubData and how many of those were
+// because the ring was still in use by the GPU.
+NAN_METHOD(WebGLRenderingContext::GetBufferUploadStats) {
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+  BufferStream *bufferStream = gl->bufferStream;
+
+  Local<Object> result = Nan::New<Object>();
+  result->Set(JS_STR("orphans"), JS_INT(bufferStream->orphans));
+  result->Set(JS_STR("streamed"), JS_INT(bufferStream->streamed));
+  result->Set(JS_STR("streamedBytes"), JS_NUM((double)bufferStream->bytes));
+  result->Set(JS_STR("direct"), JS_INT(bufferStream->direct));
+  result->Set(JS_STR("stalls"), JS_INT(bufferStream->stalls));
+  result->Set(JS_STR("ring"), JS_BOOL(BufferStream::IsSupported()));
+  bufferStream->orphans = 0;
+  bufferStream->streamed = 0;
+  bufferStream->bytes = 0;
+  bufferStream->direct = 0;
+  bufferStream->stalls = 0;
+
+  info.GetReturnValue().Set(result);
+}
+
+NAN_METHOD(WebGLRenderingContext::BeginGpuTimer) {
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+  uint32_t phase = info[0]->Uint32Value();
+
+  if (gl->gpuProfiler && phase < GPU_TIMER_PHASE_COUNT) {
+    gl->gpuProfiler->Begin((GpuTimerPhase)phase);
+  }
+}
+
+NAN_METHOD(WebGLRenderingContext::EndGpuTimer) {
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+  uint32_t phase = info[0]->Uint32Value();
+
+  if (gl->gpuProfiler && phase < GPU_TIMER_PHASE_COUNT) {
+    gl->gpuProfiler->End((GpuTimerPhase)phase);
+  }
+}
+
+// Returns mean GPU milliseconds per phase over the samples that completed since the last call, then resets.
+NAN_METHOD(WebGLRenderingContext::GetGpuTimes) {
+  WebGLRenderingContext *gl = ObjectWrap::Unwrap<WebGLRenderingContext>(info.This());
+
+  if (gl->gpuProfiler) {
+    GpuProfiler *gpuProfiler = gl->gpuProfiler;
+    gpuProfiler->Poll();
+
+    const char *names[GPU_TIMER_PHASE_COUNT] = {"draw", "compose", "blit"};
+    Local<Object> result = Nan::New<Object>();
+    for (int i = 0; i < GPU_TIMER_PHASE_COUNT; i++) {
+      double mean = gpuProfiler->GetMean((GpuTimerPhase)i);
+      result->Set(JS_STR(names[i]), mean >= 0 ? JS_NUM(mean / 1e6) : Nan::Null().As<Value>());
+    }
+    uint32_t numDropped = 0;
+    for (int i = 0; i < GPU_TIMER_PHASE_COUNT; i++) {
+      numDropped += gpuProfiler->GetDropped((GpuTimerPhase)i);
+    }
+    result->Set(JS_STR("dropped"), JS_INT(numDropped));
+    gpuProfiler->Reset();
+
+    info.GetReturnValue().Set(result);
+  } else {
+    info.GetReturnValue().Set(Nan::Null());
+  }
+}
+
 // WebGL2RenderingContext
 
 WebGL2RenderingContext::WebGL2RenderingContext() {}
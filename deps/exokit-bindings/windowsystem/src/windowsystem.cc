@@ -1,4 +1,6 @@
 #include <windowsystem.h>
+#include <webglcontext/include/gpu-profiler.h>
+#include <trace.h>
 
 namespace windowsystembase {
 
@@ -394,14 +396,41 @@ void ComposeLayer(ComposeSpec *composeSpec, const LayerSpec &layer) {
 }
 
 void ComposeLayers(WebGLRenderingContext *gl, GLuint fbo, const std::vector<LayerSpec> &layers) {
+  TRACE_SCOPE("gl", "ComposeLayers");
   ComposeSpec *composeSpec = (ComposeSpec *)(gl->keys[GlKey::GL_KEY_COMPOSE]);
 
+  if (gl->gpuProfiler) {
+    gl->gpuProfiler->Begin(GPU_TIMER_PHASE_COMPOSE);
+  }
+
+  // a capture left running would reject the compose program, and rasterizer discard would drop the clear and draws
+  GLint transformFeedbackActive, transformFeedbackPaused;
+  glGetIntegerv(GL_TRANSFORM_FEEDBACK_ACTIVE, &transformFeedbackActive);
+  glGetIntegerv(GL_TRANSFORM_FEEDBACK_PAUSED, &transformFeedbackPaused);
+  bool pauseTransformFeedback = transformFeedbackActive && !transformFeedbackPaused;
+  if (pauseTransformFeedback) {
+    glPauseTransformFeedback();
+  }
+  GLboolean rasterizerDiscard = glIsEnabled(GL_RASTERIZER_DISCARD);
+  if (rasterizerDiscard) {
+    glDisable(GL_RASTERIZER_DISCARD);
+  }
+
   glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo);
   glBindVertexArray(composeSpec->composeVao);
   glUseProgram(composeSpec->composeProgram);
 
   glClear(GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT|GL_STENCIL_BUFFER_BIT);
 
+  GLuint sampler0 = gl->HasSamplerBinding(0) ? gl->GetSamplerBinding(0) : 0;
+  GLuint sampler1 = gl->HasSamplerBinding(1) ? gl->GetSamplerBinding(1) : 0;
+  if (sampler0 != 0) {
+    glBindSampler(0, 0);
+  }
+  if (sampler1 != 0) {
+    glBindSampler(1, 0);
+  }
+
   /* // blit
   for (size_t i = 0; i < layers.size(); i++) {
     const LayerSpec &layer = layers[i];
@@ -489,13 +518,39 @@ void ComposeLayers(WebGLRenderingContext *gl, GLuint fbo, const std::vector<Laye
   } else {
     glBindTexture(GL_TEXTURE_2D, 0);
   }
+  if (gl->HasTextureBinding(GL_TEXTURE0, GL_TEXTURE_2D_MULTISAMPLE)) {
+    glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, gl->GetTextureBinding(GL_TEXTURE0, GL_TEXTURE_2D_MULTISAMPLE));
+  } else {
+    glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+  }
   glActiveTexture(GL_TEXTURE1);
   if (gl->HasTextureBinding(GL_TEXTURE1, GL_TEXTURE_2D)) {
     glBindTexture(GL_TEXTURE_2D, gl->GetTextureBinding(GL_TEXTURE1, GL_TEXTURE_2D));
   } else {
     glBindTexture(GL_TEXTURE_2D, 0);
   }
+  if (gl->HasTextureBinding(GL_TEXTURE1, GL_TEXTURE_2D_MULTISAMPLE)) {
+    glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, gl->GetTextureBinding(GL_TEXTURE1, GL_TEXTURE_2D_MULTISAMPLE));
+  } else {
+    glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+  }
   glActiveTexture(gl->activeTexture);
+  if (sampler0 != 0) {
+    glBindSampler(0, sampler0);
+  }
+  if (sampler1 != 0) {
+    glBindSampler(1, sampler1);
+  }
+  if (rasterizerDiscard) {
+    glEnable(GL_RASTERIZER_DISCARD);
+  }
+  if (pauseTransformFeedback) {
+    glResumeTransformFeedback();
+  }
+
+  if (gl->gpuProfiler) {
+    gl->gpuProfiler->End(GPU_TIMER_PHASE_COMPOSE);
+  }
 }
 
 NAN_METHOD(ComposeLayers) {
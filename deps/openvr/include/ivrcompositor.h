@@ -4,7 +4,10 @@
 #include <nan.h>
 #include <v8.h>
 
+#include <memory>
+
 #include <webgl.h>
+#include <pose-source.h>
 
 // Forward declaration of OpenVR class.
 // We only need the pointer here, so this is cleaner than importing the header.
@@ -19,15 +22,19 @@ public:
   static NAN_MODULE_INIT(Init);
 
   // Static factory construction method for other node addons to use.
-  static v8::Local<v8::Object> NewInstance(vr::IVRCompositor *compositor);
+  static v8::Local<v8::Object> NewInstance(vr::IVRCompositor *compositor, PoseSource *poseSource = nullptr);
 
 private:
-  explicit IVRCompositor(vr::IVRCompositor *self);
+  IVRCompositor(vr::IVRCompositor *self, PoseSource *poseSource);
   ~IVRCompositor() = default;
 
+  // Returns the pose source, binding the OpenVR one to `system` for a real compositor.
+  PoseSource *GetPoseSource(v8::Local<v8::Value> system);
+
   // Node construction method for new instances.
   static NAN_METHOD(New);
 
+  static NAN_METHOD(SetPoseBuffers);
   static NAN_METHOD(WaitGetPoses);
   static NAN_METHOD(Submit);
 
@@ -39,9 +46,17 @@ private:
   }
 
   /// Reference to wrapped OpenVR instance.
+  /// Null for a mock compositor.
   vr::IVRCompositor * const self_;
+
+  std::unique_ptr<PoseSource> poseSource_;
+
+  /// Registered pose outputs (hmd, left controller, right controller), written in place every frame.
+  Nan::Persistent<v8::Float32Array> poseArrays_[3];
+  float *poseBuffers_[3];
 };
 
 NAN_METHOD(NewCompositor);
+NAN_METHOD(NewMockCompositor);
 
 #endif
@@ -0,0 +1,53 @@
+#ifndef _OPENVR_POSE_SOURCE_H_
+#define _OPENVR_POSE_SOURCE_H_
+
+#include <chrono>
+#include <cstdint>
+
+namespace vr
+{
+class IVRCompositor;
+class IVRSystem;
+}
+
+// Number of floats in one column-major 4x4 pose matrix.
+#define POSE_MATRIX_SIZE 16
+
+// Supplies the per-frame HMD and controller poses consumed by IVRCompositor::WaitGetPoses.
+// Each output is a column-major 4x4 matrix; a matrix whose first element is NaN has no valid pose.
+class PoseSource
+{
+public:
+  virtual ~PoseSource() = default;
+
+  // Blocks until the next frame and writes the latest poses.
+  virtual void WaitGetPoses(float *hmd, float *leftController, float *rightController) = 0;
+};
+
+// Reads poses from the OpenVR runtime.
+class OpenVRPoseSource : public PoseSource
+{
+public:
+  OpenVRPoseSource(vr::IVRCompositor *compositor, vr::IVRSystem *system);
+
+  void WaitGetPoses(float *hmd, float *leftController, float *rightController) override;
+
+  vr::IVRCompositor *compositor;
+  vr::IVRSystem *system;
+};
+
+// Deterministic poses derived from a frame counter, for running without a headset.
+// If fps is non-zero, WaitGetPoses paces itself to that frame rate.
+class MockPoseSource : public PoseSource
+{
+public:
+  explicit MockPoseSource(double fps);
+
+  void WaitGetPoses(float *hmd, float *leftController, float *rightController) override;
+
+  double fps;
+  uint64_t frame;
+  std::chrono::steady_clock::time_point nextFrameTime;
+};
+
+#endif
@@ -1,14 +1,11 @@
 #include <ivrcompositor.h>
 
-#include <array>
 #include <node.h>
 #include <openvr.h>
 #include <ivrsystem.h>
 
 using namespace v8;
 
-using TrackedDevicePoseArray = std::array<vr::TrackedDevicePose_t, vr::k_unMaxTrackedDeviceCount>;
-
 //=============================================================================
 NAN_MODULE_INIT(IVRCompositor::Init)
 {
@@ -22,6 +19,7 @@ NAN_MODULE_INIT(IVRCompositor::Init)
   tpl->InstanceTemplate()->SetInternalFieldCount(1);
 
   // Assign all the wrapped methods of this object.
+  Nan::SetPrototypeMethod(tpl, "SetPoseBuffers", SetPoseBuffers);
   Nan::SetPrototypeMethod(tpl, "WaitGetPoses", WaitGetPoses);
   Nan::SetPrototypeMethod(tpl, "Submit", Submit);
 
@@ -30,17 +28,17 @@ NAN_MODULE_INIT(IVRCompositor::Init)
 }
 
 //=============================================================================
-Local<Object> IVRCompositor::NewInstance(vr::IVRCompositor *compositor)
+Local<Object> IVRCompositor::NewInstance(vr::IVRCompositor *compositor, PoseSource *poseSource)
 {
   Nan::EscapableHandleScope scope;
   Local<Function> cons = Nan::New(constructor());
-  Local<Value> argv[1] = { Nan::New<External>(compositor) };
-  return scope.Escape(Nan::NewInstance(cons, 1, argv).ToLocalChecked());
+  Local<Value> argv[2] = { Nan::New<External>(compositor), Nan::New<External>(poseSource) };
+  return scope.Escape(Nan::NewInstance(cons, 2, argv).ToLocalChecked());
 }
 
 //=============================================================================
-IVRCompositor::IVRCompositor(vr::IVRCompositor *self)
-: self_(self)
+IVRCompositor::IVRCompositor(vr::IVRCompositor *self, PoseSource *poseSource)
+: self_(self), poseSource_(poseSource), poseBuffers_{nullptr, nullptr, nullptr}
 {
   // Do nothing.
 }
@@ -54,20 +52,44 @@ NAN_METHOD(IVRCompositor::New)
     return;
   }
 
-  if (info.Length() != 1 || !info[0]->IsExternal())
+  if (info.Length() != 2 || !info[0]->IsExternal() || !info[1]->IsExternal())
   {
-    Nan::ThrowTypeError("Argument[0] must be an `IVRCompositor*`.");
+    Nan::ThrowTypeError("Arguments must be an `IVRCompositor*` and a `PoseSource*`.");
     return;
   }
 
   auto wrapped_instance = static_cast<vr::IVRCompositor*>(
     Local<External>::Cast(info[0])->Value());
-  IVRCompositor *obj = new IVRCompositor(wrapped_instance);
+  auto pose_source = static_cast<PoseSource*>(
+    Local<External>::Cast(info[1])->Value());
+  IVRCompositor *obj = new IVRCompositor(wrapped_instance, pose_source);
   obj->Wrap(info.This());
   info.GetReturnValue().Set(info.This());
 }
 
-NAN_METHOD(IVRCompositor::WaitGetPoses)
+namespace {
+
+float *getPoseArrayData(Local<Float32Array> array) {
+  Local<ArrayBuffer> buffer = array->Buffer();
+  return reinterpret_cast<float *>(static_cast<char *>(buffer->GetContents().Data()) + array->ByteOffset());
+}
+
+}
+
+PoseSource *IVRCompositor::GetPoseSource(Local<Value> system)
+{
+  if (self_ && system->IsObject()) {
+    vr::IVRSystem *vrSystem = IVRSystem::Unwrap<IVRSystem>(Local<Object>::Cast(system))->self_;
+    // a real compositor only ever holds an OpenVRPoseSource
+    OpenVRPoseSource *openVRPoseSource = static_cast<OpenVRPoseSource *>(poseSource_.get());
+    if (!openVRPoseSource || openVRPoseSource->system != vrSystem) {
+      poseSource_.reset(new OpenVRPoseSource(self_, vrSystem));
+    }
+  }
+  return poseSource_.get();
+}
+
+NAN_METHOD(IVRCompositor::SetPoseBuffers)
 {
   IVRCompositor* obj = ObjectWrap::Unwrap<IVRCompositor>(info.Holder());
 
@@ -77,62 +99,69 @@ NAN_METHOD(IVRCompositor::WaitGetPoses)
     return;
   }
 
-  TrackedDevicePoseArray trackedDevicePoseArray;
-	obj->self_->WaitGetPoses(trackedDevicePoseArray.data(), static_cast<uint32_t>(trackedDevicePoseArray.size()), nullptr, 0);
-
-  IVRSystem* system = IVRSystem::Unwrap<IVRSystem>(Local<Object>::Cast(info[0]));
-  Local<Float32Array> hmdFloat32Array = Local<Float32Array>::Cast(info[1]);
-  Local<Float32Array> leftControllerFloat32Array = Local<Float32Array>::Cast(info[2]);
-  Local<Float32Array> rightControllerFloat32Array = Local<Float32Array>::Cast(info[3]);
-  hmdFloat32Array->Set(0, Number::New(Isolate::GetCurrent(), std::numeric_limits<float>::quiet_NaN()));
-  leftControllerFloat32Array->Set(0, Number::New(Isolate::GetCurrent(), std::numeric_limits<float>::quiet_NaN()));
-  rightControllerFloat32Array->Set(0, Number::New(Isolate::GetCurrent(), std::numeric_limits<float>::quiet_NaN()));
-
-  for (unsigned int i = 0; i < trackedDevicePoseArray.size(); i++) {
-    const vr::TrackedDevicePose_t &trackedDevicePose = trackedDevicePoseArray[i];
-    if (trackedDevicePose.bPoseIsValid) {
-      const vr::ETrackedDeviceClass deviceClass = system->self_->GetTrackedDeviceClass(i);
-      if (deviceClass == vr::TrackedDeviceClass_HMD) {
-        const vr::HmdMatrix34_t &matrix = trackedDevicePose.mDeviceToAbsoluteTracking;
-
-        for (unsigned int v = 0; v < 4; v++) {
-          for (unsigned int u = 0; u < 3; u++) {
-            hmdFloat32Array->Set(v * 4 + u, Number::New(Isolate::GetCurrent(), matrix.m[u][v]));
-          }
-        }
-        hmdFloat32Array->Set(0 * 4 + 3, Number::New(Isolate::GetCurrent(), 0));
-        hmdFloat32Array->Set(1 * 4 + 3, Number::New(Isolate::GetCurrent(), 0));
-        hmdFloat32Array->Set(2 * 4 + 3, Number::New(Isolate::GetCurrent(), 0));
-        hmdFloat32Array->Set(3 * 4 + 3, Number::New(Isolate::GetCurrent(), 1));
-      } else if (deviceClass == vr::TrackedDeviceClass_Controller) {
-        const vr::ETrackedControllerRole controllerRole = system->self_->GetControllerRoleForTrackedDeviceIndex(i);
-        if (controllerRole == vr::TrackedControllerRole_LeftHand) {
-          const vr::HmdMatrix34_t &matrix = trackedDevicePose.mDeviceToAbsoluteTracking;
-
-          for (unsigned int v = 0; v < 4; v++) {
-            for (unsigned int u = 0; u < 3; u++) {
-              leftControllerFloat32Array->Set(v * 4 + u, Number::New(Isolate::GetCurrent(), matrix.m[u][v]));
-            }
-          }
-          leftControllerFloat32Array->Set(0 * 4 + 3, Number::New(Isolate::GetCurrent(), 0));
-          leftControllerFloat32Array->Set(1 * 4 + 3, Number::New(Isolate::GetCurrent(), 0));
-          leftControllerFloat32Array->Set(2 * 4 + 3, Number::New(Isolate::GetCurrent(), 0));
-          leftControllerFloat32Array->Set(3 * 4 + 3, Number::New(Isolate::GetCurrent(), 1));
-        } else if (controllerRole == vr::TrackedControllerRole_RightHand) {
-          const vr::HmdMatrix34_t &matrix = trackedDevicePose.mDeviceToAbsoluteTracking;
-
-          for (unsigned int v = 0; v < 4; v++) {
-            for (unsigned int u = 0; u < 3; u++) {
-              rightControllerFloat32Array->Set(v * 4 + u, Number::New(Isolate::GetCurrent(), matrix.m[u][v]));
-            }
-          }
-          rightControllerFloat32Array->Set(0 * 4 + 3, Number::New(Isolate::GetCurrent(), 0));
-          rightControllerFloat32Array->Set(1 * 4 + 3, Number::New(Isolate::GetCurrent(), 0));
-          rightControllerFloat32Array->Set(2 * 4 + 3, Number::New(Isolate::GetCurrent(), 0));
-          rightControllerFloat32Array->Set(3 * 4 + 3, Number::New(Isolate::GetCurrent(), 1));
-        }
+  for (int i = 0; i < 3; i++) {
+    Local<Value> arg = info[i + 1];
+    if (!arg->IsFloat32Array() || Local<Float32Array>::Cast(arg)->Length() < POSE_MATRIX_SIZE)
+    {
+      Nan::ThrowTypeError("Expected arguments (system, Float32Array(16), Float32Array(16), Float32Array(16)).");
+      return;
+    }
+  }
+
+  if (!obj->GetPoseSource(info[0]))
+  {
+    Nan::ThrowTypeError("Argument[0] must be an `IVRSystem`.");
+    return;
+  }
+
+  for (int i = 0; i < 3; i++) {
+    Local<Float32Array> array = Local<Float32Array>::Cast(info[i + 1]);
+    obj->poseArrays_[i].Reset(array);
+    obj->poseBuffers_[i] = getPoseArrayData(array);
+  }
+}
+
+NAN_METHOD(IVRCompositor::WaitGetPoses)
+{
+  IVRCompositor* obj = ObjectWrap::Unwrap<IVRCompositor>(info.Holder());
+
+  if (info.Length() == 0)
+  {
+    if (obj->poseArrays_[0].IsEmpty())
+    {
+      Nan::ThrowError("No pose buffers registered; call SetPoseBuffers first.");
+      return;
+    }
+
+    obj->poseSource_->WaitGetPoses(obj->poseBuffers_[0], obj->poseBuffers_[1], obj->poseBuffers_[2]);
+  }
+  else if (info.Length() == 4)
+  {
+    for (int i = 1; i < 4; i++) {
+      if (!info[i]->IsFloat32Array() || Local<Float32Array>::Cast(info[i])->Length() < POSE_MATRIX_SIZE)
+      {
+        Nan::ThrowTypeError("Expected arguments (system, Float32Array(16), Float32Array(16), Float32Array(16)).");
+        return;
       }
     }
+
+    PoseSource *poseSource = obj->GetPoseSource(info[0]);
+    if (!poseSource)
+    {
+      Nan::ThrowTypeError("Argument[0] must be an `IVRSystem`.");
+      return;
+    }
+
+    poseSource->WaitGetPoses(
+      getPoseArrayData(Local<Float32Array>::Cast(info[1])),
+      getPoseArrayData(Local<Float32Array>::Cast(info[2])),
+      getPoseArrayData(Local<Float32Array>::Cast(info[3]))
+    );
+  }
+  else
+  {
+    Nan::ThrowError("Wrong number of arguments.");
+    return;
   }
 }
 
@@ -152,6 +181,12 @@ NAN_METHOD(IVRCompositor::Submit)
     return;
   }
 
+  if (!obj->self_)
+  {
+    // mock compositor; nothing to present to
+    return;
+  }
+
   WebGLRenderingContext *gl = node::ObjectWrap::Unwrap<WebGLRenderingContext>(Local<Object>::Cast(info[0]));
   GLuint texture = info[1]->Uint32Value();
 
@@ -239,3 +274,16 @@ NAN_METHOD(NewCompositor) {
   auto result = IVRCompositor::NewInstance(compositor);
   info.GetReturnValue().Set(result);
 }
+
+NAN_METHOD(NewMockCompositor) {
+  if (info.Length() > 1 || (info.Length() == 1 && !info[0]->IsNumber()))
+  {
+    Nan::ThrowError("Expected arguments ([fps]).");
+    return;
+  }
+
+  double fps = info.Length() == 1 ? info[0]->NumberValue() : 0;
+
+  auto result = IVRCompositor::NewInstance(nullptr, new MockPoseSource(fps));
+  info.GetReturnValue().Set(result);
+}
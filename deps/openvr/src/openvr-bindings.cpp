@@ -179,6 +179,7 @@ NAN_METHOD(GetContext)
 
   v8::Local<v8::Object> compositor = v8::Object::New(v8::Isolate::GetCurrent());
   compositor->Set(Nan::New("NewCompositor").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(NewCompositor)->GetFunction());
+  compositor->Set(Nan::New("NewMockCompositor").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(NewMockCompositor)->GetFunction());
   IVRCompositor::Init(compositor);
   result->Set(Nan::New("compositor").ToLocalChecked(), compositor);
   
@@ -0,0 +1,87 @@
+#include <pose-source.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <openvr.h>
+
+using TrackedDevicePoseArray = std::array<vr::TrackedDevicePose_t, vr::k_unMaxTrackedDeviceCount>;
+
+namespace {
+
+void clearPose(float *matrix) {
+  matrix[0] = std::numeric_limits<float>::quiet_NaN();
+}
+
+void setPose(float *matrix, const vr::HmdMatrix34_t &pose) {
+  for (unsigned int v = 0; v < 4; v++) {
+    for (unsigned int u = 0; u < 3; u++) {
+      matrix[v * 4 + u] = pose.m[u][v];
+    }
+  }
+  matrix[0 * 4 + 3] = 0;
+  matrix[1 * 4 + 3] = 0;
+  matrix[2 * 4 + 3] = 0;
+  matrix[3 * 4 + 3] = 1;
+}
+
+void setYawPose(float *matrix, float yaw, float x, float y, float z) {
+  const float c = std::cos(yaw);
+  const float s = std::sin(yaw);
+  const float pose[POSE_MATRIX_SIZE] = {
+    c, 0, 0.0f - s, 0, // not -s, which is -0 at yaw 0
+    0, 1, 0, 0,
+    s, 0, c, 0,
+    x, y, z, 1,
+  };
+  std::copy(pose, pose + POSE_MATRIX_SIZE, matrix);
+}
+
+}
+
+OpenVRPoseSource::OpenVRPoseSource(vr::IVRCompositor *compositor, vr::IVRSystem *system) : compositor(compositor), system(system) {}
+
+void OpenVRPoseSource::WaitGetPoses(float *hmd, float *leftController, float *rightController) {
+  TrackedDevicePoseArray trackedDevicePoseArray;
+  compositor->WaitGetPoses(trackedDevicePoseArray.data(), static_cast<uint32_t>(trackedDevicePoseArray.size()), nullptr, 0);
+
+  clearPose(hmd);
+  clearPose(leftController);
+  clearPose(rightController);
+
+  for (unsigned int i = 0; i < trackedDevicePoseArray.size(); i++) {
+    const vr::TrackedDevicePose_t &trackedDevicePose = trackedDevicePoseArray[i];
+    if (trackedDevicePose.bPoseIsValid) {
+      const vr::ETrackedDeviceClass deviceClass = system->GetTrackedDeviceClass(i);
+      if (deviceClass == vr::TrackedDeviceClass_HMD) {
+        setPose(hmd, trackedDevicePose.mDeviceToAbsoluteTracking);
+      } else if (deviceClass == vr::TrackedDeviceClass_Controller) {
+        const vr::ETrackedControllerRole controllerRole = system->GetControllerRoleForTrackedDeviceIndex(i);
+        if (controllerRole == vr::TrackedControllerRole_LeftHand) {
+          setPose(leftController, trackedDevicePose.mDeviceToAbsoluteTracking);
+        } else if (controllerRole == vr::TrackedControllerRole_RightHand) {
+          setPose(rightController, trackedDevicePose.mDeviceToAbsoluteTracking);
+        }
+      }
+    }
+  }
+}
+
+MockPoseSource::MockPoseSource(double fps) : fps(fps), frame(0), nextFrameTime(std::chrono::steady_clock::now()) {}
+
+void MockPoseSource::WaitGetPoses(float *hmd, float *leftController, float *rightController) {
+  if (fps > 0) {
+    std::this_thread::sleep_until(nextFrameTime);
+    nextFrameTime += std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / fps));
+  }
+
+  // poses depend only on the frame index so that runs are reproducible
+  const float t = static_cast<float>(frame) / 90.0f;
+  setYawPose(hmd, 0.25f * std::sin(t), 0, 1.6f, 0);
+  setYawPose(leftController, 0, -0.2f, 1.2f + 0.05f * std::sin(t), -0.3f);
+  setYawPose(rightController, 0, 0.2f, 1.2f - 0.05f * std::sin(t), -0.3f);
+
+  frame++;
+}
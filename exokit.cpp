@@ -175,6 +175,12 @@ void InitExports(Handle<Object> exports) {
   Local<Value> video = makeVideo(imageData);
   exports->Set(v8::String::NewFromUtf8(Isolate::GetCurrent(), "nativeVideo"), video);
 
+  Local<Value> trace = makeTrace();
+  exports->Set(v8::String::NewFromUtf8(Isolate::GetCurrent(), "nativeTrace"), trace);
+
+  Local<Value> memory = makeMemory();
+  exports->Set(v8::String::NewFromUtf8(Isolate::GetCurrent(), "nativeMemory"), memory);
+
   /* Local<Value> glfw = makeGlfw();
   exports->Set(v8::String::NewFromUtf8(Isolate::GetCurrent(), "nativeGlfw"), glfw); */
 
@@ -532,8 +532,13 @@ class Element extends Node {
       } else if (name === 'class' && this._classList) {
         this._classList.reset(value);
       }
+
+      // any attribute can change which selectors match this element; others only recheck tree-dependent selectors
+      this[symbols.computedStyleSymbol] = null;
+      GlobalContext.attributeEpoch++;
     });
     this.on('children', (addedNodes, removedNodes, previousSibling, nextSiblings) => {
+      GlobalContext.treeEpoch++;
       for (let i = 0; i < addedNodes.length; i++) {
         addedNodes[i].emit('attached');
       }
@@ -1170,9 +1175,6 @@ class HTMLElement extends Element {
         if (this._style) {
           this._style.reset();
         }
-        if (this[symbols.computedStyleSymbol]) {
-          this[symbols.computedStyleSymbol] = null;
-        }
       }
     });
   }
@@ -1841,6 +1843,7 @@ class HTMLIFrameElement extends HTMLSrcableElement {
                 url,
                 baseUrl: url,
                 dataPath: options.dataPath,
+                cachePath: options.cachePath,
               }, parentWindow, parentWindow.top);
               const contentDocument = GlobalContext._parseDocument(htmlString, contentWindow);
               contentDocument.hidden = this.hidden;
@@ -2030,6 +2033,32 @@ class HTMLCanvasElement extends HTMLElement {
     return this._context.toDataURL();
   }
 
+  toBlob(cb, type, quality) {
+    const {Blob} = this.ownerDocument.defaultView;
+    const _cb = (err, arrayBuffer, type) => {
+      cb(!err ? new Blob([arrayBuffer], {type}) : null);
+    };
+
+    if (!this._context) {
+      this.getContext('2d');
+    }
+    if (this._context.constructor.name === 'CanvasRenderingContext2D') {
+      this._context.toBlob(_cb, type, quality);
+    } else {
+      const gl = this._context;
+      const {width, height} = this;
+      const pixels = new Uint8Array(width * height * 4);
+      gl.readPixels(0, 0, width, height, gl.RGBA, gl.UNSIGNED_BYTE, pixels);
+      GlobalContext.CanvasRenderingContext2D.encodePixels(pixels, width, height, true, type, quality, _cb);
+    }
+  }
+
+  convertToBlob({type, quality} = {}) {
+    return new Promise(accept => {
+      this.toBlob(accept, type, quality);
+    });
+  }
+
   captureStream(frameRate) {
     return {}; // XXX
   }
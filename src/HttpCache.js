@@ -0,0 +1,408 @@
+const crypto = require('crypto');
+const fs = require('fs');
+const path = require('path');
+const mkdirp = require('mkdirp');
+const {Response} = require('window-fetch');
+
+const DEFAULT_MAX_SIZE = 512 * 1024 * 1024;
+const MAX_HEURISTIC_LIFETIME = 24 * 60 * 60 * 1000;
+const INDEX_SAVE_DELAY = 1000;
+
+const _parseCacheControl = s => {
+  const result = {};
+  if (s) {
+    const parts = s.split(',');
+    for (let i = 0; i < parts.length; i++) {
+      const match = parts[i].trim().match(/^([^=]+)(?:=\s*"?([^"]*)"?)?$/);
+      if (match) {
+        result[match[1].toLowerCase()] = match[2] !== undefined ? match[2] : true;
+      }
+    }
+  }
+  return result;
+};
+const _headersObject = headers => {
+  const result = {};
+  if (headers) {
+    if (typeof headers.forEach === 'function' && !Array.isArray(headers)) {
+      headers.forEach((value, name) => {
+        result[name.toLowerCase()] = value;
+      });
+    } else {
+      for (const k in headers) {
+        result[k.toLowerCase()] = headers[k];
+      }
+    }
+  }
+  return result;
+};
+// Bodies are stored decoded, so hop-by-hop and encoding headers no longer describe them.
+const _stripHeaders = headers => {
+  const result = Object.assign({}, headers);
+  delete result['connection'];
+  delete result['keep-alive'];
+  delete result['transfer-encoding'];
+  delete result['content-encoding'];
+  delete result['content-length'];
+  delete result['age'];
+  return result;
+};
+// Age the response already had when it reached us, in ms.
+const _getAge = headers => (parseInt(headers['age'], 10) || 0) * 1000;
+// Freshness lifetime in ms per RFC 7234: max-age, then Expires, then 10% of the Last-Modified age.
+const _getLifetime = headers => {
+  const cacheControl = _parseCacheControl(headers['cache-control']);
+  if (cacheControl['no-cache']) {
+    return 0;
+  } else if (cacheControl['max-age'] !== undefined) {
+    return (parseInt(cacheControl['max-age'], 10) || 0) * 1000;
+  } else {
+    const date = headers['date'] ? Date.parse(headers['date']) : Date.now();
+    if (headers['expires']) {
+      const expires = Date.parse(headers['expires']);
+      return !isNaN(expires) ? Math.max(expires - date, 0) : 0;
+    } else if (headers['last-modified']) {
+      const lastModified = Date.parse(headers['last-modified']);
+      return !isNaN(lastModified) ? Math.min(Math.max((date - lastModified) / 10, 0), MAX_HEURISTIC_LIFETIME) : 0;
+    } else {
+      return 0;
+    }
+  }
+};
+const _isStorable = (status, headers) => {
+  if (status !== 200) {
+    return false;
+  }
+  const cacheControl = _parseCacheControl(headers['cache-control']);
+  if (cacheControl['no-store']) {
+    return false;
+  }
+  const vary = headers['vary'];
+  if (vary && vary.split(',').some(v => v.trim().toLowerCase() !== 'accept-encoding')) {
+    return false;
+  }
+  return _getLifetime(headers) > 0 || !!headers['etag'] || !!headers['last-modified'];
+};
+
+// Persistent, content-addressed HTTP cache shared by fetch, XHR and subresource loads.
+// Bodies are stored under their SHA-256 so identical resources share one file; index.json maps URLs to
+// response metadata and is evicted least-recently-used first once the bodies exceed maxSize.
+class HttpCache {
+  constructor(dir, {maxSize = DEFAULT_MAX_SIZE} = {}) {
+    this.dir = dir;
+    this.maxSize = maxSize;
+    this.entries = new Map();
+    this.bodies = new Map(); // hash -> {size, refs}
+    this.writes = new Map(); // hash -> promise of the body file landing
+    this.writeId = 0;
+    this.size = 0;
+    this.saveTimeout = null;
+    this.dirty = false;
+
+    mkdirp.sync(dir);
+    try {
+      const index = JSON.parse(fs.readFileSync(path.join(dir, 'index.json'), 'utf8'));
+      for (const url in index) {
+        const entry = index[url];
+        if (fs.existsSync(path.join(dir, entry.hash))) {
+          this.entries.set(url, entry);
+          this._ref(entry);
+        }
+      }
+    } catch (err) {
+      // no index yet, or a corrupt one; start empty
+    }
+
+    this.onexit = () => {
+      if (this.dirty) {
+        this._saveSync();
+      }
+    };
+    process.on('exit', this.onexit);
+  }
+
+  static get(dir, opts) {
+    let cache = caches.get(dir);
+    if (!cache) {
+      cache = new HttpCache(dir, opts);
+      caches.set(dir, cache);
+    }
+    return cache;
+  }
+
+  // Like fetch(), but answers from disk when fresh and revalidates with If-None-Match/If-Modified-Since when stale.
+  fetch(url, options = {}, fetchFn) {
+    return this._load(url, options, fetchFn)
+      .then(result => result.res || new Response(result.body, {
+        url,
+        status: result.status,
+        statusText: result.statusText,
+        headers: result.headers,
+      }));
+  }
+
+  // Same as fetch() but resolves {status, statusText, headers, body} for the XHR path. body is a Buffer when the
+  // response came from or went into the cache, and the still-streaming response body otherwise.
+  request(url, options = {}, fetchFn) {
+    return this._load(url, options, fetchFn)
+      .then(result => {
+        if (result.res) {
+          const {res} = result;
+          const headers = _headersObject(res.headers);
+          if (headers['content-encoding']) {
+            // the body stream is already decoded
+            delete headers['content-encoding'];
+            delete headers['content-length'];
+          }
+          return {
+            status: res.status,
+            statusText: res.statusText,
+            headers,
+            body: res.body,
+          };
+        } else {
+          return result;
+        }
+      });
+  }
+
+  _load(url, options, fetchFn) {
+    const method = (options.method || 'GET').toUpperCase();
+    if (method !== 'GET' || options.body || options.cache === 'no-store' || !/^https?:/.test(url)) {
+      return fetchFn(url, options).then(res => ({res}));
+    }
+
+    const entry = options.cache !== 'reload' ? this.entries.get(url) : undefined;
+    if (entry && options.cache !== 'no-cache' && Date.now() - entry.storedAt + (entry.age || 0) < entry.lifetime) {
+      return this._read(url, entry)
+        .catch(() => this._load(url, Object.assign({}, options, {cache: 'reload'}), fetchFn));
+    }
+
+    const headers = _headersObject(options.headers);
+    if (entry) {
+      if (entry.headers['etag']) {
+        headers['if-none-match'] = entry.headers['etag'];
+      }
+      if (entry.headers['last-modified']) {
+        headers['if-modified-since'] = entry.headers['last-modified'];
+      }
+    }
+    return fetchFn(url, Object.assign({}, options, {headers}))
+      .then(res => {
+        const resHeaders = _headersObject(res.headers);
+        if (res.status === 304 && entry) {
+          entry.headers = Object.assign({}, entry.headers, _stripHeaders(resHeaders));
+          entry.storedAt = Date.now();
+          entry.age = _getAge(resHeaders);
+          entry.lifetime = _getLifetime(entry.headers);
+          this._scheduleSave();
+          return this._read(url, entry)
+            .then(result => {
+              if (!_isStorable(entry.status, entry.headers)) {
+                this._removeEntry(url, entry);
+              }
+              return result;
+            }, () => this._load(url, Object.assign({}, options, {cache: 'reload'}), fetchFn));
+        } else if (_isStorable(res.status, resHeaders)) {
+          return res.arrayBuffer()
+            .then(arrayBuffer => {
+              const body = Buffer.from(arrayBuffer);
+              return this._store(url, res.status, res.statusText, resHeaders, body)
+                .then(entry => ({
+                  status: entry.status,
+                  statusText: entry.statusText,
+                  headers: entry.headers,
+                  body,
+                }));
+            });
+        } else {
+          if (entry) {
+            // the resource stopped being cacheable; do not keep serving or revalidating the old copy
+            this._removeEntry(url, entry);
+          }
+          return {res};
+        }
+      });
+  }
+
+  _read(url, entry) {
+    return new Promise((accept, reject) => {
+      fs.readFile(path.join(this.dir, entry.hash), (err, body) => {
+        if (!err) {
+          entry.lastAccess = Date.now();
+          this._scheduleSave();
+          accept({
+            status: entry.status,
+            statusText: entry.statusText,
+            headers: entry.headers,
+            body,
+          });
+        } else if (err.code === 'ENOENT' && this.writes.has(entry.hash)) {
+          // the same body is being rewritten for another url; it is not corrupt, just not renamed into place yet
+          this.writes.get(entry.hash)
+            .then(() => this._read(url, entry))
+            .then(accept, reject);
+        } else {
+          this._removeEntry(url, entry);
+          reject(err);
+        }
+      });
+    });
+  }
+
+  // Resolves the entry once its body file is in place; only then is it published to the index.
+  _store(url, status, statusText, headers, body) {
+    const age = _getAge(headers);
+    headers = _stripHeaders(headers);
+    headers['content-length'] = body.length + '';
+
+    const hash = crypto.createHash('sha256').update(body).digest('hex');
+    const now = Date.now();
+    const entry = {
+      hash,
+      size: body.length,
+      status,
+      statusText,
+      headers,
+      storedAt: now,
+      age,
+      lifetime: _getLifetime(headers),
+      lastAccess: now,
+    };
+
+    return this._writeBody(hash, body)
+      .then(() => {
+        const oldEntry = this.entries.get(url);
+        this.entries.set(url, entry);
+        this._ref(entry);
+        if (oldEntry) {
+          this._unref(oldEntry);
+        }
+        this._evict();
+        this._scheduleSave();
+        return entry;
+      }, err => {
+        console.warn('http cache write failed', err);
+        return entry;
+      });
+  }
+
+  _writeBody(hash, body) {
+    if (this.bodies.has(hash)) {
+      return Promise.resolve();
+    }
+    let write = this.writes.get(hash);
+    if (!write) {
+      const bodyPath = path.join(this.dir, hash);
+      const tmpPath = bodyPath + '.' + process.pid + '.' + (++this.writeId) + '.tmp';
+      write = new Promise((accept, reject) => {
+        fs.writeFile(tmpPath, body, err => {
+          if (!err) {
+            fs.rename(tmpPath, bodyPath, err => {
+              if (!err) {
+                accept();
+              } else {
+                fs.unlink(tmpPath, () => {});
+                reject(err);
+              }
+            });
+          } else {
+            fs.unlink(tmpPath, () => {});
+            reject(err);
+          }
+        });
+      });
+      const _done = () => {
+        this.writes.delete(hash);
+      };
+      write.then(_done, _done);
+      this.writes.set(hash, write);
+    }
+    return write;
+  }
+
+  _ref(entry) {
+    const body = this.bodies.get(entry.hash);
+    if (body) {
+      body.refs++;
+    } else {
+      this.bodies.set(entry.hash, {size: entry.size, refs: 1});
+      this.size += entry.size;
+    }
+  }
+
+  _unref(entry) {
+    const body = this.bodies.get(entry.hash);
+    if (--body.refs === 0) {
+      this.bodies.delete(entry.hash);
+      this.size -= body.size;
+      fs.unlink(path.join(this.dir, entry.hash), () => {});
+    }
+  }
+
+  _remove(url) {
+    const entry = this.entries.get(url);
+    if (entry) {
+      this.entries.delete(url);
+      this._unref(entry);
+      this._scheduleSave();
+    }
+  }
+
+  // Removes url only while entry is still what it maps to, so a newer store is not dropped.
+  _removeEntry(url, entry) {
+    if (this.entries.get(url) === entry) {
+      this._remove(url);
+    }
+  }
+
+  _evict() {
+    if (this.size > this.maxSize) {
+      const urls = Array.from(this.entries.keys())
+        .sort((a, b) => this.entries.get(a).lastAccess - this.entries.get(b).lastAccess);
+      for (let i = 0; i < urls.length && this.size > this.maxSize; i++) {
+        this._remove(urls[i]);
+      }
+    }
+  }
+
+  _serialize() {
+    const index = {};
+    this.entries.forEach((entry, url) => {
+      index[url] = entry;
+    });
+    return JSON.stringify(index);
+  }
+
+  _scheduleSave() {
+    this.dirty = true;
+    if (!this.saveTimeout) {
+      this.saveTimeout = setTimeout(() => {
+        this.saveTimeout = null;
+        this.dirty = false;
+        const indexPath = path.join(this.dir, 'index.json');
+        const tmpPath = indexPath + '.' + process.pid + '.tmp';
+        fs.writeFile(tmpPath, this._serialize(), err => {
+          if (!err) {
+            fs.rename(tmpPath, indexPath, () => {});
+          }
+        });
+      }, INDEX_SAVE_DELAY);
+      this.saveTimeout.unref();
+    }
+  }
+
+  _saveSync() {
+    this.dirty = false;
+    fs.writeFileSync(path.join(this.dir, 'index.json'), this._serialize());
+  }
+
+  clear() {
+    Array.from(this.entries.keys()).forEach(url => {
+      this._remove(url);
+    });
+    this._saveSync();
+  }
+}
+const caches = new Map();
+module.exports.HttpCache = HttpCache;
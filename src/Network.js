@@ -1,53 +1,182 @@
+const EventEmitter = require('events');
 const fs = require('fs');
 const stream = require('stream');
+const fetch = require('window-fetch');
 const {XMLHttpRequest: XMLHttpRequestBase} = require('window-xhr');
 const XHRUtils = require('window-xhr/lib/utils');
 
 const {urls} = require('./urls');
 
+const _makeResponse = (statusCode, headers, body) => {
+  const response = new stream.PassThrough();
+  response.statusCode = statusCode;
+  response.headers = headers;
+  response.end(body);
+  return response;
+};
+
+// Reads a whole file straight into one exactly-sized ArrayBuffer, without intermediate chunks.
+// The size comes from the opened descriptor, so symlinks are followed and the buffer matches what was read.
+const readFileArrayBuffer = p => new Promise((accept, reject) => {
+  fs.open(p, 'r', (err, fd) => {
+    if (!err) {
+      let arrayBuffer = null;
+      const _close = err => {
+        fs.close(fd, () => {
+          if (!err) {
+            accept(arrayBuffer);
+          } else {
+            reject(err);
+          }
+        });
+      };
+      fs.fstat(fd, (err, stats) => {
+        if (!err) {
+          const {size} = stats;
+          arrayBuffer = new ArrayBuffer(size);
+          const buffer = Buffer.from(arrayBuffer);
+          const _recurse = offset => {
+            if (offset < size) {
+              fs.read(fd, buffer, offset, size - offset, offset, (err, bytesRead) => {
+                if (!err) {
+                  if (bytesRead > 0) {
+                    _recurse(offset + bytesRead);
+                  } else {
+                    _close(new Error('file truncated while reading: ' + p));
+                  }
+                } else {
+                  _close(err);
+                }
+              });
+            } else {
+              _close(null);
+            }
+          };
+          _recurse(0);
+        } else {
+          _close(err);
+        }
+      });
+    } else {
+      reject(err);
+    }
+  });
+});
+module.exports.readFileArrayBuffer = readFileArrayBuffer;
+
+// Hands out the ArrayBuffer behind a blob. Only blobs whose Buffer is a view into a shared pool are copied, once.
+const blobArrayBuffers = new WeakMap();
+const blobArrayBuffer = blob => {
+  let arrayBuffer = blobArrayBuffers.get(blob);
+  if (!arrayBuffer) {
+    const {buffer} = blob;
+    if (buffer.byteOffset === 0 && buffer.byteLength === buffer.buffer.byteLength) {
+      arrayBuffer = buffer.buffer;
+    } else {
+      arrayBuffer = buffer.buffer.slice(buffer.byteOffset, buffer.byteOffset + buffer.byteLength);
+    }
+    blobArrayBuffers.set(blob, arrayBuffer);
+  }
+  return arrayBuffer;
+};
+module.exports.blobArrayBuffer = blobArrayBuffer;
+
 const XMLHttpRequest = (Old => class XMLHttpRequest extends Old {
   open(method, url, async, username, password) {
+    this._arrayBuffer = null;
+    this._requestHeaders = {};
+
     const blob = urls.get(url);
-    if (blob) {
+    if (this._httpCache && /^get$/i.test(method) && /^https?:/.test(url)) {
+      this._properties._responseFn = (cb, errorCb) => {
+        this._httpCache.request(url, {headers: this._requestHeaders}, fetch)
+          .then(({status, statusText, headers, body}) => {
+            let response;
+            if (body && typeof body.pipe === 'function') {
+              // uncacheable responses keep streaming, so progress events and memory use are unchanged
+              response = new stream.PassThrough();
+              response.statusCode = status;
+              response.headers = headers;
+              body.on('error', err => {
+                response.emit('error', err);
+              });
+              body.pipe(response);
+            } else {
+              response = _makeResponse(status, headers, body);
+            }
+            response.statusMessage = statusText;
+            cb(response);
+          })
+          .catch(errorCb);
+      };
+    } else if (blob) {
       this._properties._responseFn = cb => {
         process.nextTick(() => {
           const {buffer} = blob;
-          const response = new stream.PassThrough();
-          response.statusCode = 200;
-          response.headers = {
+          const headers = {
             'content-length': buffer.length + '',
           };
-          response.end(buffer);
-          cb(response);
+          if (blob.type) {
+            headers['content-type'] = blob.type;
+          }
+          if (this.responseType === 'arraybuffer') {
+            this._arrayBuffer = blobArrayBuffer(blob);
+            cb(_makeResponse(200, headers));
+          } else {
+            cb(_makeResponse(200, headers, buffer));
+          }
         });
       };
     } else {
       const match = url.match(/^file:\/\/(.*)$/);
       if (match) {
         const p = match[1];
-        this._properties._responseFn = cb => {
-          fs.lstat(p, (err, stats) => {
-            if (!err) {
-              const response = fs.createReadStream(p);
-              response.statusCode = 200;
-              response.headers = {
-                'content-length': stats.size + '',
-              };
-              cb(response);
-            } else if (err.code === 'ENOENT') {
-              const response = new stream.PassThrough();
-              response.statusCode = 404;
-              response.headers = {};
-              response.end('file not found: ' + p);
-              cb(response);
+        this._properties._responseFn = (cb, errorCb) => {
+          const _error = err => {
+            if (err.code === 'ENOENT') {
+              cb(_makeResponse(404, {}, 'file not found: ' + p));
             } else {
-              const response = new stream.PassThrough();
-              response.statusCode = 500;
-              response.headers = {};
-              response.end(err.stack);
-              cb(response);
+              errorCb(err);
             }
-          });
+          };
+
+          if (this.responseType === 'arraybuffer') {
+            readFileArrayBuffer(p)
+              .then(arrayBuffer => {
+                this._arrayBuffer = arrayBuffer;
+                cb(_makeResponse(200, {
+                  'content-length': arrayBuffer.byteLength + '',
+                }));
+              })
+              .catch(_error);
+          } else {
+            fs.open(p, 'r', (err, fd) => {
+              if (!err) {
+                fs.fstat(fd, (err, stats) => {
+                  if (!err) {
+                    const headers = {
+                      'content-length': stats.size + '',
+                    };
+                    if (stats.size > 0) {
+                      // bounded to the advertised length so progress totals hold even if the file grows
+                      const response = fs.createReadStream(null, {fd, start: 0, end: stats.size - 1});
+                      response.statusCode = 200;
+                      response.headers = headers;
+                      cb(response);
+                    } else {
+                      fs.close(fd, () => {});
+                      cb(_makeResponse(200, headers));
+                    }
+                  } else {
+                    fs.close(fd, () => {});
+                    _error(err);
+                  }
+                });
+              } else {
+                _error(err);
+              }
+            });
+          }
         };
         arguments[1] = 'http://127.0.0.1/'; // needed to pass protocol check, will not be fetched
       }
@@ -55,6 +184,20 @@ const XMLHttpRequest = (Old => class XMLHttpRequest extends Old {
 
     return Old.prototype.open.apply(this, arguments);
   }
+
+  setRequestHeader(name, value) {
+    this._requestHeaders[name] = value;
+    return super.setRequestHeader(name, value);
+  }
+
+  get response() {
+    // file:// and blob: array buffer loads bypass the base class body buffering entirely
+    if (this._arrayBuffer && this.responseType === 'arraybuffer' && this.readyState === 4) {
+      return this._arrayBuffer;
+    } else {
+      return super.response;
+    }
+  }
 })(XMLHttpRequestBase);
 module.exports.XMLHttpRequest = XMLHttpRequest;
 
@@ -62,12 +205,15 @@ XHRUtils.createClient = (createClient => function() {
   const properties = arguments[0];
   if (properties._responseFn) {
     const cb = arguments[2];
-    properties._responseFn(cb);
-    return {
-      on() {},
-      setHeader() {}, write() {},
-      end() {},
-    };
+    // network failures surface as client errors, the same as on the uncached path
+    const client = new EventEmitter();
+    client.setHeader = () => {};
+    client.write = () => {};
+    client.end = () => {};
+    properties._responseFn(cb, err => {
+      client.emit('error', err);
+    });
+    return client;
   } else {
     return createClient.apply(this, arguments);
   }
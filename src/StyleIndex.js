@@ -0,0 +1,171 @@
+const GlobalContext = require('./GlobalContext');
+
+const EMPTY_ARRAY = [];
+
+// Splits off the rightmost compound selector, e.g. 'div.a > span#b:hover' -> 'span#b:hover'.
+// Brackets and parentheses are skipped so ':not(.a b)' and '[title="a b"]' stay whole.
+const _parseSelector = s => {
+  s = s.trim();
+  let depth = 0;
+  let quote = null;
+  let start = 0;
+  for (let i = 0; i < s.length; i++) {
+    const c = s[i];
+    if (quote) {
+      if (c === quote) {
+        quote = null;
+      }
+    } else if (c === '"' || c === '\'') {
+      quote = c;
+    } else if (c === '(' || c === '[') {
+      depth++;
+    } else if (c === ')' || c === ']') {
+      depth--;
+    } else if (depth === 0 && (c === ' ' || c === '>' || c === '+' || c === '~')) {
+      start = i + 1;
+    }
+  }
+  const compound = s.slice(start);
+  return {
+    compound,
+    // combinators and pseudo-classes look at other elements, so matches can change without this element changing
+    treeDependent: start > 0 || /:/.test(compound.replace(/\[[^\]]*\]|\([^)]*\)/g, '')),
+  };
+};
+const _bucketKey = compound => {
+  const bare = compound.replace(/\[[^\]]*\]|\([^)]*\)/g, '');
+  let match;
+  if (match = bare.match(/#(-?[_a-zA-Z0-9\u00A0-\uFFFF-]+)/)) {
+    return {type: 'id', key: match[1]};
+  } else if (match = bare.match(/\.(-?[_a-zA-Z0-9\u00A0-\uFFFF-]+)/)) {
+    return {type: 'class', key: match[1]};
+  } else if (match = bare.match(/^([a-zA-Z][a-zA-Z0-9-]*)/)) {
+    return {type: 'tag', key: match[1].toUpperCase()};
+  } else {
+    return {type: 'universal', key: null};
+  }
+};
+
+// Rules from all document stylesheets, bucketed by the id, class or tag of each selector's rightmost compound,
+// so an element is only tested against selectors that could possibly match it.
+class StyleIndex {
+  constructor() {
+    this.stylesheetEls = [];
+    this.stylesheets = [];
+    this.styleEpoch = -1;
+    this.treeEpoch = -1;
+    this.generation = 0;
+
+    this.ids = new Map();
+    this.classes = new Map();
+    this.tags = new Map();
+    this.universal = [];
+  }
+
+  update(document) {
+    if (this.styleEpoch !== GlobalContext.styleEpoch || this.treeEpoch !== GlobalContext.treeEpoch) {
+      const stylesheetEls = document.documentElement.getElementsByTagName('style')
+        .concat(document.documentElement.getElementsByTagName('link'));
+      const stylesheets = stylesheetEls.map(stylesheetEl => stylesheetEl.stylesheet);
+      if (
+        this.styleEpoch !== GlobalContext.styleEpoch ||
+        stylesheetEls.length !== this.stylesheetEls.length ||
+        stylesheetEls.some((stylesheetEl, i) => stylesheetEl !== this.stylesheetEls[i] || stylesheets[i] !== this.stylesheets[i])
+      ) {
+        this.build(stylesheets);
+      }
+      this.stylesheetEls = stylesheetEls;
+      this.stylesheets = stylesheets;
+      this.styleEpoch = GlobalContext.styleEpoch;
+      this.treeEpoch = GlobalContext.treeEpoch;
+    }
+  }
+
+  build(stylesheets) {
+    this.ids.clear();
+    this.classes.clear();
+    this.tags.clear();
+    this.universal = [];
+    this.generation++;
+
+    let order = 0;
+    for (let i = 0; i < stylesheets.length; i++) {
+      const stylesheet = stylesheets[i];
+      if (stylesheet) {
+        const {rules} = stylesheet;
+        for (let j = 0; j < rules.length; j++) {
+          const rule = rules[j];
+          const {selectors} = rule;
+          if (selectors) {
+            for (let k = 0; k < selectors.length; k++) {
+              const selector = selectors[k];
+              const {compound, treeDependent} = _parseSelector(selector);
+              const {type, key} = _bucketKey(compound);
+              const entry = {selector, rule, order, treeDependent};
+              if (type === 'universal') {
+                this.universal.push(entry);
+              } else {
+                const bucket = type === 'id' ? this.ids : (type === 'class' ? this.classes : this.tags);
+                let entries = bucket.get(key);
+                if (!entries) {
+                  entries = [];
+                  bucket.set(key, entries);
+                }
+                entries.push(entry);
+              }
+            }
+          }
+          order++;
+        }
+      }
+    }
+  }
+
+  candidates(el) {
+    const result = this.universal.slice();
+    const _add = entries => {
+      if (entries) {
+        for (let i = 0; i < entries.length; i++) {
+          result.push(entries[i]);
+        }
+      }
+    };
+    _add(this.tags.get(el.tagName.toUpperCase()));
+    const id = el.getAttribute('id');
+    if (id) {
+      _add(this.ids.get(id));
+    }
+    const className = el.getAttribute('class');
+    if (className) {
+      const classNames = className.split(/\s+/);
+      for (let i = 0; i < classNames.length; i++) {
+        if (classNames[i]) {
+          _add(this.classes.get(classNames[i]));
+        }
+      }
+    }
+    return result;
+  }
+
+  // Returns the rules matching el in stylesheet order, and whether that answer depends on the rest of the tree.
+  match(el) {
+    const candidates = this.candidates(el);
+    let treeDependent = false;
+    const matched = [];
+    const seen = new Set();
+    for (let i = 0; i < candidates.length; i++) {
+      const entry = candidates[i];
+      treeDependent = treeDependent || entry.treeDependent;
+      if (!seen.has(entry.rule) && el.matches(entry.selector)) {
+        seen.add(entry.rule);
+        matched.push(entry);
+      }
+    }
+    matched.sort((a, b) => a.order - b.order);
+    return {
+      rules: matched.length > 0 ? matched.map(entry => entry.rule) : EMPTY_ARRAY,
+      treeDependent,
+    };
+  }
+}
+module.exports.StyleIndex = StyleIndex;
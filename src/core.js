@@ -52,8 +52,10 @@ const DOM = require('./DOM');
 const {DOMRect, Node, NodeList} = require('./DOM');
 const {CustomEvent, DragEvent, ErrorEvent, Event, EventTarget, KeyboardEvent, MessageEvent, MouseEvent, WheelEvent, PromiseRejectionEvent} = require('./Event');
 const {History} = require('./History');
+const {HttpCache} = require('./HttpCache');
 const {Location} = require('./Location');
-const {XMLHttpRequest} = require('./Network');
+const {StyleIndex} = require('./StyleIndex');
+const {XMLHttpRequest, readFileArrayBuffer, blobArrayBuffer} = require('./Network');
 const XR = require('./XR');
 const utils = require('./utils');
 const {_elementGetter, _elementSetter} = require('./utils');
@@ -79,6 +81,8 @@ const parseJson = s => {
 };
 
 GlobalContext.styleEpoch = 0;
+GlobalContext.treeEpoch = 0;
+GlobalContext.attributeEpoch = 0;
 
 class Resource extends EventEmitter {
   constructor(value = 0.5, total = 1) {
@@ -748,6 +752,7 @@ const _cloneMrDisplays = (mrDisplays, window) => {
 
 const _makeWindow = (options = {}, parent = null, top = null) => {
   const _normalizeUrl = utils._makeNormalizeUrl(options.baseUrl);
+  const httpCache = options.cachePath ? HttpCache.get(options.cachePath) : null;
 
   const HTMLImageElementBound = (Old => class HTMLImageElement extends Old {
     constructor() {
@@ -969,10 +974,7 @@ const _makeWindow = (options = {}, parent = null, top = null) => {
     }
   };
   window.fetch = (url, options) => {
-    const _boundFetch = (url, options) => utils._normalizePrototype(
-      fetch(url, options),
-      window
-    )
+    const _normalizeResponse = p => utils._normalizePrototype(p, window)
       .then(res => {
         res.arrayBuffer = (fn => function() {
           return utils._normalizePrototype(
@@ -1010,15 +1012,47 @@ const _makeWindow = (options = {}, parent = null, top = null) => {
 
         return res;
       });
+    const _boundFetch = (url, options) => _normalizeResponse(
+      httpCache ? httpCache.fetch(url, options, fetch) : fetch(url, options)
+    );
+
+    // file:// and blob: bodies are already whole in memory, so arrayBuffer() returns that buffer directly
+    const _arrayBufferResponse = (arrayBuffer, type) => {
+      const headers = {
+        'Content-Length': arrayBuffer.byteLength + '',
+      };
+      if (type) {
+        headers['Content-Type'] = type;
+      }
+      const res = new Response(Buffer.from(arrayBuffer), {headers});
+      res.arrayBuffer = () => Promise.resolve(arrayBuffer);
+      return res;
+    };
 
     if (typeof url === 'string') {
       const blob = urls.get(url);
       if (blob) {
-        return Promise.resolve(new Response(blob));
+        return _normalizeResponse(Promise.resolve(_arrayBufferResponse(blobArrayBuffer(blob), blob.type)));
       } else {
         const oldUrl = url;
         url = _normalizeUrl(url);
-        return _boundFetch(url, options);
+
+        const match = url.match(/^file:\/\/(.*)$/);
+        if (match) {
+          const p = match[1];
+          return _normalizeResponse(
+            readFileArrayBuffer(p)
+              .then(arrayBuffer => _arrayBufferResponse(arrayBuffer), err => {
+                if (err.code === 'ENOENT') {
+                  return new Response('file not found: ' + p, {status: 404});
+                } else {
+                  return Promise.reject(err);
+                }
+              })
+          );
+        } else {
+          return _boundFetch(url, options);
+        }
       }
     } else {
       return _boundFetch(url, options);
@@ -1041,6 +1075,7 @@ const _makeWindow = (options = {}, parent = null, top = null) => {
     class XMLHttpRequest extends Old {
       open(method, url, async, username, password) {
         url = _normalizeUrl(url);
+        this._httpCache = httpCache;
         return super.open(method, url, async, username, password);
       }
       get response() {
@@ -1123,31 +1158,35 @@ const _makeWindow = (options = {}, parent = null, top = null) => {
   window.MutationObserver = require('./MutationObserver').MutationObserver;
   window.DOMRect = DOMRect;
   window.getComputedStyle = el => {
+    const document = el.ownerDocument;
+    let styleIndex = document[symbols.styleIndexSymbol];
+    if (!styleIndex) {
+      styleIndex = new StyleIndex();
+      document[symbols.styleIndexSymbol] = styleIndex;
+    }
+    styleIndex.update(document);
+
     let styleSpec = el[symbols.computedStyleSymbol];
-    if (!styleSpec || styleSpec.epoch !== GlobalContext.styleEpoch) {
+    if (
+      !styleSpec ||
+      styleSpec.generation !== styleIndex.generation ||
+      (styleSpec.treeDependent && (styleSpec.treeEpoch !== GlobalContext.treeEpoch || styleSpec.attributeEpoch !== GlobalContext.attributeEpoch))
+    ) {
       const style = el.style.clone();
-      const stylesheetEls = el.ownerDocument.documentElement.getElementsByTagName('style')
-        .concat(el.ownerDocument.documentElement.getElementsByTagName('link'));
-      for (let i = 0; i < stylesheetEls.length; i++) {
-        const {stylesheet} = stylesheetEls[i];
-        if (stylesheet) {
-          const {rules} = stylesheet;
-          for (let j = 0; j < rules.length; j++) {
-            const rule = rules[j];
-            const {selectors} = rule;
-            if (selectors && selectors.some(selector => el.matches(selector))) {
-              const {declarations} = rule;
-              for (let k = 0; k < declarations.length; k++) {
-                const {property, value} = declarations[k];
-                style[property] = value;
-              }
-            }
-          }
+      const {rules, treeDependent} = styleIndex.match(el);
+      for (let i = 0; i < rules.length; i++) {
+        const {declarations} = rules[i];
+        for (let j = 0; j < declarations.length; j++) {
+          const {property, value} = declarations[j];
+          style[property] = value;
         }
       }
       styleSpec = {
         style,
-        styleEpoch: GlobalContext.styleEpoch,
+        generation: styleIndex.generation,
+        treeDependent,
+        treeEpoch: GlobalContext.treeEpoch,
+        attributeEpoch: GlobalContext.attributeEpoch,
       };
       el[symbols.computedStyleSymbol] = styleSpec;
     }
@@ -1530,6 +1569,7 @@ const _makeWindow = (options = {}, parent = null, top = null) => {
     if (!loading) {
       exokit.load(href, {
         dataPath: options.dataPath,
+        cachePath: options.cachePath,
       })
         .then(newWindow => {
           window._emit('beforeunload');
@@ -1761,6 +1801,7 @@ exokit.load = (src, options = {}) => {
         url: options.url || src,
         baseUrl,
         dataPath: options.dataPath,
+        cachePath: options.cachePath,
       });
     });
 };
@@ -17,14 +17,13 @@ const core = require('./core.js');
 const mkdirp = require('mkdirp');
 const replHistory = require('repl.history');
 const minimist = require('minimist');
-const UPNG = require('upng-js');
 
 const {version} = require('../package.json');
 const nativeBindingsModulePath = path.join(__dirname, 'native-bindings.js');
 const symbols = require('./symbols');
 const {THREE} = core;
 const nativeBindings = require(nativeBindingsModulePath);
-const {nativeVideo, nativeVr, nativeLm, nativeMl, nativeWindow, nativeAnalytics} = nativeBindings;
+const {nativeVideo, nativeVr, nativeLm, nativeMl, nativeWindow, nativeAnalytics, nativeTrace} = nativeBindings;
 
 const GlobalContext = require('./GlobalContext');
 GlobalContext.commands = [];
@@ -78,6 +77,8 @@ const args = (() => {
         'blit',
         'uncapped',
         'require',
+        'eventRing',
+        'noCache',
       ],
       string: [
         'tab',
@@ -85,6 +86,7 @@ const args = (() => {
         'xr',
         'size',
         'image',
+        'trace',
       ],
       alias: {
         v: 'version',
@@ -122,6 +124,9 @@ const args = (() => {
       uncapped: minimistArgs.uncapped,
       image: minimistArgs.image,
       require: minimistArgs.require,
+      eventRing: minimistArgs.eventRing,
+      noCache: minimistArgs.noCache,
+      trace: minimistArgs.trace ? path.resolve(cwd, minimistArgs.trace) : null,
     };
   } else {
     return {};
@@ -267,6 +272,10 @@ nativeBindings.nativeGl.onconstruct = (gl, canvas) => {
     contexts.push(gl);
     fps = nativeWindow.getRefreshRate();
 
+    if (args.performance) {
+      gl.setGpuTimersEnabled(true);
+    }
+
     canvas.ownerDocument.defaultView.on('unload', () => {
       gl.destroy();
     });
@@ -350,6 +359,12 @@ if (nativeVr) {
         const vrContext = vrPresentState.vrContext || nativeVr.getContext();
         const system = vrPresentState.system || nativeVr.VR_Init(nativeVr.EVRApplicationType.Scene);
         const compositor = vrPresentState.compositor || vrContext.compositor.NewCompositor();
+        compositor.SetPoseBuffers(
+          system,
+          localFloat32Array, // hmd
+          localFloat32Array2, // left controller
+          localFloat32Array3 // right controller
+        );
 
         const lmContext = vrPresentState.lmContext || (nativeLm && new nativeLm());
 
@@ -694,7 +709,7 @@ const fakePresentState = {
 };
 GlobalContext.fakePresentState = fakePresentState;
 
-nativeWindow.setEventHandler((type, data) => {
+const _handleWindowEvent = (type, data) => {
   const {windowHandle} = data;
   const context = contexts.find(context => _windowHandleEquals(context.getWindowHandle(), windowHandle));
   const {canvas} = context;
@@ -836,7 +851,66 @@ nativeWindow.setEventHandler((type, data) => {
   } else {
     console.warn('got native window event with no matching context', {type, data});
   }
-});
+};
+nativeWindow.setEventHandler(_handleWindowEvent);
+
+// With --eventRing, key/mouse/wheel input is written by native callbacks into a shared Float64Array
+// of fixed-size records (see glfw.cc) and decoded here once per frame, instead of one object per callback.
+const EVENT_RING_HEADER_SIZE = 2;
+const EVENT_RING_RECORD_SIZE = 8;
+const EVENT_RING_CAPACITY = 1024;
+const EVENT_RING_TYPES = [null, 'keyup', 'keydown', 'keypress', 'mousemove', 'mousedown', 'mouseup', 'click', 'wheel'];
+const GLFW_MOD_SHIFT = 0x1;
+const GLFW_MOD_CONTROL = 0x2;
+const GLFW_MOD_ALT = 0x4;
+const GLFW_MOD_SUPER = 0x8;
+const eventRing = (args.eventRing && nativeWindow.setEventRing) ? new Float64Array(EVENT_RING_HEADER_SIZE + EVENT_RING_CAPACITY * EVENT_RING_RECORD_SIZE) : null;
+if (eventRing) {
+  // a full ring is drained synchronously before the next record is written, so input stays in order
+  nativeWindow.setEventRing(eventRing, () => _decodeEventRing());
+}
+const _decodeEventRing = () => {
+  const writeIndex = eventRing[0];
+  let readIndex = eventRing[1];
+  for (; readIndex < writeIndex; readIndex++) {
+    const offset = EVENT_RING_HEADER_SIZE + (readIndex % EVENT_RING_CAPACITY) * EVENT_RING_RECORD_SIZE;
+    const type = EVENT_RING_TYPES[eventRing[offset]];
+    const windowHandle = [eventRing[offset + 1], eventRing[offset + 2]];
+    const a = eventRing[offset + 3];
+    const b = eventRing[offset + 4];
+    const c = eventRing[offset + 5];
+    const d = eventRing[offset + 6];
+    const mods = eventRing[offset + 7];
+    const shiftKey = !!(mods & GLFW_MOD_SHIFT);
+    const ctrlKey = !!(mods & GLFW_MOD_CONTROL);
+    const altKey = !!(mods & GLFW_MOD_ALT);
+    const metaKey = !!(mods & GLFW_MOD_SUPER);
+
+    switch (type) {
+      case 'keyup':
+      case 'keydown':
+      case 'keypress': {
+        _handleWindowEvent(type, {type, ctrlKey, shiftKey, altKey, metaKey, which: a, keyCode: a, charCode: b, windowHandle});
+        break;
+      }
+      case 'mousemove': {
+        _handleWindowEvent(type, {type, clientX: a, clientY: b, pageX: a, pageY: b, offsetX: a, offsetY: b, movementX: c, movementY: d, ctrlKey, shiftKey, altKey, metaKey, windowHandle});
+        break;
+      }
+      case 'mousedown':
+      case 'mouseup':
+      case 'click': {
+        _handleWindowEvent(type, {type, button: a, which: a, clientX: b, clientY: c, pageX: b, pageY: c, offsetX: b, offsetY: c, shiftKey, ctrlKey, altKey, metaKey, windowHandle});
+        break;
+      }
+      case 'wheel': {
+        _handleWindowEvent(type, {type, deltaX: a, deltaY: b, deltaZ: 0, deltaMode: 0, windowHandle});
+        break;
+      }
+    }
+  }
+  eventRing[1] = readIndex;
+};
 
 core.setVersion(version);
 
@@ -941,32 +1015,23 @@ const _bindWindow = (window, newWindowCb) => {
     console.warn('got error', err);
   });
 
-  const _saveImage = (context, name) => {
-    const _flipImage = (width, height, stride, arrayBuffer) => {
-      const uint8Array = new Uint8Array(arrayBuffer);
-
-      const arrayBuffer2 = new ArrayBuffer(arrayBuffer.byteLength);
-      const uint8Array2 = new Uint8Array(arrayBuffer2);
-      for (let y = 0; y < height; y++) {
-        const yBottom = height - y - 1;
-        uint8Array2.set(uint8Array.slice(yBottom * width * stride, (yBottom + 1) * width * stride), y * width * stride);
-      }
-      console.log(uint8Array2[0], uint8Array2[1], uint8Array2[2], uint8Array2[3]);
-      return arrayBuffer2;
-    };
-
+  const _saveImage = (context, name, cb) => {
     const gl = context;
     const {canvas} = gl;
     const {width, height} = canvas;
 
-    const arrayBuffer = new ArrayBuffer(width * height * 4);
-    const uint8Array = new Uint8Array(arrayBuffer);
-    gl.readPixels(0, 0, width, height, gl.RGBA, gl.UNSIGNED_BYTE, uint8Array);
-    const result = Buffer.from(UPNG.encode([
-      _flipImage(width, height, 4, arrayBuffer),
-    ], width, height, 0));
-    console.dir({width, height, image: name, result: result.length});
-    fs.writeFileSync(name, result);
+    const pixels = new Uint8Array(width * height * 4);
+    gl.readPixels(0, 0, width, height, gl.RGBA, gl.UNSIGNED_BYTE, pixels);
+    nativeBindings.nativeCanvasRenderingContext2D.encodePixels(pixels, width, height, true, 'image/png', undefined, (err, arrayBuffer) => {
+      if (!err) {
+        const result = Buffer.from(arrayBuffer);
+        console.dir({width, height, image: name, result: result.length});
+        fs.writeFileSync(name, result);
+      } else {
+        console.warn('failed to save image', name, err);
+      }
+      cb();
+    });
   }
   const _blit = () => {
     for (let i = 0; i < contexts.length; i++) {
@@ -1047,6 +1112,22 @@ const _bindWindow = (window, newWindowCb) => {
     total: 0,
   };
   const TIMESTAMP_FRAMES = DEFAULT_FPS;
+  const _traceSpan = (name, start) => {
+    const now = nativeTrace.now();
+    nativeTrace.addSpan('frame', name, start, now);
+    return now;
+  };
+  const _getGpuTimesString = () => {
+    const _formatGpuTime = t => t !== null ? `${t.toFixed(2)}ms` : '-';
+    let result = '';
+    for (let i = 0; i < contexts.length; i++) {
+      const gpuTimes = contexts[i].getGpuTimes();
+      if (gpuTimes) {
+        result += ` | gpu ${_formatGpuTime(gpuTimes.draw)} draw ${_formatGpuTime(gpuTimes.compose)} compose ${_formatGpuTime(gpuTimes.blit)} blit${gpuTimes.dropped > 0 ? ` (${gpuTimes.dropped} dropped)` : ''}`;
+      }
+    }
+    return result;
+  };
   const [leftGamepad, rightGamepad] = core.getAllGamepads();
   const gamepads = [null, null];
   const frameData = new window.VRFrameData();
@@ -1152,9 +1233,12 @@ const _bindWindow = (window, newWindowCb) => {
   });
 
   const _recurse = () => {
+    const frameTraceTime = args.trace ? nativeTrace.now() : 0;
+    let traceTime = frameTraceTime;
+
     if (args.performance) {
       if (timestamps.frames >= TIMESTAMP_FRAMES) {
-        console.log(`${(TIMESTAMP_FRAMES/(timestamps.total/1000)).toFixed(0)} FPS | ${timestamps.idle}ms idle | ${timestamps.wait}ms wait | ${timestamps.prepare}ms prepare | ${timestamps.events}ms events | ${timestamps.media}ms media | ${timestamps.user}ms user | ${timestamps.submit}ms submit`);
+        console.log(`${(TIMESTAMP_FRAMES/(timestamps.total/1000)).toFixed(0)} FPS | ${timestamps.idle}ms idle | ${timestamps.wait}ms wait | ${timestamps.prepare}ms prepare | ${timestamps.events}ms events | ${timestamps.media}ms media | ${timestamps.user}ms user | ${timestamps.submit}ms submit${_getGpuTimesString()}`);
 
         timestamps.frames = 0;
         timestamps.idle = 0;
@@ -1177,12 +1261,7 @@ const _bindWindow = (window, newWindowCb) => {
 
     if (vrPresentState.isPresenting && vrPresentState.glContext && vrPresentState.glContext.canvas.ownerDocument.defaultView === window) {
       // wait for frame
-      vrPresentState.compositor.WaitGetPoses(
-        vrPresentState.system,
-        localFloat32Array, // hmd
-        localFloat32Array2, // left controller
-        localFloat32Array3 // right controller
-      );
+      vrPresentState.compositor.WaitGetPoses();
       vrPresentState.hasPose = true;
       if (args.performance) {
         const now = Date.now();
@@ -1463,8 +1542,18 @@ const _bindWindow = (window, newWindowCb) => {
       }
     }
 
+    if (args.trace) {
+      traceTime = _traceSpan('wait', traceTime);
+    }
+
     // poll for window events
     nativeWindow.pollEvents();
+    if (eventRing) {
+      _decodeEventRing();
+    }
+    if (args.trace) {
+      traceTime = _traceSpan('events', traceTime);
+    }
     if (args.performance) {
       const now = Date.now();
       const diff = now - timestamps.last;
@@ -1479,6 +1568,9 @@ const _bindWindow = (window, newWindowCb) => {
     if (nativeMl && mlPresentState.mlGlContext) {
       nativeMl.PrePollEvents(mlPresentState.mlContext);
     }
+    if (args.trace) {
+      traceTime = _traceSpan('media', traceTime);
+    }
     if (args.performance) {
       const now = Date.now();
       const diff = now - timestamps.last;
@@ -1491,8 +1583,20 @@ const _bindWindow = (window, newWindowCb) => {
     if (args.frame || args.minimalFrame) {
       console.log('-'.repeat(80) + 'start frame');
     }
+    if (args.performance) {
+      for (let i = 0; i < contexts.length; i++) {
+        contexts[i].beginGpuTimer(contexts[i].GPU_TIMER_DRAW);
+      }
+    }
     window.tickAnimationFrame();
+    if (args.trace) {
+      traceTime = _traceSpan('tickAnimationFrame', traceTime);
+    }
     if (args.performance) {
+      for (let i = 0; i < contexts.length; i++) {
+        contexts[i].endGpuTimer(contexts[i].GPU_TIMER_DRAW);
+      }
+
       const now = Date.now();
       const diff = now - timestamps.last;
       timestamps.user += diff;
@@ -1500,10 +1604,15 @@ const _bindWindow = (window, newWindowCb) => {
       timestamps.last = now;
     }
     if (args.image && _takeScreenshot) {
-      _saveImage(contexts[contexts.length - 1], args.image);
-      process.exit(0);
+      _takeScreenshot = false;
+      _saveImage(contexts[contexts.length - 1], args.image, () => {
+        process.exit(0);
+      });
     }
     _blit();
+    if (args.trace) {
+      traceTime = _traceSpan('submit', traceTime);
+    }
     if (args.performance) {
       const now = Date.now();
       const diff = now - timestamps.last;
@@ -1527,6 +1636,9 @@ const _bindWindow = (window, newWindowCb) => {
     if (args.frame || args.minimalFrame) {
       console.log('-'.repeat(80) + 'end frame');
     }
+    if (args.trace) {
+      _traceSpan('frame', frameTraceTime);
+    }
 
     // wait for next frame
     const now = Date.now();
@@ -1649,6 +1761,7 @@ const _start = () => {
     }
     return core.load(u, {
       dataPath,
+      cachePath: !args.noCache ? path.join(dataPath, '.httpCache') : null,
     })
       .then(window => {
         if (args.image) {
@@ -1672,6 +1785,7 @@ const _start = () => {
     };
     _bindReplWindow(core('', {
       dataPath,
+      cachePath: !args.noCache ? path.join(dataPath, '.httpCache') : null,
     }));
 
     const prompt = '[x] ';
@@ -1777,6 +1891,15 @@ if (require.main === module) {
     console.log(version);
     process.exit(0);
   }
+  if (args.trace) {
+    const _dumpTrace = () => {
+      fs.writeFileSync(args.trace, nativeTrace.dump(process.pid));
+      console.log(`wrote trace to ${args.trace}`);
+    };
+    nativeTrace.start();
+    process.on('SIGUSR2', _dumpTrace);
+    process.on('exit', _dumpTrace);
+  }
   if (args.size) {
     const match = args.size.match(/^([0-9]+)x([0-9]+)$/);
     if (match) {
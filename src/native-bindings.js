@@ -47,7 +47,96 @@ const _decorateGlIntercepts = gl => {
     path = webGlToOpenGl.mapName(path);
     return getUniformLocation.call(this, program, path);
   })(gl.getUniformLocation);
+  gl.transformFeedbackVaryings = (transformFeedbackVaryings => function(program, varyings, bufferMode) {
+    varyings = Array.from(varyings, varying => webGlToOpenGl.mapName(varying));
+    return transformFeedbackVaryings.call(this, program, varyings, bufferMode);
+  })(gl.transformFeedbackVaryings);
+  gl.getTransformFeedbackVarying = (getTransformFeedbackVarying => function(program, index) {
+    const result = getTransformFeedbackVarying.call(this, program, index);
+    if (result) {
+      result.name = webGlToOpenGl.unmapName(result.name);
+    }
+    return result;
+  })(gl.getTransformFeedbackVarying);
   gl.setCompatibleXRDevice = () => Promise.resolve();
+
+  // WebGL2 only lets query results become available after control returns to the event loop,
+  // so content cannot spin on a query within one frame.
+  const activeQueries = {};
+  const pendingQueries = new Map(); // id -> serial of the endQuery call
+  let pendingQueriesSerial = 0;
+  let pendingQueriesImmediate = null;
+  // Each immediate releases only the queries ended before it was scheduled; a query ended later, even by
+  // another immediate in the same check phase, waits for the next one.
+  const _schedulePendingQueries = () => {
+    const serial = pendingQueriesSerial;
+    pendingQueriesImmediate = setImmediate(() => {
+      pendingQueriesImmediate = null;
+      pendingQueries.forEach((querySerial, id) => {
+        if (querySerial <= serial) {
+          pendingQueries.delete(id);
+        }
+      });
+      if (pendingQueries.size > 0) {
+        _schedulePendingQueries();
+      }
+    });
+  };
+  gl.beginQuery = (beginQuery => function(target, query) {
+    activeQueries[target] = query;
+    return beginQuery.call(this, target, query);
+  })(gl.beginQuery);
+  gl.endQuery = (endQuery => function(target) {
+    const query = activeQueries[target];
+    if (query) {
+      pendingQueries.set(query.id, ++pendingQueriesSerial);
+      activeQueries[target] = null;
+      if (!pendingQueriesImmediate) {
+        _schedulePendingQueries();
+      }
+    }
+    return endQuery.call(this, target);
+  })(gl.endQuery);
+  gl.getQueryParameter = (getQueryParameter => function(query, pname) {
+    if (query && pendingQueries.has(query.id)) {
+      if (pname === this.QUERY_RESULT_AVAILABLE) {
+        return false;
+      } else if (pname === this.QUERY_RESULT) {
+        return null;
+      }
+    }
+    return getQueryParameter.call(this, query, pname);
+  })(gl.getQueryParameter);
+
+  // Non-stalling getBufferSubData, after WEBGL_get_buffer_sub_data_async: the range is snapshotted now
+  // and copied into dstBuffer once the GPU has caught up, polled from the event loop.
+  gl.getBufferSubDataAsync = function(target, srcByteOffset, dstBuffer, dstOffset = 0, length = 0) {
+    const elementSize = dstBuffer.BYTES_PER_ELEMENT || 1;
+    const byteLength = length > 0 ? length * elementSize : dstBuffer.byteLength - dstOffset * elementSize;
+    const readback = this.beginBufferReadback(target, srcByteOffset, byteLength);
+    return new Promise((accept, reject) => {
+      const _poll = () => {
+        if (this.isContextLost()) {
+          reject(new Error('getBufferSubDataAsync: context lost'));
+          return;
+        }
+        try {
+          const finished = this.finishBufferReadback(readback, dstBuffer, dstOffset, length);
+          if (finished === true) {
+            accept(dstBuffer);
+          } else if (finished === false) {
+            setTimeout(_poll, 1);
+          } else {
+            reject(new Error('getBufferSubDataAsync: readback failed'));
+          }
+        } catch (err) {
+          this.deleteBufferReadback(readback);
+          reject(err);
+        }
+      };
+      setTimeout(_poll, 1);
+    });
+  };
 };
 bindings.nativeGl = (nativeGl => {
   function WebGLRenderingContext(canvas) {
@@ -12,5 +12,6 @@ module.exports.prioritySymbol = Symbol();
 module.exports.prototypesSymbol = Symbol();
 module.exports.runSymbol = Symbol();
 module.exports.runningSymbol = Symbol();
+module.exports.styleIndexSymbol = Symbol();
 module.exports.timeoutSymbol = Symbol();
 module.exports.windowSymbol = Symbol();
@@ -0,0 +1,49 @@
+// Blurs and tints shadow-sized sprites with the SIMD and scalar kernels, then draws shadows through Skia.
+// Usage: node tests/bench/canvas-blur.js
+const exokit = require('../../src/index');
+const {bench} = require('./helpers');
+
+const {window} = exokit();
+const {ImageData} = window;
+
+const width = 512;
+const height = 512;
+const rgba = new Uint8Array(width * height * 4).map((v, i) => (i * 2654435761) >>> 24);
+const alpha = new Uint8Array(width * height).map((v, i) => (i * 2654435761) >>> 24);
+const colorized = new Uint8Array(width * height * 4);
+
+for (const simd of [false, true]) {
+  ImageData.setSimd(simd);
+  const label = simd ? 'simd' : 'scalar';
+  for (const radius of [2, 4, 8, 16]) {
+    bench(`blur ${width}x${height} rgba r=${radius} (${label})`, 20, () => {
+      ImageData.blurPixels(rgba.slice(), width, height, 4, radius, radius);
+    });
+  }
+  bench(`blur ${width}x${height} alpha r=8 (${label})`, 20, () => {
+    ImageData.blurPixels(alpha.slice(), width, height, 1, 8, 8);
+  });
+  bench(`colorize ${width}x${height} (${label})`, 50, () => {
+    ImageData.colorizePixels(alpha, width, height, 'rgba(0, 0, 0, 0.5)', colorized);
+  });
+}
+ImageData.setSimd(true);
+
+const canvas = window.document.createElement('canvas');
+canvas.width = width;
+canvas.height = height;
+const ctx = canvas.getContext('2d');
+ctx.fillStyle = '#48f';
+ctx.shadowColor = 'rgba(0, 0, 0, 0.5)';
+ctx.shadowOffsetX = 4;
+ctx.shadowOffsetY = 4;
+for (const radius of [2, 4, 8, 16]) {
+  ctx.shadowBlur = radius;
+  bench(`skia shadowBlur=${radius} 100 rects`, 20, () => {
+    for (let i = 0; i < 100; i++) {
+      ctx.fillRect((i * 37) % 448, (i * 53) % 448, 64, 64);
+    }
+  });
+}
+
+window.destroy();
@@ -0,0 +1,50 @@
+// Compares JS thread time spent in synchronous toDataURL against asynchronous toBlob,
+// and the worst frame gap of a 60Hz loop while screenshots are being encoded.
+// Usage: node tests/bench/canvas-encode.js
+const {performance} = require('perf_hooks');
+const exokit = require('../../src/index');
+const {bench} = require('./helpers');
+
+const {window} = exokit();
+const canvas = window.document.createElement('canvas');
+canvas.width = 1920;
+canvas.height = 1080;
+const ctx = canvas.getContext('2d');
+for (let i = 0; i < 1000; i++) {
+  ctx.fillStyle = `rgb(${i % 256}, ${(i * 7) % 256}, ${(i * 13) % 256})`;
+  ctx.fillRect((i * 31) % 1920, (i * 17) % 1080, 64, 64);
+}
+
+bench('toDataURL (sync)', 10, () => {
+  ctx.toDataURL('image/png');
+});
+bench('toBlob (JS thread cost)', 10, () => {
+  canvas.toBlob(() => {}, 'image/png');
+});
+
+const numFrames = 120;
+let frame = 0;
+let last = performance.now();
+let worstFrame = 0;
+let pending = 0;
+const _frame = () => {
+  const now = performance.now();
+  worstFrame = Math.max(worstFrame, now - last);
+  last = now;
+
+  if (frame % 10 === 0) {
+    pending++;
+    canvas.toBlob(() => {
+      pending--;
+    }, 'image/png');
+  }
+
+  if (++frame < numFrames || pending > 0) {
+    setTimeout(_frame, 1000 / 60);
+  } else {
+    console.log(`worst frame gap while encoding: ${worstFrame.toFixed(1)} ms`);
+    window.destroy();
+    process.exit(0);
+  }
+};
+_frame();
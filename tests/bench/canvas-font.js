@@ -0,0 +1,37 @@
+// Alternates ctx.font between a handful of declarations before every label, as UI libraries do.
+// Usage: node tests/bench/canvas-font.js
+const exokit = require('../../src/index');
+const {bench} = require('./helpers');
+
+const {window} = exokit();
+const canvas = window.document.createElement('canvas');
+canvas.width = 512;
+canvas.height = 512;
+const ctx = canvas.getContext('2d');
+
+const fonts = [
+  '12px sans-serif',
+  'bold 14px sans-serif',
+  'italic 16px serif',
+  '20px monospace',
+  'bold italic 24px sans-serif',
+];
+
+bench('set font 10k (alternating)', 20, () => {
+  for (let i = 0; i < 10000; i++) {
+    ctx.font = fonts[i % fonts.length];
+  }
+});
+bench('set font 10k (unchanged)', 20, () => {
+  for (let i = 0; i < 10000; i++) {
+    ctx.font = fonts[0];
+  }
+});
+bench('set font + fillText 10k', 20, () => {
+  for (let i = 0; i < 10000; i++) {
+    ctx.font = fonts[i % fonts.length];
+    ctx.fillText('label', (i * 13) % 512, (i * 7) % 512);
+  }
+});
+
+window.destroy();
@@ -0,0 +1,45 @@
+// Fills a 10k-segment polyline every frame, once rebuilt through beginPath/lineTo and once from a retained Path2D.
+// Usage: node tests/bench/canvas-path.js
+const exokit = require('../../src/index');
+const {bench} = require('./helpers');
+
+const {window} = exokit();
+const canvas = window.document.createElement('canvas');
+canvas.width = 512;
+canvas.height = 512;
+const ctx = canvas.getContext('2d');
+
+const numSegments = 10000;
+const points = new Float32Array(numSegments * 2);
+for (let i = 0; i < numSegments; i++) {
+  const angle = i / numSegments * Math.PI * 2;
+  const radius = 200 + Math.sin(i * 0.37) * 40;
+  points[i * 2] = 256 + Math.cos(angle) * radius;
+  points[i * 2 + 1] = 256 + Math.sin(angle) * radius;
+}
+
+const path = new window.Path2D();
+path.moveTo(points[0], points[1]);
+for (let i = 1; i < numSegments; i++) {
+  path.lineTo(points[i * 2], points[i * 2 + 1]);
+}
+path.closePath();
+
+ctx.fillStyle = '#336699';
+bench('beginPath/lineTo 10k + fill', 50, () => {
+  ctx.beginPath();
+  ctx.moveTo(points[0], points[1]);
+  for (let i = 1; i < numSegments; i++) {
+    ctx.lineTo(points[i * 2], points[i * 2 + 1]);
+  }
+  ctx.closePath();
+  ctx.fill();
+});
+bench('fill(Path2D) 10k', 50, () => {
+  ctx.fill(path);
+});
+bench('Path2D getBounds', 1000, () => {
+  path.getBounds();
+});
+
+window.destroy();
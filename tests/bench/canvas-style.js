@@ -0,0 +1,46 @@
+// Thrashes fillStyle/strokeStyle between a few colours around small draws, as chart and UI code does.
+// Usage: node tests/bench/canvas-style.js
+const exokit = require('../../src/index');
+const {bench} = require('./helpers');
+
+const {window} = exokit();
+const canvas = window.document.createElement('canvas');
+canvas.width = 512;
+canvas.height = 512;
+const ctx = canvas.getContext('2d');
+
+const colors = [
+  '#ff0000',
+  '#00ff00',
+  'rgba(0, 0, 255, 0.5)',
+  'rgb(32, 64, 128)',
+  'steelblue',
+  'hsla(120, 50%, 50%, 0.8)',
+];
+
+bench('set fillStyle 10k', 20, () => {
+  for (let i = 0; i < 10000; i++) {
+    ctx.fillStyle = colors[i % colors.length];
+  }
+});
+bench('set fillStyle/strokeStyle + fillRect 10k', 20, () => {
+  for (let i = 0; i < 10000; i++) {
+    ctx.fillStyle = colors[i % colors.length];
+    ctx.strokeStyle = colors[(i + 1) % colors.length];
+    ctx.fillRect((i * 13) % 512, (i * 7) % 512, 4, 4);
+  }
+});
+bench('get fillStyle 10k', 20, () => {
+  for (let i = 0; i < 10000; i++) {
+    ctx.fillStyle;
+  }
+});
+bench('addColorStop 1k gradients', 20, () => {
+  for (let i = 0; i < 1000; i++) {
+    const gradient = ctx.createLinearGradient(0, 0, 512, 0);
+    gradient.addColorStop(0, colors[i % colors.length]);
+    gradient.addColorStop(1, colors[(i + 3) % colors.length]);
+  }
+});
+
+window.destroy();
@@ -0,0 +1,31 @@
+// Draws 10k repeated HUD labels into a raster canvas per frame.
+// Usage: node tests/bench/canvas-text.js
+const exokit = require('../../src/index');
+const {bench} = require('./helpers');
+
+const {window} = exokit();
+const canvas = window.document.createElement('canvas');
+canvas.width = 1024;
+canvas.height = 1024;
+const ctx = canvas.getContext('2d');
+ctx.font = '16px sans-serif';
+ctx.fillStyle = '#fff';
+
+const labels = [];
+for (let i = 0; i < 100; i++) {
+  labels.push(`label ${i}`);
+}
+
+bench('fillText 10k labels', 20, () => {
+  for (let i = 0; i < 10000; i++) {
+    ctx.fillText(labels[i % labels.length], (i * 13) % 1024, (i * 7) % 1024);
+  }
+});
+bench('measureText 10k labels', 20, () => {
+  for (let i = 0; i < 10000; i++) {
+    ctx.measureText(labels[i % labels.length]);
+  }
+});
+
+window.destroy();
+process.exit(0);
@@ -0,0 +1,43 @@
+// Queries clientWidth across a DOM-heavy page with many stylesheet rules, with and without mutations in between.
+// Usage: node tests/bench/dom-computed-style.js
+const exokit = require('../../src/index');
+const {bench} = require('./helpers');
+
+const {window} = exokit();
+const {document} = window;
+
+const numElements = 2000;
+const numRules = 500;
+
+const els = [];
+for (let i = 0; i < numElements; i++) {
+  const el = document.createElement('div');
+  el.className = 'item item-' + (i % numRules);
+  document.body.appendChild(el);
+  els.push(el);
+}
+
+let css = '';
+for (let i = 0; i < numRules; i++) {
+  css += `.item-${i} { color: #${(i * 4099 % 0xffffff).toString(16).padStart(6, '0')}; }\n`;
+  css += `#el-${i} { width: ${i}px; }\n`;
+  css += `section > p.note-${i} { margin: ${i}px; }\n`;
+}
+const style = document.createElement('style');
+style.addEventListener('load', () => {
+  bench(`clientWidth x${numElements}`, 20, () => {
+    for (let i = 0; i < els.length; i++) {
+      els[i].clientWidth;
+    }
+  });
+  bench(`setAttribute + getComputedStyle x${numElements}`, 20, i => {
+    for (let j = 0; j < els.length; j++) {
+      els[j].setAttribute('data-frame', i);
+      window.getComputedStyle(els[j]);
+    }
+  });
+
+  window.destroy();
+});
+document.head.appendChild(style);
+style.innerHTML = css;
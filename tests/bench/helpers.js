@@ -0,0 +1,20 @@
+const {performance} = require('perf_hooks');
+
+/**
+ * Run `fn` for `iterations` rounds after a short warmup and print the mean time per round.
+ */
+const bench = (name, iterations, fn) => {
+  for (let i = 0; i < Math.min(iterations, 10); i++) {
+    fn(i);
+  }
+
+  const start = performance.now();
+  for (let i = 0; i < iterations; i++) {
+    fn(i);
+  }
+  const elapsed = performance.now() - start;
+
+  console.log(`${name}: ${(elapsed / iterations).toFixed(3)} ms/iter (${iterations} iters, ${elapsed.toFixed(1)} ms total)`);
+  return elapsed / iterations;
+};
+module.exports.bench = bench;
@@ -0,0 +1,59 @@
+// Loads a set of subresources from a local server with simulated latency, cold (empty cache) then warm (cache
+// reopened from disk, as on the next launch).
+// Usage: node tests/bench/http-cache.js [numResources] [latencyMs]
+const fs = require('fs');
+const http = require('http');
+const os = require('os');
+const path = require('path');
+const {performance} = require('perf_hooks');
+const fetch = require('window-fetch');
+const {HttpCache} = require('../../src/HttpCache');
+
+const numResources = parseInt(process.argv[2], 10) || 50;
+const latency = parseInt(process.argv[3], 10) || 30;
+const body = Buffer.alloc(256 * 1024, 0x61);
+
+const server = http.createServer((req, res) => {
+  setTimeout(() => {
+    if (req.headers['if-none-match'] === '"v1"') {
+      res.writeHead(304);
+      res.end();
+    } else {
+      res.writeHead(200, {
+        'Cache-Control': req.url.startsWith('/revalidate') ? 'no-cache' : 'max-age=3600',
+        'ETag': '"v1"',
+      });
+      res.end(body);
+    }
+  }, latency);
+}).listen(0, () => {
+  const baseUrl = `http://127.0.0.1:${server.address().port}`;
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'exokit-bench-http-cache-'));
+
+  const _loadAll = (cache, prefix) => {
+    const start = performance.now();
+    const promises = [];
+    for (let i = 0; i < numResources; i++) {
+      promises.push(cache.fetch(`${baseUrl}/${prefix}/${i}`, {}, fetch).then(res => res.arrayBuffer()));
+    }
+    return Promise.all(promises).then(() => performance.now() - start);
+  };
+  const _run = prefix => {
+    const cold = new HttpCache(dir);
+    return _loadAll(cold, prefix)
+      .then(coldTime => {
+        cold._saveSync();
+        return new Promise(accept => setTimeout(accept, 200))
+          .then(() => _loadAll(new HttpCache(dir), prefix))
+          .then(warmTime => {
+            console.log(`${prefix} x${numResources}: cold ${coldTime.toFixed(1)} ms, warm ${warmTime.toFixed(1)} ms`);
+          });
+      });
+  };
+
+  _run('fresh')
+    .then(() => _run('revalidate'))
+    .then(() => {
+      server.close();
+    });
+});
@@ -0,0 +1,55 @@
+// Loads a large local file as an ArrayBuffer through XHR and fetch, reporting wall time and peak RSS.
+// Usage: node tests/bench/network-file.js [sizeInMB]
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const {performance} = require('perf_hooks');
+const exokit = require('../../src/index');
+
+const size = (parseInt(process.argv[2], 10) || 200) * 1024 * 1024;
+const p = path.join(os.tmpdir(), `exokit-bench-${size}.bin`);
+if (!fs.existsSync(p) || fs.statSync(p).size !== size) {
+  const chunk = Buffer.alloc(1024 * 1024, 0x5a);
+  const fd = fs.openSync(p, 'w');
+  for (let i = 0; i < size; i += chunk.length) {
+    fs.writeSync(fd, chunk);
+  }
+  fs.closeSync(fd);
+}
+
+const {window} = exokit();
+
+const _xhr = url => new Promise((accept, reject) => {
+  const xhr = new window.XMLHttpRequest();
+  xhr.open('GET', url);
+  xhr.responseType = 'arraybuffer';
+  xhr.onload = () => accept(xhr.response);
+  xhr.onerror = reject;
+  xhr.send();
+});
+const _fetch = url => window.fetch(url).then(res => res.arrayBuffer());
+
+const _measure = (name, fn) => {
+  global.gc && global.gc();
+  const rssBefore = process.memoryUsage().rss;
+  let peakRss = rssBefore;
+  const interval = setInterval(() => {
+    peakRss = Math.max(peakRss, process.memoryUsage().rss);
+  }, 5);
+  const start = performance.now();
+  return fn().then(arrayBuffer => {
+    const elapsed = performance.now() - start;
+    clearInterval(interval);
+    peakRss = Math.max(peakRss, process.memoryUsage().rss);
+    console.log(`${name}: ${elapsed.toFixed(1)} ms, ${arrayBuffer.byteLength} bytes, peak RSS +${((peakRss - rssBefore) / 1024 / 1024).toFixed(1)} MB`);
+  });
+};
+
+const blobUrl = window.URL.createObjectURL(new window.Blob([fs.readFileSync(p)]));
+_measure('xhr file://', () => _xhr('file://' + p))
+  .then(() => _measure('fetch file://', () => _fetch('file://' + p)))
+  .then(() => _measure('xhr blob:', () => _xhr(blobUrl)))
+  .then(() => _measure('fetch blob:', () => _fetch(blobUrl)))
+  .then(() => {
+    window.destroy();
+  });
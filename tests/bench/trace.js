@@ -0,0 +1,36 @@
+// Per-call overhead of the native trace points: GL calls and JS spans with tracing off, then on.
+// Disabled numbers should match an untraced build to within noise.
+// Usage: node tests/bench/trace.js
+const exokit = require('../../src/index');
+const {nativeTrace} = require('../../src/native-bindings');
+const {bench} = require('./helpers');
+
+const {window} = exokit();
+const gl = window.WebGLRenderingContext(window.document.createElement('canvas'));
+const iterations = 100000;
+
+const _run = label => {
+  bench(`gl.getError x1000 (${label})`, iterations / 1000, () => {
+    for (let i = 0; i < 1000; i++) {
+      gl.getError();
+    }
+  });
+  bench(`addSpan x1000 (${label})`, iterations / 1000, () => {
+    for (let i = 0; i < 1000; i++) {
+      const now = nativeTrace.now();
+      nativeTrace.addSpan('bench', 'span', now, now);
+    }
+  });
+};
+
+nativeTrace.stop();
+_run('tracing disabled');
+nativeTrace.start();
+_run('tracing enabled');
+nativeTrace.stop();
+
+const trace = JSON.parse(nativeTrace.dump(process.pid));
+console.log(`${trace.traceEvents.length} events, ${trace.otherData.droppedEvents} dropped`);
+
+window.destroy();
+process.exit(0);
@@ -0,0 +1,22 @@
+// Polls mock VR poses the way the frame loop does, without a headset.
+// Usage: node tests/bench/vr-poses.js
+const {nativeVr} = require('../../src/native-bindings');
+const {bench} = require('./helpers');
+
+const compositor = nativeVr.getContext().compositor.NewMockCompositor();
+const hmd = new Float32Array(16);
+const left = new Float32Array(16);
+const right = new Float32Array(16);
+
+bench('WaitGetPoses per-call buffers 10k', 20, () => {
+  for (let i = 0; i < 10000; i++) {
+    compositor.WaitGetPoses(null, hmd, left, right);
+  }
+});
+
+compositor.SetPoseBuffers(null, hmd, left, right);
+bench('WaitGetPoses registered buffers 10k', 20, () => {
+  for (let i = 0; i < 10000; i++) {
+    compositor.WaitGetPoses();
+  }
+});
@@ -0,0 +1,86 @@
+// Rewrites dynamic vertex data between draws, the way UI, particle and line renderers do, and reports how the
+// uploads were serviced: orphaned whole-buffer rewrites, partial updates streamed through the staging ring,
+// and direct glBufferSubData fallbacks (with how many were forced by a busy ring).
+// Run on llvmpipe with LIBGL_ALWAYS_SOFTWARE=1 to see the stalls a software rasterizer adds.
+// Usage: node tests/bench/webgl-buffer-streaming.js
+const exokit = require('../../src/index');
+const {bench} = require('./helpers');
+
+const {window} = exokit();
+const gl = window.WebGLRenderingContext(window.document.createElement('canvas'));
+const iterations = 100;
+const drawsPerIteration = 100;
+const numVertices = 16 * 1024;
+
+const _compileShader = (type, source) => {
+  const shader = gl.createShader(type);
+  gl.shaderSource(shader, source);
+  gl.compileShader(shader);
+  return shader;
+};
+const program = gl.createProgram();
+gl.attachShader(program, _compileShader(gl.VERTEX_SHADER, `#version 300 es
+in vec2 position;
+void main() {
+  gl_PointSize = 1.0;
+  gl_Position = vec4(position, 0.0, 1.0);
+}`));
+gl.attachShader(program, _compileShader(gl.FRAGMENT_SHADER, `#version 300 es
+precision mediump float;
+out vec4 fragColor;
+void main() {
+  fragColor = vec4(1.0);
+}`));
+gl.linkProgram(program);
+gl.useProgram(program);
+
+const vao = gl.createVertexArray();
+gl.bindVertexArray(vao);
+const positionLocation = gl.getAttribLocation(program, 'position');
+gl.enableVertexAttribArray(positionLocation);
+
+const vertices = new Float32Array(numVertices * 2);
+const _updateVertices = i => {
+  for (let j = 0; j < vertices.length; j++) {
+    vertices[j] = Math.sin(i + j) * 0.9;
+  }
+};
+const _createBuffer = usage => {
+  const buffer = gl.createBuffer();
+  gl.bindBuffer(gl.ARRAY_BUFFER, buffer);
+  gl.bufferData(gl.ARRAY_BUFFER, vertices.byteLength, usage);
+  gl.vertexAttribPointer(positionLocation, 2, gl.FLOAT, false, 0, 0);
+  return buffer;
+};
+const _report = name => {
+  const stats = gl.getBufferUploadStats();
+  console.log(`  ${name}: ${JSON.stringify(stats)}`);
+};
+
+const _run = (name, usage, partial) => {
+  _createBuffer(usage);
+  gl.getBufferUploadStats();
+  const ms = bench(`${name} x${drawsPerIteration}`, iterations, i => {
+    for (let j = 0; j < drawsPerIteration; j++) {
+      _updateVertices(i * drawsPerIteration + j);
+      if (partial) {
+        // rewrite all but the first vertex, so the upload is not a whole-buffer orphan
+        gl.bufferSubData(gl.ARRAY_BUFFER, 8, vertices, 2);
+      } else {
+        gl.bufferSubData(gl.ARRAY_BUFFER, 0, vertices);
+      }
+      gl.drawArrays(gl.POINTS, 0, numVertices);
+    }
+    gl.finish();
+  });
+  const bytesPerIteration = drawsPerIteration * vertices.byteLength;
+  console.log(`  ${(bytesPerIteration / ms / 1e3).toFixed(1)} MB/s`);
+  _report(name);
+};
+
+_run('STATIC_DRAW rewrite (direct)', gl.STATIC_DRAW, false);
+_run('DYNAMIC_DRAW rewrite (orphan)', gl.DYNAMIC_DRAW, false);
+_run('DYNAMIC_DRAW partial (ring)', gl.DYNAMIC_DRAW, true);
+
+window.destroy();
+process.exit(0);
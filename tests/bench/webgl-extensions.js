@@ -0,0 +1,33 @@
+// Feature-tests extensions the way libraries do in hot paths: getExtension and getSupportedExtensions
+// called repeatedly for the same names.
+// Usage: node tests/bench/webgl-extensions.js
+const exokit = require('../../src/index');
+const {bench} = require('./helpers');
+
+const {window} = exokit();
+const gl = window.WebGLRenderingContext(window.document.createElement('canvas'));
+const iterations = 200;
+const lookupsPerIteration = 1000;
+const names = [
+  'WEBGL_draw_buffers',
+  'ANGLE_instanced_arrays',
+  'OES_vertex_array_object',
+  'EXT_texture_filter_anisotropic',
+  'WEBGL_compressed_texture_s3tc',
+  'WEBGL_nonexistent',
+];
+
+bench(`getExtension x${lookupsPerIteration}`, iterations, () => {
+  for (let i = 0; i < lookupsPerIteration; i++) {
+    gl.getExtension(names[i % names.length]);
+  }
+});
+
+bench(`getSupportedExtensions x${lookupsPerIteration}`, iterations, () => {
+  for (let i = 0; i < lookupsPerIteration; i++) {
+    gl.getSupportedExtensions();
+  }
+});
+
+window.destroy();
+process.exit(0);
@@ -0,0 +1,80 @@
+// Draw-call-bound scene: thousands of tiny meshes submitted one drawElements call at a time versus
+// one WEBGL_multi_draw call per frame, so the cost measured is the JS -> native crossing per draw.
+// Usage: xvfb-run -s "-screen 0 1280x1024x24" node tests/bench/webgl-multi-draw.js
+const exokit = require('../../src/index');
+const {bench} = require('./helpers');
+
+const {window} = exokit();
+const gl = window.WebGLRenderingContext(window.document.createElement('canvas'));
+const ext = gl.getExtension('WEBGL_multi_draw');
+const iterations = 100;
+const numMeshes = 4096;
+
+const _compileShader = (type, source) => {
+  const shader = gl.createShader(type);
+  gl.shaderSource(shader, source);
+  gl.compileShader(shader);
+  return shader;
+};
+const program = gl.createProgram();
+gl.attachShader(program, _compileShader(gl.VERTEX_SHADER, `#version 300 es
+in vec2 position;
+void main() {
+  gl_Position = vec4(position, 0.0, 1.0);
+}`));
+gl.attachShader(program, _compileShader(gl.FRAGMENT_SHADER, `#version 300 es
+precision mediump float;
+out vec4 fragColor;
+void main() {
+  fragColor = vec4(1.0);
+}`));
+gl.linkProgram(program);
+gl.useProgram(program);
+
+// one small quad per mesh on a 64x64 grid, each with its own index range
+const gridSize = 64;
+const positions = new Float32Array(numMeshes * 4 * 2);
+const indices = new Uint16Array(numMeshes * 6);
+for (let i = 0; i < numMeshes; i++) {
+  const x = (i % gridSize) / gridSize * 2 - 1;
+  const y = Math.floor(i / gridSize) / gridSize * 2 - 1;
+  const size = 1 / gridSize;
+  positions.set([x, y, x + size, y, x, y + size, x + size, y + size], i * 8);
+  const base = i * 4;
+  indices.set([base, base + 1, base + 2, base + 2, base + 1, base + 3], i * 6);
+}
+
+const vao = gl.createVertexArray();
+gl.bindVertexArray(vao);
+const positionBuffer = gl.createBuffer();
+gl.bindBuffer(gl.ARRAY_BUFFER, positionBuffer);
+gl.bufferData(gl.ARRAY_BUFFER, positions, gl.STATIC_DRAW);
+const positionLocation = gl.getAttribLocation(program, 'position');
+gl.enableVertexAttribArray(positionLocation);
+gl.vertexAttribPointer(positionLocation, 2, gl.FLOAT, false, 0, 0);
+const indexBuffer = gl.createBuffer();
+gl.bindBuffer(gl.ELEMENT_ARRAY_BUFFER, indexBuffer);
+gl.bufferData(gl.ELEMENT_ARRAY_BUFFER, indices, gl.STATIC_DRAW);
+
+const counts = new Int32Array(numMeshes).fill(6);
+const offsets = new Int32Array(numMeshes);
+for (let i = 0; i < numMeshes; i++) {
+  offsets[i] = i * 6 * Uint16Array.BYTES_PER_ELEMENT;
+}
+
+bench(`drawElements x${numMeshes}`, iterations, () => {
+  gl.clear(gl.COLOR_BUFFER_BIT);
+  for (let i = 0; i < numMeshes; i++) {
+    gl.drawElements(gl.TRIANGLES, counts[i], gl.UNSIGNED_SHORT, offsets[i]);
+  }
+  gl.finish();
+});
+
+bench(`multiDrawElementsWEBGL x${numMeshes}`, iterations, () => {
+  gl.clear(gl.COLOR_BUFFER_BIT);
+  ext.multiDrawElementsWEBGL(gl.TRIANGLES, counts, 0, gl.UNSIGNED_SHORT, offsets, 0, numMeshes);
+  gl.finish();
+});
+
+window.destroy();
+process.exit(0);
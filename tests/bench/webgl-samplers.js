@@ -0,0 +1,80 @@
+// Draws one texture with alternating NEAREST/LINEAR filtering, switching either by rewriting texParameteri
+// before each draw or by binding one of two prebuilt sampler objects.
+// Usage: node tests/bench/webgl-samplers.js
+const exokit = require('../../src/index');
+const {bench} = require('./helpers');
+
+const {window} = exokit();
+const gl = window.WebGLRenderingContext(window.document.createElement('canvas'));
+const iterations = 200;
+const drawsPerIteration = 500;
+
+const _compileShader = (type, source) => {
+  const shader = gl.createShader(type);
+  gl.shaderSource(shader, source);
+  gl.compileShader(shader);
+  return shader;
+};
+const program = gl.createProgram();
+gl.attachShader(program, _compileShader(gl.VERTEX_SHADER, `#version 300 es
+in vec2 position;
+out vec2 uv;
+void main() {
+  uv = position * 0.5 + 0.5;
+  gl_Position = vec4(position, 0.0, 1.0);
+}`));
+gl.attachShader(program, _compileShader(gl.FRAGMENT_SHADER, `#version 300 es
+precision mediump float;
+uniform sampler2D tex;
+in vec2 uv;
+out vec4 fragColor;
+void main() {
+  fragColor = texture(tex, uv);
+}`));
+gl.linkProgram(program);
+gl.useProgram(program);
+
+const vao = gl.createVertexArray();
+gl.bindVertexArray(vao);
+const buffer = gl.createBuffer();
+gl.bindBuffer(gl.ARRAY_BUFFER, buffer);
+gl.bufferData(gl.ARRAY_BUFFER, new Float32Array([-1, -1, 1, -1, -1, 1, 1, 1]), gl.STATIC_DRAW);
+const positionLocation = gl.getAttribLocation(program, 'position');
+gl.enableVertexAttribArray(positionLocation);
+gl.vertexAttribPointer(positionLocation, 2, gl.FLOAT, false, 0, 0);
+
+const texture = gl.createTexture();
+gl.activeTexture(gl.TEXTURE0);
+gl.bindTexture(gl.TEXTURE_2D, texture);
+gl.texImage2D(gl.TEXTURE_2D, 0, gl.RGBA, 256, 256, 0, gl.RGBA, gl.UNSIGNED_BYTE, new Uint8Array(256 * 256 * 4));
+gl.uniform1i(gl.getUniformLocation(program, 'tex'), 0);
+
+const filters = [gl.NEAREST, gl.LINEAR];
+const samplers = filters.map(filter => {
+  const sampler = gl.createSampler();
+  gl.samplerParameteri(sampler, gl.TEXTURE_MIN_FILTER, filter);
+  gl.samplerParameteri(sampler, gl.TEXTURE_MAG_FILTER, filter);
+  return sampler;
+});
+
+bench(`texParameteri switch x${drawsPerIteration}`, iterations, () => {
+  for (let i = 0; i < drawsPerIteration; i++) {
+    const filter = filters[i & 1];
+    gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_MIN_FILTER, filter);
+    gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_MAG_FILTER, filter);
+    gl.drawArrays(gl.TRIANGLE_STRIP, 0, 4);
+  }
+  gl.finish();
+});
+
+bench(`bindSampler switch x${drawsPerIteration}`, iterations, () => {
+  for (let i = 0; i < drawsPerIteration; i++) {
+    gl.bindSampler(0, samplers[i & 1]);
+    gl.drawArrays(gl.TRIANGLE_STRIP, 0, 4);
+  }
+  gl.finish();
+});
+gl.bindSampler(0, null);
+
+window.destroy();
+process.exit(0);
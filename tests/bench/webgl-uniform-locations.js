@@ -0,0 +1,77 @@
+// Looks up every uniform of a program before each draw, the way engines that do not hoist
+// getUniformLocation out of their render loop behave, against locations hoisted once after link.
+// Usage: node tests/bench/webgl-uniform-locations.js
+const exokit = require('../../src/index');
+const {bench} = require('./helpers');
+
+const {window} = exokit();
+const gl = window.WebGLRenderingContext(window.document.createElement('canvas'));
+const iterations = 200;
+const drawsPerIteration = 500;
+
+const _compileShader = (type, source) => {
+  const shader = gl.createShader(type);
+  gl.shaderSource(shader, source);
+  gl.compileShader(shader);
+  return shader;
+};
+const program = gl.createProgram();
+gl.attachShader(program, _compileShader(gl.VERTEX_SHADER, `#version 300 es
+uniform mat4 modelViewMatrix;
+uniform mat4 projectionMatrix;
+uniform vec2 offsets[4];
+in vec2 position;
+void main() {
+  gl_Position = projectionMatrix * modelViewMatrix * vec4(position + offsets[gl_InstanceID & 3], 0.0, 1.0);
+}`));
+gl.attachShader(program, _compileShader(gl.FRAGMENT_SHADER, `#version 300 es
+precision mediump float;
+uniform vec4 color;
+uniform float opacity;
+out vec4 fragColor;
+void main() {
+  fragColor = vec4(color.rgb, color.a * opacity);
+}`));
+gl.linkProgram(program);
+gl.useProgram(program);
+
+const vao = gl.createVertexArray();
+gl.bindVertexArray(vao);
+const buffer = gl.createBuffer();
+gl.bindBuffer(gl.ARRAY_BUFFER, buffer);
+gl.bufferData(gl.ARRAY_BUFFER, new Float32Array([-1, -1, 1, -1, -1, 1, 1, 1]), gl.STATIC_DRAW);
+const positionLocation = gl.getAttribLocation(program, 'position');
+gl.enableVertexAttribArray(positionLocation);
+gl.vertexAttribPointer(positionLocation, 2, gl.FLOAT, false, 0, 0);
+
+const identity = new Float32Array([1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1]);
+const offsets = new Float32Array(8);
+const color = new Float32Array([1, 0.5, 0.25, 1]);
+const names = ['modelViewMatrix', 'projectionMatrix', 'offsets', 'color', 'opacity'];
+const _setUniforms = locations => {
+  gl.uniformMatrix4fv(locations[0], false, identity);
+  gl.uniformMatrix4fv(locations[1], false, identity);
+  gl.uniform2fv(locations[2], offsets);
+  gl.uniform4fv(locations[3], color);
+  gl.uniform1f(locations[4], 1);
+};
+
+bench(`getUniformLocation per draw x${drawsPerIteration}`, iterations, () => {
+  for (let i = 0; i < drawsPerIteration; i++) {
+    _setUniforms(names.map(name => gl.getUniformLocation(program, name)));
+    gl.drawArrays(gl.TRIANGLE_STRIP, 0, 4);
+  }
+  gl.finish();
+});
+
+const locations = names.map(name => gl.getUniformLocation(program, name));
+bench(`hoisted locations x${drawsPerIteration}`, iterations, () => {
+  for (let i = 0; i < drawsPerIteration; i++) {
+    _setUniforms(locations);
+    gl.drawArrays(gl.TRIANGLE_STRIP, 0, 4);
+  }
+  gl.finish();
+});
+
+window.destroy();
+process.exit(0);
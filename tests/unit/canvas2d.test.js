@@ -0,0 +1,139 @@
+/* global afterEach, beforeEach, assert, it */
+const crypto = require('crypto');
+const exokit = require('../../src/index');
+const helpers = require('./helpers');
+
+helpers.describeSkipCI('CanvasRenderingContext2D', () => {
+  var window;
+  var ctx;
+
+  beforeEach(() => {
+    window = exokit().window;
+    const canvas = window.document.createElement('canvas');
+    canvas.width = 4;
+    canvas.height = 4;
+    ctx = canvas.getContext('2d');
+  });
+
+  afterEach(() => {
+    window.destroy();
+  });
+
+  it('serializes colours canonically', () => {
+    assert.equal(ctx.fillStyle, '#000000');
+
+    ctx.fillStyle = '#FF8000';
+    assert.equal(ctx.fillStyle, '#ff8000');
+    ctx.fillStyle = 'rgb(255, 128, 0)';
+    assert.equal(ctx.fillStyle, '#ff8000');
+    ctx.fillStyle = 'orange';
+    assert.equal(ctx.fillStyle, '#ffa500');
+    ctx.strokeStyle = 'rgba(1,2,3,0.5)';
+    assert.equal(ctx.strokeStyle, 'rgba(1, 2, 3, 0.5)');
+    ctx.strokeStyle = 'hsl(0, 100%, 50%)';
+    assert.equal(ctx.strokeStyle, '#ff0000');
+  });
+
+  it('fast path matches the full parser', () => {
+    const pixel = style => {
+      ctx.clearRect(0, 0, 4, 4);
+      ctx.fillStyle = style;
+      ctx.fillRect(0, 0, 4, 4);
+      return Array.from(ctx.getImageData(0, 0, 1, 1).data);
+    };
+    // the second form of each pair is outside the fast path
+    assert.deepEqual(pixel('#336699'), pixel('#336699 '));
+    assert.deepEqual(pixel('rgba(10, 20, 30, 1)'), pixel('RGBA(10,20,30,1)'));
+    assert.deepEqual(pixel('rgb(300, 0, 0)'), pixel('rgb(100%, 0%, 0%)'));
+  });
+
+  it('returns gradients from the style getters', () => {
+    const gradient = ctx.createLinearGradient(0, 0, 4, 0);
+    gradient.addColorStop(0, 'red');
+    gradient.addColorStop(1, 'rgba(0, 0, 255, 0.5)');
+    ctx.fillStyle = gradient;
+    assert.strictEqual(ctx.fillStyle, gradient);
+  });
+
+  it('blurs and colorizes exactly like the scalar baseline, with and without SIMD', () => {
+    // sha256 of each output, generated from the implementation before vectorization
+    const expected = require('./data/blur-colorize.json');
+    const _hash = data => crypto.createHash('sha256').update(Buffer.from(data.buffer, data.byteOffset, data.byteLength)).digest('hex');
+    const {ImageData} = window;
+    const width = 67;
+    const height = 41;
+
+    try {
+      for (const simd of [false, true]) {
+        ImageData.setSimd(simd);
+        let seed = 1;
+        const random = () => {
+          seed = (seed * 16807) % 2147483647;
+          return seed & 0xFF;
+        };
+
+        for (const numChannels of [1, 4]) {
+          const source = new Uint8Array(width * height * numChannels).map(random);
+          for (const radius of [0.5, 1, 2.5, 4, 8, 16]) {
+            const result = source.slice();
+            ImageData.blurPixels(result, width, height, numChannels, radius, radius / 2);
+            assert.equal(_hash(result), expected[`blur ${numChannels} ${radius}`], `simd ${simd} channels ${numChannels} radius ${radius}`);
+          }
+        }
+
+        const alpha = new Uint8Array(width * height).map(random);
+        for (const color of ['#ff8000', 'rgba(20, 200, 90, 0.5)', 'white']) {
+          const result = new Uint8Array(width * height * 4);
+          ImageData.colorizePixels(alpha, width, height, color, result);
+          assert.equal(_hash(result), expected[`colorize ${color}`], `simd ${simd} ${color}`);
+        }
+      }
+    } finally {
+      ImageData.setSimd(true);
+    }
+  });
+
+  it('blurs pixel buffers larger than 65535 pixels wide in place', () => {
+    const {ImageData} = window;
+    const width = 70000;
+    const pixels = new Uint8Array(width);
+    pixels[width - 100] = 255;
+    ImageData.blurPixels(pixels, width, 1, 1, 4, 0);
+    assert.equal(pixels[width - 100 - 4 - 1], 0);
+    assert.ok(pixels[width - 100] > 0);
+    assert.ok(pixels[width - 100] < 255);
+  });
+
+  it('draws shadows through Skia image filters', () => {
+    ctx.shadowColor = 'rgba(255, 0, 0, 1)';
+    ctx.shadowOffsetX = 2;
+    assert.equal(ctx.shadowColor, '#ff0000');
+    ctx.fillStyle = '#00ff00';
+    ctx.fillRect(0, 0, 1, 1);
+    assert.deepEqual(Array.from(ctx.getImageData(2, 0, 1, 1).data), [255, 0, 0, 255]);
+    assert.deepEqual(Array.from(ctx.getImageData(0, 0, 1, 1).data), [0, 255, 0, 255]);
+
+    ctx.filter = 'blur(2px)';
+    assert.equal(ctx.filter, 'blur(2px)');
+  });
+
+  it('fills a retained Path2D and reports its bounds', () => {
+    const path = new window.Path2D();
+    path.rect(1, 1, 2, 2);
+    const generation = path.getGenerationId();
+    assert.deepEqual(path.getBounds(), {x: 1, y: 1, width: 2, height: 2});
+    assert.equal(path.getGenerationId(), generation);
+
+    ctx.fillStyle = '#0000ff';
+    ctx.fill(path);
+    ctx.fill(path);
+    assert.equal(path.getGenerationId(), generation);
+    assert.deepEqual(Array.from(ctx.getImageData(1, 1, 1, 1).data), [0, 0, 255, 255]);
+    assert.deepEqual(Array.from(ctx.getImageData(0, 0, 1, 1).data), [0, 0, 0, 0]);
+
+    const copy = new window.Path2D(path);
+    copy.arc(2, 2, 1, 0, Math.PI * 2);
+    assert.notEqual(copy.getGenerationId(), generation);
+    assert.deepEqual(copy.getBounds(), {x: 1, y: 1, width: 2, height: 2});
+  });
+});
@@ -86,4 +86,30 @@ describe('Element', () => {
       assert.ok(el.outerHTML.endsWith('</a>'));
     });
   });
+
+  describe('getComputedStyle', () => {
+    it('applies indexed rules and tracks attribute changes', done => {
+      const style = document.createElement('style');
+      style.addEventListener('load', () => {
+        const div = document.createElement('div');
+        document.body.appendChild(div);
+        assert.equal(window.getComputedStyle(div).color, 'red');
+        assert.equal(window.getComputedStyle(div).width, undefined);
+
+        div.className = 'wide';
+        assert.equal(window.getComputedStyle(div).width, '10px');
+        div.id = 'main';
+        assert.equal(window.getComputedStyle(div).color, 'blue');
+
+        const span = document.createElement('span');
+        div.appendChild(span);
+        assert.equal(window.getComputedStyle(span).height, '5px');
+        div.className = '';
+        assert.equal(window.getComputedStyle(span).height, undefined);
+        done();
+      });
+      document.head.appendChild(style);
+      style.innerHTML = 'div { color: red; } .wide { width: 10px; } #main { color: blue; } .wide > span { height: 5px; }';
+    });
+  });
 });
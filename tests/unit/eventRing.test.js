@@ -0,0 +1,77 @@
+/* global afterEach, beforeEach, describe, assert, it */
+const exokit = require('../../src/index');
+const {nativeWindow} = require('../../src/native-bindings');
+const helpers = require('./helpers');
+
+const HEADER_SIZE = 2;
+const RECORD_SIZE = 8;
+
+helpers.describeSkipCI('event ring', () => {
+  var window;
+  var windowHandle;
+  var ring;
+
+  beforeEach(() => {
+    window = exokit().window;
+    const gl = window.WebGLRenderingContext(window.document.createElement('canvas'));
+    windowHandle = gl.getWindowHandle();
+
+    ring = new Float64Array(HEADER_SIZE + 4 * RECORD_SIZE);
+    nativeWindow.setEventRing(ring);
+  });
+
+  afterEach(() => {
+    nativeWindow.setEventRing(null);
+    window.destroy();
+  });
+
+  it('writes key records instead of emitting objects', () => {
+    nativeWindow.injectEvent(windowHandle, 'key', 65, 1, 0x2); // A press with ctrl
+    // keydown plus the synthesized keypress
+    assert.equal(ring[0], 2);
+    assert.equal(ring[HEADER_SIZE], 2); // keydown
+    assert.equal(ring[HEADER_SIZE + 3], 65);
+    assert.equal(ring[HEADER_SIZE + 7], 0x2);
+    assert.equal(ring[HEADER_SIZE + RECORD_SIZE], 3); // keypress
+  });
+
+  it('coalesces unread mousemoves', () => {
+    nativeWindow.injectEvent(windowHandle, 'cursorPos', 10, 20);
+    nativeWindow.injectEvent(windowHandle, 'cursorPos', 30, 40);
+    assert.equal(ring[0], 1);
+    assert.equal(ring[HEADER_SIZE], 4); // mousemove
+    assert.equal(ring[HEADER_SIZE + 3], 30);
+    assert.equal(ring[HEADER_SIZE + 4], 40);
+
+    ring[1] = ring[0]; // consumed
+    nativeWindow.injectEvent(windowHandle, 'cursorPos', 50, 60);
+    assert.equal(ring[0], 2);
+  });
+
+  it('drains a full ring before writing', () => {
+    const drained = [];
+    nativeWindow.setEventRing(ring, () => {
+      for (let i = ring[1]; i < ring[0]; i++) {
+        drained.push(ring[HEADER_SIZE + (i % 4) * RECORD_SIZE + 4]);
+      }
+      ring[1] = ring[0];
+    });
+    for (let i = 0; i < 5; i++) {
+      nativeWindow.injectEvent(windowHandle, 'scroll', 0, i);
+    }
+    assert.deepEqual(drained, [0, -120, -240, -360]);
+    assert.equal(ring[0], 5);
+    assert.equal(ring[1], 4);
+    assert.equal(ring[HEADER_SIZE + 4], -480);
+    assert.equal(nativeWindow.getEventRingDropped(), 0);
+  });
+
+  it('drops events instead of emitting them out of order when full', () => {
+    for (let i = 0; i < 5; i++) {
+      nativeWindow.injectEvent(windowHandle, 'scroll', 0, i);
+    }
+    assert.equal(ring[0], 4);
+    assert.equal(ring[HEADER_SIZE + 3 * RECORD_SIZE + 4], -360);
+    assert.equal(nativeWindow.getEventRingDropped(), 1);
+  });
+});
@@ -0,0 +1,164 @@
+/* global afterEach, beforeEach, assert, describe, it */
+const fs = require('fs');
+const http = require('http');
+const os = require('os');
+const path = require('path');
+const fetch = require('window-fetch');
+const {HttpCache} = require('../../src/HttpCache');
+const {XMLHttpRequest} = require('../../src/Network');
+
+describe('HttpCache', () => {
+  var server;
+  var baseUrl;
+  var dir;
+  var requests;
+  var revoked;
+
+  beforeEach(done => {
+    requests = [];
+    revoked = false;
+    server = http.createServer((req, res) => {
+      requests.push(req);
+      if (req.url === '/fresh') {
+        res.writeHead(200, {'Cache-Control': 'max-age=60'});
+        res.end('fresh');
+      } else if (req.url === '/aged') {
+        res.writeHead(200, {'Cache-Control': 'max-age=60', 'Age': '60'});
+        res.end('aged');
+      } else if (req.url === '/etag') {
+        if (req.headers['if-none-match'] === '"v1"') {
+          res.writeHead(304);
+          res.end();
+        } else {
+          res.writeHead(200, {'Cache-Control': 'no-cache', 'ETag': '"v1"'});
+          res.end('etag');
+        }
+      } else if (req.url === '/revoked' && !revoked) {
+        res.writeHead(200, {'Cache-Control': 'no-cache', 'ETag': '"v1"'});
+        res.end('revoked');
+      } else {
+        res.writeHead(200, {'Cache-Control': 'no-store'});
+        res.end('no-store');
+      }
+    }).listen(0, () => {
+      baseUrl = `http://127.0.0.1:${server.address().port}`;
+      done();
+    });
+    dir = fs.mkdtempSync(path.join(os.tmpdir(), 'exokit-http-cache-'));
+  });
+
+  afterEach(done => {
+    server.close(done);
+  });
+
+  it('serves fresh responses from disk across instances', () => {
+    const cache = new HttpCache(dir);
+    return cache.fetch(baseUrl + '/fresh', {}, fetch)
+      .then(res => res.text())
+      .then(text => {
+        assert.equal(text, 'fresh');
+        // entries are only published once their body file is in place
+        const entry = cache.entries.get(baseUrl + '/fresh');
+        assert.ok(fs.existsSync(path.join(dir, entry.hash)));
+        cache._saveSync();
+        return new HttpCache(dir).fetch(baseUrl + '/fresh', {}, fetch);
+      })
+      .then(res => res.text())
+      .then(text => {
+        assert.equal(text, 'fresh');
+        assert.equal(requests.length, 1);
+      });
+  });
+
+  it('revalidates with etags and skips no-store responses', () => {
+    const cache = new HttpCache(dir);
+    return cache.fetch(baseUrl + '/etag', {}, fetch)
+      .then(res => res.text())
+      .then(() => cache.fetch(baseUrl + '/etag', {}, fetch))
+      .then(res => res.text())
+      .then(text => {
+        assert.equal(text, 'etag');
+        assert.equal(requests[1].headers['if-none-match'], '"v1"');
+        return cache.fetch(baseUrl + '/nostore', {}, fetch);
+      })
+      .then(() => {
+        assert.ok(!cache.entries.has(baseUrl + '/nostore'));
+      });
+  });
+
+  it('counts the Age header against freshness', () => {
+    const cache = new HttpCache(dir);
+    return cache.fetch(baseUrl + '/aged', {}, fetch)
+      .then(res => res.text())
+      .then(() => cache.fetch(baseUrl + '/aged', {}, fetch))
+      .then(res => res.text())
+      .then(text => {
+        assert.equal(text, 'aged');
+        assert.equal(requests.length, 2);
+      });
+  });
+
+  it('streams uncacheable responses to XHR', () => {
+    const cache = new HttpCache(dir);
+    return cache.request(baseUrl + '/nostore', {}, fetch)
+      .then(({status, body}) => {
+        assert.equal(status, 200);
+        assert.equal(typeof body.pipe, 'function');
+        return new Promise((accept, reject) => {
+          const bufs = [];
+          body.on('data', d => {
+            bufs.push(d);
+          });
+          body.on('end', () => {
+            accept(Buffer.concat(bufs).toString());
+          });
+          body.on('error', reject);
+        });
+      })
+      .then(text => {
+        assert.equal(text, 'no-store');
+      });
+  });
+
+  it('drops entries whose revalidated response is no longer storable', () => {
+    const cache = new HttpCache(dir);
+    return cache.fetch(baseUrl + '/revoked', {}, fetch)
+      .then(res => res.text())
+      .then(() => {
+        assert.ok(cache.entries.has(baseUrl + '/revoked'));
+        revoked = true;
+        return cache.fetch(baseUrl + '/revoked', {}, fetch);
+      })
+      .then(res => res.text())
+      .then(text => {
+        assert.equal(text, 'no-store');
+        assert.ok(!cache.entries.has(baseUrl + '/revoked'));
+        assert.equal(cache.size, 0);
+      });
+  });
+
+  it('reports XHR network failures as errors rather than responses', done => {
+    const cache = new HttpCache(dir);
+    const xhr = new XMLHttpRequest();
+    xhr._httpCache = cache;
+    xhr.onload = () => {
+      done(new Error('unexpected load with status ' + xhr.status));
+    };
+    xhr.onerror = () => {
+      done();
+    };
+    xhr.open('GET', 'http://127.0.0.1:1/');
+    xhr.send();
+  });
+
+  it('evicts least recently used bodies past the size cap', () => {
+    const cache = new HttpCache(dir, {maxSize: 6});
+    return cache.fetch(baseUrl + '/fresh', {}, fetch)
+      .then(() => cache.fetch(baseUrl + '/etag', {}, fetch))
+      .then(() => {
+        assert.ok(!cache.entries.has(baseUrl + '/fresh'));
+        assert.ok(cache.entries.has(baseUrl + '/etag'));
+        assert.ok(cache.size <= 6);
+      });
+  });
+});
@@ -0,0 +1,93 @@
+/* global afterEach, beforeEach, assert, it */
+const exokit = require('../../src/index');
+const {nativeMemory, nativeImage} = require('../../src/native-bindings');
+const helpers = require('./helpers');
+
+const _gc = () => {
+  if (global.gc) {
+    for (let i = 0; i < 4; i++) {
+      global.gc();
+    }
+  }
+};
+
+helpers.describeSkipCI('memory', () => {
+  var window;
+
+  beforeEach(() => {
+    window = exokit().window;
+  });
+
+  afterEach(() => {
+    window.destroy();
+  });
+
+  it('reports live native allocations per category', () => {
+    const before = nativeMemory.getMemoryStats();
+    const imageData = new window.ImageData(64, 32);
+    const after = nativeMemory.getMemoryStats();
+    assert.equal(after.imageData.bytes - before.imageData.bytes, 64 * 32 * 4);
+    assert.equal(after.imageData.count - before.imageData.count, 1);
+    assert.ok(after.total.bytes >= 64 * 32 * 4);
+    assert.equal(imageData.data.length, 64 * 32 * 4);
+  });
+
+  it('releases dropped canvases, images and image data', function() {
+    if (!global.gc) {
+      this.skip();
+    }
+    this.timeout(60000);
+
+    const source = window.document.createElement('canvas');
+    source.width = 256;
+    source.height = 256;
+    source.getContext('2d').fillRect(0, 0, 1, 1);
+    const png = Buffer.from(source.toDataURL().replace(/^data:image\/png;base64,/, ''), 'base64');
+
+    const _loadImage = () => new Promise((accept, reject) => {
+      const image = new nativeImage();
+      image.load(png, err => {
+        if (!err) {
+          accept(image);
+        } else {
+          reject(new Error(err));
+        }
+      });
+    });
+    const _churn = () => {
+      for (let i = 0; i < 1000; i++) {
+        const imageData = new window.ImageData(256, 256);
+        imageData.data[0] = 1;
+        const canvas = window.document.createElement('canvas');
+        canvas.width = 256;
+        canvas.height = 256;
+        canvas.getContext('2d').fillRect(0, 0, 1, 1);
+      }
+      let promise = Promise.resolve();
+      for (let i = 0; i < 10; i++) {
+        promise = promise.then(() => Promise.all(Array(10).fill(0).map(_loadImage)));
+      }
+      return promise.then(() => {
+        _gc();
+      });
+    };
+
+    let baseline, baselineRss;
+    let promise = _churn()
+      .then(() => {
+        baseline = nativeMemory.getMemoryStats();
+        baselineRss = process.memoryUsage().rss;
+      });
+    for (let i = 0; i < 5; i++) {
+      promise = promise.then(_churn);
+    }
+    return promise.then(() => {
+      const stats = nativeMemory.getMemoryStats();
+
+      assert.ok(stats.imageData.bytes <= baseline.imageData.bytes + 16 * 256 * 256 * 4);
+      assert.ok(stats.canvas.bytes <= baseline.canvas.bytes + 16 * 256 * 256 * 4);
+      assert.ok(stats.image.bytes <= baseline.image.bytes + 16 * 256 * 256 * 4);
+      assert.ok(process.memoryUsage().rss - baselineRss < 64 * 1024 * 1024);
+    });
+  });
+});
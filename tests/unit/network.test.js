@@ -0,0 +1,76 @@
+/* global afterEach, beforeEach, assert, describe, it */
+const exokit = require('../../src/index');
+const fs = require('fs');
+const path = require('path');
+
+const testPngPath = path.resolve(__dirname, './data/test.png');
+const testPng = fs.readFileSync(testPngPath);
+
+describe('Network', () => {
+  var window;
+
+  beforeEach(() => {
+    window = exokit().window;
+    window.navigator.getVRDisplaysSync = () => [];
+  });
+
+  afterEach(() => {
+    window.destroy();
+  });
+
+  it('loads file:// array buffers into one exact buffer', done => {
+    const xhr = new window.XMLHttpRequest();
+    xhr.open('GET', 'file://' + testPngPath);
+    xhr.responseType = 'arraybuffer';
+    let total = -1;
+    xhr.onprogress = e => {
+      total = e.total;
+    };
+    xhr.onload = () => {
+      assert.equal(xhr.status, 200);
+      assert.equal(xhr.response.byteLength, testPng.length);
+      assert.ok(Buffer.from(xhr.response).equals(testPng));
+      assert.equal(xhr.getResponseHeader('content-length'), testPng.length + '');
+      assert.ok(total === -1 || total === testPng.length);
+      done();
+    };
+    xhr.send();
+  });
+
+  it('keeps the content type of blob: responses', () => {
+    const url = window.URL.createObjectURL(new window.Blob(['{"a":1}'], {type: 'application/json'}));
+    return window.fetch(url)
+      .then(res => {
+        assert.equal(res.headers.get('content-type'), 'application/json');
+        return res.blob();
+      })
+      .then(blob => {
+        assert.equal(blob.type, 'application/json');
+      });
+  });
+
+  it('returns the stored blob buffer without copying', () => {
+    const url = window.URL.createObjectURL(new window.Blob([testPng]));
+    const blob = window.urls.get(url);
+    return Promise.all([
+      window.fetch(url).then(res => res.arrayBuffer()),
+      window.fetch(url).then(res => res.arrayBuffer()),
+    ])
+      .then(([a, b]) => {
+        assert.equal(a, b);
+        assert.ok(Buffer.from(a).equals(blob.buffer));
+      });
+  });
+
+  it('fetches file:// text and reports missing files', () => {
+    return window.fetch('file://' + path.resolve(__dirname, './data/dummy.html'))
+      .then(res => res.text())
+      .then(text => {
+        assert.ok(text.length > 0);
+        return window.fetch('file:///nonexistent/exokit-test-file');
+      })
+      .then(res => {
+        assert.equal(res.status, 404);
+      });
+  });
+});
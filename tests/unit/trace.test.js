@@ -0,0 +1,47 @@
+/* global afterEach, beforeEach, assert, it */
+const exokit = require('../../src/index');
+const {nativeTrace} = require('../../src/native-bindings');
+const helpers = require('./helpers');
+
+helpers.describeSkipCI('trace', () => {
+  var gl;
+  var window;
+
+  beforeEach(() => {
+    window = exokit().window;
+    gl = window.WebGLRenderingContext(window.document.createElement('canvas'));
+  });
+
+  afterEach(() => {
+    nativeTrace.stop();
+    window.destroy();
+  });
+
+  it('records native and JS spans as trace_event JSON', () => {
+    nativeTrace.start();
+    const start = nativeTrace.now();
+    gl.clear(gl.COLOR_BUFFER_BIT);
+    nativeTrace.addSpan('test', 'span "quoted"', start, nativeTrace.now());
+    nativeTrace.stop();
+    gl.clear(gl.COLOR_BUFFER_BIT);
+
+    const {traceEvents} = JSON.parse(nativeTrace.dump(1));
+    const glEvents = traceEvents.filter(e => e.cat === 'gl');
+    assert.equal(glEvents.length, 1);
+    assert.equal(glEvents[0].name, 'Clear');
+    assert.equal(glEvents[0].ph, 'X');
+    const span = traceEvents.find(e => e.cat === 'test');
+    assert.equal(span.name, 'span "quoted"');
+    assert.ok(span.ts >= start && span.dur >= 0);
+  });
+
+  it('clears events when a new trace starts', () => {
+    nativeTrace.start();
+    gl.clear(gl.COLOR_BUFFER_BIT);
+    nativeTrace.start();
+    nativeTrace.stop();
+
+    const {traceEvents} = JSON.parse(nativeTrace.dump(1));
+    assert.equal(traceEvents.filter(e => e.cat === 'gl').length, 0);
+  });
+});
@@ -0,0 +1,42 @@
+/* global afterEach, beforeEach, assert, it */
+const exokit = require('../../src/index');
+const helpers = require('./helpers');
+
+helpers.describeSkipCI('VideoDevice', () => {
+  var window;
+  var dev;
+
+  beforeEach(() => {
+    const o = exokit();
+    window = o.window;
+    window.navigator.getVRDisplaysSync = () => [];
+
+    return window.navigator.mediaDevices.getUserMedia({video: {}})
+      .then(newDev => {
+        dev = newDev;
+      });
+  });
+
+  afterEach(() => {
+    dev.close();
+    window.destroy();
+  });
+
+  it('captures frames from a lavfi stand-in device', done => {
+    assert.ok(dev.open('testsrc=size=64x48:rate=30', 'f=lavfi'));
+    assert.equal(dev.width, 64);
+    assert.equal(dev.height, 48);
+
+    setTimeout(() => {
+      const data = dev.data;
+      assert.ok(data);
+      assert.equal(data.length, 64 * 48 * 4);
+      assert.ok(data.some(v => v !== 0));
+      done();
+    }, 500);
+  });
+
+  it('fails to open an unknown input format', () => {
+    assert.notOk(dev.open('testsrc', 'f=notaformat'));
+  });
+});
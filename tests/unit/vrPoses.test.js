@@ -0,0 +1,55 @@
+/* global beforeEach, assert, it */
+const {nativeVr} = require('../../src/native-bindings');
+const helpers = require('./helpers');
+
+helpers.describeSkipCI('VR pose buffers', () => {
+  var compositor;
+  var hmd;
+  var left;
+  var right;
+
+  beforeEach(function() {
+    if (!nativeVr) {
+      this.skip();
+    }
+    compositor = nativeVr.getContext().compositor.NewMockCompositor();
+    hmd = new Float32Array(16);
+    left = new Float32Array(16);
+    right = new Float32Array(16);
+  });
+
+  it('writes mock poses into registered buffers', () => {
+    compositor.SetPoseBuffers(null, hmd, left, right);
+    compositor.WaitGetPoses();
+
+    // frame 0: identity rotation at standing height
+    assert.deepEqual(Array.from(hmd), [1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, Math.fround(1.6), 0, 1]);
+    assert.equal(left[12], Math.fround(-0.2));
+    assert.equal(right[12], Math.fround(0.2));
+
+    compositor.WaitGetPoses();
+    assert.notEqual(hmd[0], 1);
+  });
+
+  it('is deterministic across compositors', () => {
+    const other = nativeVr.getContext().compositor.NewMockCompositor();
+    const otherHmd = new Float32Array(16);
+    compositor.SetPoseBuffers(null, hmd, left, right);
+    other.SetPoseBuffers(null, otherHmd, new Float32Array(16), new Float32Array(16));
+    for (let i = 0; i < 10; i++) {
+      compositor.WaitGetPoses();
+      other.WaitGetPoses();
+    }
+    assert.deepEqual(Array.from(hmd), Array.from(otherHmd));
+  });
+
+  it('supports the per-call buffer form', () => {
+    compositor.WaitGetPoses(null, hmd, left, right);
+    assert.equal(hmd[15], 1);
+  });
+
+  it('rejects short buffers', () => {
+    assert.throws(() => compositor.SetPoseBuffers(null, new Float32Array(4), left, right));
+    assert.throws(() => compositor.WaitGetPoses());
+  });
+});
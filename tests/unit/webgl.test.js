@@ -16,6 +16,42 @@ helpers.describeSkipCI('webgl', () => {
     window.destroy();
   });
 
+  const solidFragmentSource = `#version 300 es
+precision mediump float;
+out vec4 fragColor;
+void main() {
+  fragColor = vec4(1.0);
+}`;
+  const _compileShader = (type, source) => {
+    const shader = gl.createShader(type);
+    gl.shaderSource(shader, source);
+    gl.compileShader(shader);
+    return shader;
+  };
+  const _createProgram = (vertexSource, fragmentSource = solidFragmentSource) => {
+    const program = gl.createProgram();
+    gl.attachShader(program, _compileShader(gl.VERTEX_SHADER, vertexSource));
+    gl.attachShader(program, _compileShader(gl.FRAGMENT_SHADER, fragmentSource));
+    gl.linkProgram(program);
+    return program;
+  };
+  const _createFramebuffer = (width, height, samples = 0, depthStencil = false) => {
+    const fbo = gl.createFramebuffer();
+    gl.bindFramebuffer(gl.FRAMEBUFFER, fbo);
+    const color = gl.createRenderbuffer();
+    gl.bindRenderbuffer(gl.RENDERBUFFER, color);
+    gl.renderbufferStorageMultisample(gl.RENDERBUFFER, samples, gl.RGBA8, width, height);
+    gl.framebufferRenderbuffer(gl.FRAMEBUFFER, gl.COLOR_ATTACHMENT0, gl.RENDERBUFFER, color);
+    if (depthStencil) {
+      const depth = gl.createRenderbuffer();
+      gl.bindRenderbuffer(gl.RENDERBUFFER, depth);
+      gl.renderbufferStorageMultisample(gl.RENDERBUFFER, samples, gl.DEPTH24_STENCIL8, width, height);
+      gl.framebufferRenderbuffer(gl.FRAMEBUFFER, gl.DEPTH_STENCIL_ATTACHMENT, gl.RENDERBUFFER, depth);
+    }
+    assert.equal(gl.checkFramebufferStatus(gl.FRAMEBUFFER), gl.FRAMEBUFFER_COMPLETE);
+    return {fbo, color};
+  };
+
   describe('getExtension', () => {
     it('returns EXT_blend_minmax', () => {
       ext = gl.getExtension('EXT_blend_minmax');
@@ -47,5 +83,508 @@ helpers.describeSkipCI('webgl', () => {
       assert.ok(ext.isVertexArrayOES(vao));
       ext.deleteVertexArrayOES(vao);
     });
+
+    it('caches extension objects and lists only what getExtension returns', () => {
+      const supportedExtensions = gl.getSupportedExtensions();
+      assert.notEqual(gl.getSupportedExtensions(), supportedExtensions);
+      assert.deepEqual(gl.getSupportedExtensions(), supportedExtensions);
+      assert.ok(supportedExtensions.includes('WEBGL_draw_buffers'));
+      supportedExtensions.forEach(name => {
+        const ext = gl.getExtension(name);
+        assert.ok(ext, name);
+        assert.equal(gl.getExtension(name), ext);
+      });
+      assert.equal(gl.getExtension('WEBGL_nonexistent'), null);
+    });
+  });
+
+  describe('timer queries', () => {
+    it('resolves TIME_ELAPSED_EXT without blocking', done => {
+      ext = gl.getExtension('EXT_disjoint_timer_query_webgl2');
+      const query = gl.createQuery();
+      gl.beginQuery(ext.TIME_ELAPSED_EXT, query);
+      gl.clear(gl.COLOR_BUFFER_BIT);
+      gl.endQuery(ext.TIME_ELAPSED_EXT);
+      assert.ok(gl.isQuery(query));
+
+      const _poll = () => {
+        if (gl.getQueryParameter(query, gl.QUERY_RESULT_AVAILABLE)) {
+          assert.ok(gl.getQueryParameter(query, gl.QUERY_RESULT) >= 0);
+          assert.equal(gl.getParameter(ext.GPU_DISJOINT_EXT), false);
+          gl.deleteQuery(query);
+          done();
+        } else {
+          setTimeout(_poll, 10);
+        }
+      };
+      _poll();
+    });
+
+    it('reports per-phase gpu times', () => {
+      assert.equal(gl.getGpuTimes(), null);
+      assert.ok(gl.setGpuTimersEnabled(true));
+      gl.beginGpuTimer(gl.GPU_TIMER_DRAW);
+      gl.clear(gl.COLOR_BUFFER_BIT);
+      gl.endGpuTimer(gl.GPU_TIMER_DRAW);
+      gl.finish();
+
+      const gpuTimes = gl.getGpuTimes();
+      assert.ok(gpuTimes.draw === null || gpuTimes.draw >= 0);
+      assert.equal(gpuTimes.compose, null);
+      assert.equal(gpuTimes.dropped, 0);
+      gl.setGpuTimersEnabled(false);
+    });
+
+    it('leaves TIME_ELAPSED free for content while profiling', () => {
+      const ext = gl.getExtension('EXT_disjoint_timer_query_webgl2');
+      assert.ok(gl.setGpuTimersEnabled(true));
+      gl.beginGpuTimer(gl.GPU_TIMER_DRAW);
+      const query = gl.createQuery();
+      gl.beginQuery(ext.TIME_ELAPSED_EXT, query);
+      gl.clear(gl.COLOR_BUFFER_BIT);
+      gl.endQuery(ext.TIME_ELAPSED_EXT);
+      gl.endGpuTimer(gl.GPU_TIMER_DRAW);
+      assert.equal(gl.getError(), gl.NO_ERROR);
+      gl.finish();
+
+      assert.equal(gl.getGpuTimes().dropped, 0);
+      gl.deleteQuery(query);
+      gl.setGpuTimersEnabled(false);
+    });
+  });
+
+  describe('3D and array textures', () => {
+    it('uploads and reads back TEXTURE_2D_ARRAY layers', () => {
+      const texture = gl.createTexture();
+      gl.bindTexture(gl.TEXTURE_2D_ARRAY, texture);
+      gl.texStorage3D(gl.TEXTURE_2D_ARRAY, 1, gl.RGBA8, 2, 2, 3);
+      const layer = new Uint8Array(2 * 2 * 4);
+      for (let i = 0; i < layer.length; i += 4) {
+        layer.set([255, 128, 0, 255], i);
+      }
+      gl.texSubImage3D(gl.TEXTURE_2D_ARRAY, 0, 0, 0, 1, 2, 2, 1, gl.RGBA, gl.UNSIGNED_BYTE, layer);
+      assert.equal(gl.getError(), gl.NO_ERROR);
+      assert.equal(gl.getParameter(gl.TEXTURE_BINDING_2D_ARRAY).id, texture.id);
+
+      const fbo = gl.createFramebuffer();
+      gl.bindFramebuffer(gl.FRAMEBUFFER, fbo);
+      gl.framebufferTextureLayer(gl.FRAMEBUFFER, gl.COLOR_ATTACHMENT0, texture, 0, 1);
+      assert.equal(gl.checkFramebufferStatus(gl.FRAMEBUFFER), gl.FRAMEBUFFER_COMPLETE);
+      const pixels = new Uint8Array(4);
+      gl.readPixels(1, 1, 1, 1, gl.RGBA, gl.UNSIGNED_BYTE, pixels);
+      assert.deepEqual(Array.from(pixels), [255, 128, 0, 255]);
+
+      gl.bindFramebuffer(gl.FRAMEBUFFER, null);
+      gl.deleteFramebuffer(fbo);
+      gl.deleteTexture(texture);
+    });
+
+    it('accepts texImage3D with a srcOffset', () => {
+      const texture = gl.createTexture();
+      gl.bindTexture(gl.TEXTURE_3D, texture);
+      const data = new Uint8Array(4 + 4 * 4 * 4 * 4);
+      gl.texImage3D(gl.TEXTURE_3D, 0, gl.RGBA8, 4, 4, 4, 0, gl.RGBA, gl.UNSIGNED_BYTE, data, 4);
+      gl.texImage3D(gl.TEXTURE_3D, 1, gl.RGBA8, 2, 2, 2, 0, gl.RGBA, gl.UNSIGNED_BYTE, null);
+      assert.equal(gl.getError(), gl.NO_ERROR);
+      assert.ok(gl.getParameter(gl.MAX_3D_TEXTURE_SIZE) >= 256);
+      assert.throws(() => gl.texImage3D(gl.TEXTURE_3D, 0, gl.RGBA8, 1, 1, 1, 0, gl.RGBA, gl.UNSIGNED_BYTE, 'nope'));
+      gl.deleteTexture(texture);
+    });
+
+    it('rejects array buffer views shorter than the upload', () => {
+      const texture = gl.createTexture();
+      gl.bindTexture(gl.TEXTURE_3D, texture);
+      assert.throws(() => gl.texImage3D(gl.TEXTURE_3D, 0, gl.RGBA8, 2, 2, 3, 0, gl.RGBA, gl.UNSIGNED_BYTE, new Uint8Array(4)));
+      assert.throws(() => gl.texImage3D(gl.TEXTURE_3D, 0, gl.RGBA8, 2, 2, 3, 0, gl.RGBA, gl.UNSIGNED_BYTE, new Uint8Array(2 * 2 * 3 * 4), 1));
+      gl.texImage3D(gl.TEXTURE_3D, 0, gl.RGBA8, 2, 2, 3, 0, gl.RGBA, gl.UNSIGNED_BYTE, new Uint8Array(2 * 2 * 3 * 4));
+      assert.throws(() => gl.texSubImage3D(gl.TEXTURE_3D, 0, 0, 0, 0, 2, 2, 3, gl.RGBA, gl.UNSIGNED_BYTE, new Uint8Array(2 * 2 * 2 * 4)));
+
+      gl.pixelStorei(gl.UNPACK_ROW_LENGTH, 4);
+      assert.throws(() => gl.texSubImage3D(gl.TEXTURE_3D, 0, 0, 0, 0, 2, 2, 3, gl.RGBA, gl.UNSIGNED_BYTE, new Uint8Array(2 * 2 * 3 * 4)));
+      gl.texSubImage3D(gl.TEXTURE_3D, 0, 0, 0, 0, 2, 2, 3, gl.RGBA, gl.UNSIGNED_BYTE, new Uint8Array(4 * 2 * 3 * 4));
+      gl.pixelStorei(gl.UNPACK_ROW_LENGTH, 0);
+      assert.equal(gl.getError(), gl.NO_ERROR);
+      gl.deleteTexture(texture);
+    });
+
+    it('requires image sources to hold exactly width x (height * depth) pixels', () => {
+      const texture = gl.createTexture();
+      gl.bindTexture(gl.TEXTURE_2D_ARRAY, texture);
+      gl.texImage3D(gl.TEXTURE_2D_ARRAY, 0, gl.RGBA8, 2, 2, 3, 0, gl.RGBA, gl.UNSIGNED_BYTE, new window.ImageData(2, 6));
+      assert.equal(gl.getError(), gl.NO_ERROR);
+      assert.throws(() => gl.texImage3D(gl.TEXTURE_2D_ARRAY, 0, gl.RGBA8, 2, 2, 3, 0, gl.RGBA, gl.UNSIGNED_BYTE, new window.ImageData(2, 2)));
+      assert.throws(() => gl.texSubImage3D(gl.TEXTURE_2D_ARRAY, 0, 0, 0, 0, 2, 2, 3, gl.RGBA, gl.UNSIGNED_BYTE, new window.ImageData(4, 3)));
+      gl.deleteTexture(texture);
+    });
+  });
+
+  describe('samplers', () => {
+    it('tracks sampler bindings and parameters', () => {
+      const sampler = gl.createSampler();
+      assert.ok(gl.isSampler(sampler));
+      gl.samplerParameteri(sampler, gl.TEXTURE_MIN_FILTER, gl.NEAREST);
+      gl.samplerParameterf(sampler, gl.TEXTURE_MAX_LOD, 4);
+      assert.equal(gl.getSamplerParameter(sampler, gl.TEXTURE_MIN_FILTER), gl.NEAREST);
+      assert.equal(gl.getSamplerParameter(sampler, gl.TEXTURE_MAX_LOD), 4);
+
+      gl.bindSampler(0, sampler);
+      assert.equal(gl.getParameter(gl.SAMPLER_BINDING).id, sampler.id);
+      gl.deleteSampler(sampler);
+      assert.equal(gl.getParameter(gl.SAMPLER_BINDING), null);
+      assert.equal(gl.getError(), gl.NO_ERROR);
+    });
+  });
+
+  describe('occlusion queries', () => {
+    const _drawQuad = (zLocation, z) => {
+      gl.uniform1f(zLocation, z);
+      gl.drawArrays(gl.TRIANGLE_STRIP, 0, 4);
+    };
+
+    it('reports occluded geometry on a later tick', done => {
+      const program = _createProgram(`#version 300 es
+in vec2 position;
+uniform float z;
+void main() {
+  gl_Position = vec4(position, z, 1.0);
+}`);
+      gl.useProgram(program);
+      const zLocation = gl.getUniformLocation(program, 'z');
+
+      gl.bindVertexArray(gl.createVertexArray());
+      gl.bindBuffer(gl.ARRAY_BUFFER, gl.createBuffer());
+      gl.bufferData(gl.ARRAY_BUFFER, new Float32Array([-1, -1, 1, -1, -1, 1, 1, 1]), gl.STATIC_DRAW);
+      const positionLocation = gl.getAttribLocation(program, 'position');
+      gl.enableVertexAttribArray(positionLocation);
+      gl.vertexAttribPointer(positionLocation, 2, gl.FLOAT, false, 0, 0);
+
+      _createFramebuffer(16, 16, 0, true);
+      gl.viewport(0, 0, 16, 16);
+      gl.enable(gl.DEPTH_TEST);
+      gl.depthFunc(gl.LESS);
+      gl.clear(gl.COLOR_BUFFER_BIT | gl.DEPTH_BUFFER_BIT);
+
+      _drawQuad(zLocation, 0);
+      const occludedQuery = gl.createQuery();
+      gl.beginQuery(gl.ANY_SAMPLES_PASSED, occludedQuery);
+      _drawQuad(zLocation, 0.5);
+      gl.endQuery(gl.ANY_SAMPLES_PASSED);
+      const visibleQuery = gl.createQuery();
+      gl.beginQuery(gl.ANY_SAMPLES_PASSED_CONSERVATIVE, visibleQuery);
+      _drawQuad(zLocation, -0.5);
+      gl.endQuery(gl.ANY_SAMPLES_PASSED_CONSERVATIVE);
+      gl.finish();
+
+      assert.equal(gl.getQueryParameter(occludedQuery, gl.QUERY_RESULT_AVAILABLE), false);
+      assert.equal(gl.getQueryParameter(occludedQuery, gl.QUERY_RESULT), null);
+
+      const _poll = () => {
+        if (gl.getQueryParameter(occludedQuery, gl.QUERY_RESULT_AVAILABLE) && gl.getQueryParameter(visibleQuery, gl.QUERY_RESULT_AVAILABLE)) {
+          assert.equal(gl.getQueryParameter(occludedQuery, gl.QUERY_RESULT), 0);
+          assert.equal(gl.getQueryParameter(visibleQuery, gl.QUERY_RESULT), 1);
+          gl.bindFramebuffer(gl.FRAMEBUFFER, null);
+          done();
+        } else {
+          setTimeout(_poll, 10);
+        }
+      };
+      setImmediate(_poll);
+    });
+
+    it('keeps queries ended by a sibling immediate pending through that check phase', done => {
+      const firstQuery = gl.createQuery();
+      const secondQuery = gl.createQuery();
+      setImmediate(() => {
+        gl.beginQuery(gl.ANY_SAMPLES_PASSED, secondQuery);
+        gl.endQuery(gl.ANY_SAMPLES_PASSED);
+        gl.finish();
+      });
+      gl.beginQuery(gl.ANY_SAMPLES_PASSED, firstQuery);
+      gl.endQuery(gl.ANY_SAMPLES_PASSED);
+      setImmediate(() => {
+        assert.equal(gl.getQueryParameter(secondQuery, gl.QUERY_RESULT_AVAILABLE), false);
+        gl.deleteQuery(firstQuery);
+        gl.deleteQuery(secondQuery);
+        done();
+      });
+    });
+  });
+
+  describe('transform feedback', () => {
+    it('integrates particle positions on the GPU', () => {
+      const numParticles = 4;
+      const dt = 0.5;
+      const positions = new Float32Array(numParticles * 4);
+      const velocities = new Float32Array(numParticles * 4);
+      for (let i = 0; i < numParticles; i++) {
+        positions.set([i, i * 2, -i, 1], i * 4);
+        velocities.set([1, -2, 0.5, 0], i * 4);
+      }
+
+      const program = gl.createProgram();
+      gl.attachShader(program, _compileShader(gl.VERTEX_SHADER, `#version 300 es
+in vec4 position;
+in vec4 velocity;
+uniform float dt;
+out vec4 outPosition;
+void main() {
+  outPosition = position + velocity * dt;
+  gl_Position = outPosition;
+}`));
+      gl.attachShader(program, _compileShader(gl.FRAGMENT_SHADER, solidFragmentSource));
+      gl.transformFeedbackVaryings(program, ['outPosition'], gl.INTERLEAVED_ATTRIBS);
+      gl.linkProgram(program);
+      assert.ok(gl.getProgramParameter(program, gl.LINK_STATUS));
+      assert.equal(gl.getProgramParameter(program, gl.TRANSFORM_FEEDBACK_VARYINGS), 1);
+      assert.equal(gl.getTransformFeedbackVarying(program, 0).name, 'outPosition');
+      gl.useProgram(program);
+      gl.uniform1f(gl.getUniformLocation(program, 'dt'), dt);
+
+      gl.bindVertexArray(gl.createVertexArray());
+      const _attrib = (name, data) => {
+        const buffer = gl.createBuffer();
+        gl.bindBuffer(gl.ARRAY_BUFFER, buffer);
+        gl.bufferData(gl.ARRAY_BUFFER, data, gl.STATIC_DRAW);
+        const location = gl.getAttribLocation(program, name);
+        gl.enableVertexAttribArray(location);
+        gl.vertexAttribPointer(location, 4, gl.FLOAT, false, 0, 0);
+      };
+      _attrib('position', positions);
+      _attrib('velocity', velocities);
+
+      const outBuffer = gl.createBuffer();
+      gl.bindBuffer(gl.TRANSFORM_FEEDBACK_BUFFER, outBuffer);
+      gl.bufferData(gl.TRANSFORM_FEEDBACK_BUFFER, positions.byteLength, gl.STREAM_COPY);
+      const transformFeedback = gl.createTransformFeedback();
+      gl.bindTransformFeedback(gl.TRANSFORM_FEEDBACK, transformFeedback);
+      gl.bindBufferBase(gl.TRANSFORM_FEEDBACK_BUFFER, 0, outBuffer);
+      assert.equal(gl.getParameter(gl.TRANSFORM_FEEDBACK_BINDING).id, transformFeedback.id);
+
+      gl.enable(gl.RASTERIZER_DISCARD);
+      gl.beginTransformFeedback(gl.POINTS);
+      assert.equal(gl.getParameter(gl.TRANSFORM_FEEDBACK_ACTIVE), true);
+      gl.drawArrays(gl.POINTS, 0, numParticles);
+      gl.endTransformFeedback();
+      gl.disable(gl.RASTERIZER_DISCARD);
+      gl.bindTransformFeedback(gl.TRANSFORM_FEEDBACK, null);
+      gl.bindBufferBase(gl.TRANSFORM_FEEDBACK_BUFFER, 0, null);
+      assert.equal(gl.getError(), gl.NO_ERROR);
+
+      // read the captured buffer back through a float texture
+      gl.bindBuffer(gl.PIXEL_UNPACK_BUFFER, outBuffer);
+      const texture = gl.createTexture();
+      gl.bindTexture(gl.TEXTURE_2D, texture);
+      gl.texImage2D(gl.TEXTURE_2D, 0, gl.RGBA32F, numParticles, 1, 0, gl.RGBA, gl.FLOAT, 0);
+      gl.bindBuffer(gl.PIXEL_UNPACK_BUFFER, null);
+      const fbo = gl.createFramebuffer();
+      gl.bindFramebuffer(gl.FRAMEBUFFER, fbo);
+      gl.framebufferTexture2D(gl.FRAMEBUFFER, gl.COLOR_ATTACHMENT0, gl.TEXTURE_2D, texture, 0);
+      const result = new Float32Array(numParticles * 4);
+      gl.readPixels(0, 0, numParticles, 1, gl.RGBA, gl.FLOAT, result);
+      gl.bindFramebuffer(gl.FRAMEBUFFER, null);
+
+      for (let i = 0; i < positions.length; i++) {
+        assert.closeTo(result[i], positions[i] + velocities[i] * dt, 1e-5);
+      }
+    });
+  });
+
+  describe('multisampled framebuffers', () => {
+    it('clears, resolves and invalidates an MSAA framebuffer', () => {
+      const msFramebuffer = _createFramebuffer(16, 16, 4, true);
+      assert.ok(gl.getRenderbufferParameter(gl.RENDERBUFFER, gl.RENDERBUFFER_SAMPLES) >= 4);
+      gl.clearBufferfv(gl.COLOR, 0, new Float32Array([1, 0.5, 0, 1]));
+      gl.clearBufferfi(gl.DEPTH_STENCIL, 0, 1, 0);
+
+      const resolveFramebuffer = _createFramebuffer(16, 16);
+      gl.bindFramebuffer(gl.READ_FRAMEBUFFER, msFramebuffer.fbo);
+      gl.bindFramebuffer(gl.DRAW_FRAMEBUFFER, resolveFramebuffer.fbo);
+      gl.blitFramebuffer(0, 0, 16, 16, 0, 0, 16, 16, gl.COLOR_BUFFER_BIT, gl.NEAREST);
+      gl.invalidateFramebuffer(gl.READ_FRAMEBUFFER, [gl.COLOR_ATTACHMENT0, gl.DEPTH_STENCIL_ATTACHMENT]);
+
+      gl.bindFramebuffer(gl.READ_FRAMEBUFFER, resolveFramebuffer.fbo);
+      gl.readBuffer(gl.COLOR_ATTACHMENT0);
+      assert.equal(gl.getParameter(gl.READ_BUFFER), gl.COLOR_ATTACHMENT0);
+      const pixels = new Uint8Array(4);
+      gl.readPixels(8, 8, 1, 1, gl.RGBA, gl.UNSIGNED_BYTE, pixels);
+      assert.equal(pixels[0], 255);
+      assert.closeTo(pixels[1], 128, 1);
+      assert.equal(pixels[2], 0);
+      assert.equal(pixels[3], 255);
+      assert.equal(gl.getError(), gl.NO_ERROR);
+
+      gl.bindFramebuffer(gl.FRAMEBUFFER, null);
+      gl.readBuffer(gl.BACK);
+      gl.invalidateFramebuffer(gl.FRAMEBUFFER, [gl.DEPTH, gl.STENCIL]);
+      assert.equal(gl.getError(), gl.NO_ERROR);
+    });
+  });
+
+  describe('buffer readback', () => {
+    const _createBuffers = () => {
+      const src = gl.createBuffer();
+      gl.bindBuffer(gl.COPY_READ_BUFFER, src);
+      gl.bufferData(gl.COPY_READ_BUFFER, new Float32Array([1, 2, 3, 4, 5, 6, 7, 8]), gl.DYNAMIC_COPY);
+      const dst = gl.createBuffer();
+      gl.bindBuffer(gl.COPY_WRITE_BUFFER, dst);
+      gl.bufferData(gl.COPY_WRITE_BUFFER, 8 * 4, gl.DYNAMIC_READ);
+      return {src, dst};
+    };
+
+    it('copies and reads back buffer ranges', () => {
+      _createBuffers();
+      gl.copyBufferSubData(gl.COPY_READ_BUFFER, gl.COPY_WRITE_BUFFER, 4 * 4, 0, 4 * 4);
+
+      const result = new Float32Array([0, 0, 0, 0, 0, 0]);
+      gl.getBufferSubData(gl.COPY_WRITE_BUFFER, 4, result, 1, 3);
+      assert.deepEqual(Array.from(result), [0, 6, 7, 8, 0, 0]);
+      assert.equal(gl.getError(), gl.NO_ERROR);
+    });
+
+    it('resolves getBufferSubDataAsync with a snapshot on a later tick', () => {
+      const {src} = _createBuffers();
+      const result = new Float32Array(8);
+      let resolved = false;
+      const promise = gl.getBufferSubDataAsync(gl.COPY_READ_BUFFER, 0, result)
+        .then(data => {
+          resolved = true;
+          return data;
+        });
+      gl.bufferSubData(gl.COPY_READ_BUFFER, 0, new Float32Array(8));
+      assert.equal(resolved, false);
+      assert.deepEqual(gl.getParameter(gl.COPY_READ_BUFFER_BINDING), src);
+
+      return promise.then(data => {
+        assert.equal(data, result);
+        assert.deepEqual(Array.from(result), [1, 2, 3, 4, 5, 6, 7, 8]);
+        assert.equal(gl.getError(), gl.NO_ERROR);
+      });
+    });
+
+    it('orphans whole rewrites and streams partial updates of dynamic buffers', () => {
+      const buffer = gl.createBuffer();
+      gl.bindBuffer(gl.ARRAY_BUFFER, buffer);
+      gl.bufferData(gl.ARRAY_BUFFER, new Float32Array(8), gl.DYNAMIC_DRAW);
+      gl.getBufferUploadStats();
+
+      gl.bufferSubData(gl.ARRAY_BUFFER, 0, new Float32Array([1, 2, 3, 4, 5, 6, 7, 8]));
+      gl.bufferSubData(gl.ARRAY_BUFFER, 2 * 4, new Float32Array([30, 40]));
+      gl.bufferSubData(gl.ARRAY_BUFFER, 6 * 4, new Float32Array([0, 70, 80]), 1);
+      const stats = gl.getBufferUploadStats();
+      assert.equal(stats.orphans, 1);
+      assert.equal(stats.streamed + stats.direct, 2);
+
+      const result = new Float32Array(8);
+      gl.getBufferSubData(gl.ARRAY_BUFFER, 0, result);
+      assert.deepEqual(Array.from(result), [1, 2, 30, 40, 5, 6, 70, 80]);
+      assert.equal(gl.getError(), gl.NO_ERROR);
+    });
+
+    it('keeps element array buffers whole across vertex array switches', () => {
+      const vaoA = gl.createVertexArray();
+      gl.bindVertexArray(vaoA);
+      gl.bindBuffer(gl.ELEMENT_ARRAY_BUFFER, gl.createBuffer());
+      gl.bufferData(gl.ELEMENT_ARRAY_BUFFER, 4000, gl.DYNAMIC_DRAW);
+      const vaoB = gl.createVertexArray();
+      gl.bindVertexArray(vaoB);
+      gl.bindBuffer(gl.ELEMENT_ARRAY_BUFFER, gl.createBuffer());
+      gl.bufferData(gl.ELEMENT_ARRAY_BUFFER, 1000, gl.DYNAMIC_DRAW);
+      gl.getBufferUploadStats();
+
+      gl.bindVertexArray(vaoA);
+      gl.bufferSubData(gl.ELEMENT_ARRAY_BUFFER, 0, new Uint8Array(1000));
+      assert.equal(gl.getBufferUploadStats().orphans, 0);
+      assert.equal(gl.getBufferParameter(gl.ELEMENT_ARRAY_BUFFER, gl.BUFFER_SIZE), 4000);
+      assert.equal(gl.getError(), gl.NO_ERROR);
+    });
+  });
+
+  describe('uniform locations', () => {
+    it('returns stable locations until the program is relinked', () => {
+      const program = gl.createProgram();
+      gl.attachShader(program, _compileShader(gl.VERTEX_SHADER, `#version 300 es
+uniform vec2 offsets[3];
+void main() {
+  gl_Position = vec4(offsets[0] + offsets[1] + offsets[2], 0.0, 1.0);
+}`));
+      const fragmentShader = _compileShader(gl.FRAGMENT_SHADER, `#version 300 es
+precision mediump float;
+uniform vec4 color;
+out vec4 fragColor;
+void main() {
+  fragColor = color;
+}`);
+      gl.attachShader(program, fragmentShader);
+      gl.linkProgram(program);
+
+      const color = gl.getUniformLocation(program, 'color');
+      assert.ok(color);
+      assert.equal(gl.getUniformLocation(program, 'color'), color);
+      assert.equal(gl.getUniformLocation(program, 'offsets'), gl.getUniformLocation(program, 'offsets[0]'));
+      assert.ok(gl.getUniformLocation(program, 'offsets[2]'));
+      assert.equal(gl.getUniformLocation(program, 'offsets[3]'), null);
+      assert.equal(gl.getUniformLocation(program, 'missing'), null);
+
+      gl.useProgram(program);
+      gl.uniform4f(color, 1, 0.5, 0.25, 1);
+
+      gl.detachShader(program, fragmentShader);
+      gl.attachShader(program, _compileShader(gl.FRAGMENT_SHADER, `#version 300 es
+precision mediump float;
+uniform float opacity;
+uniform vec4 color;
+out vec4 fragColor;
+void main() {
+  fragColor = vec4(color.rgb, opacity);
+}`));
+      gl.linkProgram(program);
+      assert.notEqual(gl.getUniformLocation(program, 'color'), color);
+      assert.ok(gl.getUniformLocation(program, 'opacity'));
+      assert.equal(gl.getError(), gl.NO_ERROR);
+    });
+  });
+
+  describe('WEBGL_multi_draw', () => {
+    it('submits a batch of draws in one call', () => {
+      ext = gl.getExtension('WEBGL_multi_draw');
+      const program = _createProgram(`#version 300 es
+in vec2 position;
+void main() {
+  gl_Position = vec4(position, 0.0, 1.0);
+}`);
+      gl.useProgram(program);
+
+      _createFramebuffer(4, 1);
+      gl.viewport(0, 0, 4, 1);
+      gl.clearColor(0, 0, 0, 0);
+      gl.clear(gl.COLOR_BUFFER_BIT);
+
+      // one quad strip per quarter of the framebuffer; draw the first and third
+      const positions = [];
+      for (let i = 0; i < 4; i++) {
+        const x0 = i / 2 - 1;
+        const x1 = (i + 1) / 2 - 1;
+        positions.push(x0, -1, x1, -1, x0, 1, x1, 1);
+      }
+      const vao = gl.createVertexArray();
+      gl.bindVertexArray(vao);
+      const buffer = gl.createBuffer();
+      gl.bindBuffer(gl.ARRAY_BUFFER, buffer);
+      gl.bufferData(gl.ARRAY_BUFFER, new Float32Array(positions), gl.STATIC_DRAW);
+      const positionLocation = gl.getAttribLocation(program, 'position');
+      gl.enableVertexAttribArray(positionLocation);
+      gl.vertexAttribPointer(positionLocation, 2, gl.FLOAT, false, 0, 0);
+
+      ext.multiDrawArraysWEBGL(gl.TRIANGLE_STRIP, new Int32Array([-1, 0, 8]), 1, [4, 4], 0, 2);
+
+      const pixels = new Uint8Array(4 * 4);
+      gl.readPixels(0, 0, 4, 1, gl.RGBA, gl.UNSIGNED_BYTE, pixels);
+      assert.deepEqual(Array.from(pixels).filter((v, i) => i % 4 === 0), [255, 0, 255, 0]);
+      assert.throws(() => ext.multiDrawArraysWEBGL(gl.TRIANGLE_STRIP, new Int32Array(1), 0, new Int32Array(1), 0, 2));
+      assert.throws(() => ext.multiDrawArraysWEBGL(gl.TRIANGLE_STRIP, new Int32Array(4), -1, new Int32Array(4), 0, 1));
+      assert.throws(() => ext.multiDrawArraysWEBGL(gl.TRIANGLE_STRIP, new Int32Array(4), 5, new Int32Array(4), 0, 1));
+      assert.throws(() => ext.multiDrawArraysWEBGL(gl.TRIANGLE_STRIP, [0, 4], 0, [4, 4], -1, 1));
+      assert.equal(gl.getError(), gl.NO_ERROR);
+    });
   });
 });